@@ -0,0 +1,96 @@
+/*
+ * Allocation_Test.cpp
+ *
+ *  Heap allocations of record construction.
+ *  Built as an executable of its own, as it replaces the global operator new and delete.
+ */
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "RecordView.hpp"
+using namespace overlay_record;
+using namespace std;
+
+// Counts all heap allocations of this executable.
+// All forms of new and delete are replaced, so that they all match malloc() and free().
+static atomic<unsigned long>  numAllocations(0);
+
+static void*  countedMalloc(size_t size) noexcept {
+	++numAllocations;
+	return malloc(size != 0 ? size : 1);
+}
+
+void* operator new(size_t size) {
+	if (void* p = countedMalloc(size)) return p;
+	throw bad_alloc();
+}
+void* operator new[](size_t size) {
+	if (void* p = countedMalloc(size)) return p;
+	throw bad_alloc();
+}
+void* operator new(size_t size, const nothrow_t&) noexcept   { return countedMalloc(size); }
+void* operator new[](size_t size, const nothrow_t&) noexcept { return countedMalloc(size); }
+
+void  operator delete(void* p) noexcept                      { free(p); }
+void  operator delete[](void* p) noexcept                    { free(p); }
+void  operator delete(void* p, const nothrow_t&) noexcept    { free(p); }
+void  operator delete[](void* p, const nothrow_t&) noexcept  { free(p); }
+#ifdef __cpp_sized_deallocation
+void  operator delete(void* p, size_t) noexcept              { free(p); }
+void  operator delete[](void* p, size_t) noexcept            { free(p); }
+#endif
+
+
+struct Allocation_Test : public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE( Allocation_Test );
+		CPPUNIT_TEST( construction_should_not_allocate );
+		CPPUNIT_TEST( views_should_not_allocate );
+    CPPUNIT_TEST_SUITE_END();
+
+	struct E : public Record {
+		Text<4>				txt = {this};
+		TextInteger<4>		num = {this};
+	};
+
+	struct R : public Record {
+		Text<8>				txt  = {this};
+		TextInteger<5>		num  = {this};
+		Integer				val  = {this};
+		Array<Double, 3>	vec  = {this};
+		Embed<E>			e    = {this};
+		Blob<4>				blob = {this, txt};
+
+		R() = default;
+		R(char* buf, unsigned bufsiz) { assignStaticBuffer(buf, bufsiz); }
+	};
+
+    void construction_should_not_allocate() {
+    	char  buf[64];
+    	Record::layout<R>();
+    	unsigned long  before = numAllocations.load();
+    	{
+    		R  r(buf, sizeof(buf));
+    		r.val = 42;
+    		CPPUNIT_ASSERT_EQUAL(42, r.val.value());
+    	}
+		CPPUNIT_ASSERT_EQUAL(before, numAllocations.load());
+    }
+
+    void views_should_not_allocate() {
+    	char  buf[3 * 64] = {};
+    	RecordView<R>  view(buf, sizeof(buf));
+    	view[0].val = 1;
+    	unsigned long  before = numAllocations.load();
+    	int  sum = 0;
+    	for (const R& r : view) sum += r.val;
+    	view[1].e->num = view[0].val;
+		CPPUNIT_ASSERT_EQUAL(1, sum);
+		CPPUNIT_ASSERT_EQUAL(1, view.at(1).e->num.value());
+		CPPUNIT_ASSERT_EQUAL(before, numAllocations.load());
+    }
+
+};
+CPPUNIT_TEST_SUITE_REGISTRATION( Allocation_Test );
@@ -0,0 +1,113 @@
+/*
+ * Benchmark.hpp
+ *
+ *  Minimal micro-benchmark harness, in the style of Google Benchmark.
+ *  Each benchmark is a function of State, registered with BENCHMARK(fn),
+ *  and is run until it has taken at least the minimum time.
+ */
+
+#ifndef BENCHMARK_HPP_
+#define BENCHMARK_HPP_
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+    /**
+     * Controls the iterations of one benchmark run.
+     *
+     * <pre>
+     *   void BM_something(bench::State& state) {
+     *       while (state.keepRunning()) { ... }
+     *       state.setItemsProcessed(state.iterations() * N);
+     *   }
+     *   BENCHMARK(BM_something);
+     * </pre>
+     */
+    class State {
+        typedef std::chrono::steady_clock   Clock;
+
+        size_t              maxIterations;
+        size_t              count = 0;
+        size_t              items = 0;
+        size_t              bytes = 0;
+        Clock::time_point   start;
+        Clock::duration     elapsed = Clock::duration::zero();
+        bool                running = false;
+
+    public:
+        explicit State(size_t maxIterations) : maxIterations(maxIterations) {}
+
+        /**
+         * Returns true as long as there are iterations left.
+         * The clock starts on the first call and stops on the last.
+         */
+        bool keepRunning() {
+            if (!running) {
+                running = true;
+                start   = Clock::now();
+            }
+            if (count < maxIterations) {
+                ++count;
+                return true;
+            }
+            elapsed += Clock::now() - start;
+            running  = false;
+            return false;
+        }
+
+        /**
+         * Excludes setup work within the loop from the measured time.
+         */
+        void pauseTiming()  { elapsed += Clock::now() - start; }
+        void resumeTiming() { start = Clock::now(); }
+
+        size_t  iterations() const { return maxIterations; }
+        void    setItemsProcessed(size_t n) { items = n; }
+        void    setBytesProcessed(size_t n) { bytes = n; }
+
+        size_t  itemsProcessed() const { return items; }
+        size_t  bytesProcessed() const { return bytes; }
+        double  seconds() const { return std::chrono::duration<double>(elapsed).count(); }
+    };
+
+    typedef void (*Function)(State&);
+
+    struct Benchmark {
+        std::string     name;
+        Function        fn;
+    };
+
+    inline std::vector<Benchmark>&  registry() {
+        static std::vector<Benchmark>  benchmarks;
+        return benchmarks;
+    }
+
+    struct Registrar {
+        Registrar(const char* name, Function fn) {
+            registry().push_back({name, fn});
+        }
+    };
+
+    /**
+     * Prevents the compiler from optimizing away the computation of value.
+     */
+    template<typename T>
+    inline void doNotOptimize(const T& value) {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    /**
+     * Forces all pending writes to memory.
+     */
+    inline void clobberMemory() {
+        asm volatile("" : : : "memory");
+    }
+
+}
+
+#define BENCHMARK(fn)   static bench::Registrar  bench_registrar_##fn(#fn, fn)
+
+#endif /* BENCHMARK_HPP_ */
@@ -0,0 +1,80 @@
+/*
+ * Composite_Bench.cpp
+ *
+ *  Access of Array and Embed fields.
+ */
+
+#include <vector>
+#include "Benchmark.hpp"
+#include "RecordView.hpp"
+using namespace overlay_record;
+
+namespace {
+
+    struct X : public Record {
+        Text<4>             txt = {this};
+        Integer             num = {this};
+    };
+
+    struct R : public Record {
+        Array<Integer, 16>  vals = {this};
+        Embed<X>            x    = {this};
+        Embed<X>            y    = {this};
+
+        R() = default;
+        R(char* buf, unsigned bufsiz) { assignStaticBuffer(buf, bufsiz); }
+    };
+
+    const size_t  N = 4096;
+
+    std::vector<char>&  records() {
+        static std::vector<char>  buf(N * Record::layout<R>().size, '\0');
+        return buf;
+    }
+
+    void BM_Array_Index(bench::State& state) {
+        RecordView<R>  view(records().data(), records().size());
+        while (state.keepRunning()) {
+            long  sum = 0;
+            for (const R& r : view) for (int k = 0; k < 16; ++k) sum += r.vals[k];
+            bench::doNotOptimize(sum);
+        }
+        state.setItemsProcessed(state.iterations() * N * 16);
+    }
+    BENCHMARK(BM_Array_Index);
+
+    void BM_Array_Iterate(bench::State& state) {
+        RecordView<const R>  view(records().data(), records().size());
+        while (state.keepRunning()) {
+            long  sum = 0;
+            for (const R& r : view) for (auto& v : r.vals) sum += v;
+            bench::doNotOptimize(sum);
+        }
+        state.setItemsProcessed(state.iterations() * N * 16);
+    }
+    BENCHMARK(BM_Array_Iterate);
+
+    void BM_Embed_Access(bench::State& state) {
+        RecordView<R>  view(records().data(), records().size());
+        while (state.keepRunning()) {
+            long  sum = 0;
+            for (const R& r : view) sum += r.x->num + r.y->num;
+            bench::doNotOptimize(sum);
+        }
+        state.setItemsProcessed(state.iterations() * N);
+    }
+    BENCHMARK(BM_Embed_Access);
+
+    void BM_Embed_Sliding(bench::State& state) {
+        std::vector<char>&  buf = records();
+        while (state.keepRunning()) {
+            R     r(buf.data(), buf.size());
+            long  sum = 0;
+            for (size_t k = 0; k < N; ++k, ++r) sum += r.x->num;
+            bench::doNotOptimize(sum);
+        }
+        state.setItemsProcessed(state.iterations() * N);
+    }
+    BENCHMARK(BM_Embed_Sliding);
+
+}
@@ -0,0 +1,71 @@
+/*
+ * Construction_Bench.cpp
+ *
+ *  Cost of creating record objects.
+ */
+
+#include "Benchmark.hpp"
+#include "RecordArena.hpp"
+using namespace overlay_record;
+
+namespace {
+
+    struct X : public Record {
+        Text<8>             txt = {this};
+        TextInteger<4>      num = {this};
+    };
+
+    struct R : public Record {
+        Text<16>            name   = {this};
+        Integer             id     = {this};
+        TextInteger<8>      amount = {this};
+        Double              rate   = {this};
+        Array<Text<4>, 8>   codes  = {this};
+        Embed<X>            x      = {this};
+
+        R() = default;
+        R(char* buf, unsigned bufsiz) { assignStaticBuffer(buf, bufsiz); }
+    };
+
+    void BM_Construction_StaticBuffer(bench::State& state) {
+        char  buf[128];
+        while (state.keepRunning()) {
+            R  r(buf, sizeof(buf));
+            bench::doNotOptimize(r);
+        }
+        state.setItemsProcessed(state.iterations());
+    }
+    BENCHMARK(BM_Construction_StaticBuffer);
+
+    void BM_Construction_DynamicBuffer(bench::State& state) {
+        while (state.keepRunning()) {
+            R  r;
+            r.allocateDynamicBuffer();
+            bench::doNotOptimize(r);
+        }
+        state.setItemsProcessed(state.iterations());
+    }
+    BENCHMARK(BM_Construction_DynamicBuffer);
+
+    void BM_Construction_Arena(bench::State& state) {
+        RecordArena  arena;
+        size_t  n = 0;
+        while (state.keepRunning()) {
+            R  r;
+            arena.allocate(r);
+            bench::doNotOptimize(r);
+            if (++n % 8192 == 0) arena.reset();
+        }
+        state.setItemsProcessed(state.iterations());
+    }
+    BENCHMARK(BM_Construction_Arena);
+
+    void BM_Construction_Layout(bench::State& state) {
+        while (state.keepRunning()) {
+            bench::doNotOptimize(Record::layout<R>().size);
+        }
+        state.setItemsProcessed(state.iterations());
+    }
+    BENCHMARK(BM_Construction_Layout);
+
+}
@@ -0,0 +1,133 @@
+/*
+ * Converter_Bench.cpp
+ *
+ *  Read and write throughput of the converters, over many consecutive records.
+ */
+
+#include <vector>
+#include "Benchmark.hpp"
+#include "RecordView.hpp"
+using namespace overlay_record;
+
+namespace {
+
+    struct R : public Record {
+        Text<16>            txt  = {this};
+        TextInteger<8>      num  = {this};
+        DecimalInteger<8>   dec  = {this};
+        TextFloat<12>       flt  = {this};
+        Integer             bin  = {this};
+        Double              dbl  = {this};
+        Blob<16>            blob = {this};
+    };
+
+    const size_t  N = 4096;
+
+    std::vector<char>&  records() {
+        static std::vector<char>  buf;
+        if (buf.empty()) {
+            buf.assign(N * Record::layout<R>().size, '\0');
+            RecordView<R>  view(buf.data(), buf.size());
+            for (size_t k = 0; k < N; ++k) {
+                R  r = view[k];
+                r.txt  = "some text";
+                r.num  = k * 7;
+                r.dec  = k * 7;
+                r.flt  = k * 0.5f;
+                r.bin  = k;
+                r.dbl  = k * 0.25;
+                r.blob = "00112233445566778899AABBCCDDEEFF";
+            }
+        }
+        return buf;
+    }
+
+    /**
+     * Reads field f of all records, per iteration.
+     */
+    template<typename Read>
+    void readAll(bench::State& state, Read read) {
+        RecordView<R>  view(records().data(), records().size());
+        while (state.keepRunning()) {
+            for (R r : view) bench::doNotOptimize(read(r));
+        }
+        state.setItemsProcessed(state.iterations() * N);
+    }
+
+    /**
+     * Writes field f of all records, per iteration.
+     */
+    template<typename Write>
+    void writeAll(bench::State& state, Write write) {
+        RecordView<R>  view(records().data(), records().size());
+        while (state.keepRunning()) {
+            int  k = 0;
+            for (R r : view) write(r, ++k);
+            bench::clobberMemory();
+        }
+        state.setItemsProcessed(state.iterations() * N);
+    }
+
+    void BM_TextConverter_Read(bench::State& state) {
+        readAll(state, [](R& r) { return r.txt.value(); });
+    }
+    BENCHMARK(BM_TextConverter_Read);
+
+    void BM_TextConverter_View(bench::State& state) {
+        readAll(state, [](R& r) { return r.txt.view().trimmed().size(); });
+    }
+    BENCHMARK(BM_TextConverter_View);
+
+    void BM_TextConverter_Write(bench::State& state) {
+        writeAll(state, [](R& r, int) { r.txt = "other text"; });
+    }
+    BENCHMARK(BM_TextConverter_Write);
+
+    void BM_NumericConverter_Read(bench::State& state) {
+        readAll(state, [](R& r) { return r.num.value(); });
+    }
+    BENCHMARK(BM_NumericConverter_Read);
+
+    void BM_NumericConverter_Write(bench::State& state) {
+        writeAll(state, [](R& r, int k) { r.num = k; });
+    }
+    BENCHMARK(BM_NumericConverter_Write);
+
+    void BM_NumericConverter_ReadFloat(bench::State& state) {
+        readAll(state, [](R& r) { return r.flt.value(); });
+    }
+    BENCHMARK(BM_NumericConverter_ReadFloat);
+
+    void BM_DecimalConverter_Read(bench::State& state) {
+        readAll(state, [](R& r) { return r.dec.value(); });
+    }
+    BENCHMARK(BM_DecimalConverter_Read);
+
+    void BM_DecimalConverter_Write(bench::State& state) {
+        writeAll(state, [](R& r, int k) { r.dec = k; });
+    }
+    BENCHMARK(BM_DecimalConverter_Write);
+
+    void BM_BinaryConverter_Read(bench::State& state) {
+        readAll(state, [](R& r) { return r.bin.value() + r.dbl.value(); });
+    }
+    BENCHMARK(BM_BinaryConverter_Read);
+
+    void BM_BinaryConverter_Write(bench::State& state) {
+        writeAll(state, [](R& r, int k) { r.bin = k; r.dbl = k; });
+    }
+    BENCHMARK(BM_BinaryConverter_Write);
+
+    void BM_HEXConverter_Read(bench::State& state) {
+        readAll(state, [](R& r) { return r.blob.value(); });
+        state.setBytesProcessed(state.iterations() * N * 16);
+    }
+    BENCHMARK(BM_HEXConverter_Read);
+
+    void BM_HEXConverter_Write(bench::State& state) {
+        writeAll(state, [](R& r, int) { r.blob = "FFEEDDCCBBAA99887766554433221100"; });
+        state.setBytesProcessed(state.iterations() * N * 16);
+    }
+    BENCHMARK(BM_HEXConverter_Write);
+
+}
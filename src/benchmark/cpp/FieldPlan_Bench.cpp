@@ -0,0 +1,79 @@
+/*
+ * FieldPlan_Bench.cpp
+ *
+ *  Decoding schema records, per field versus with a FieldPlan.
+ */
+
+#include <vector>
+#include "Benchmark.hpp"
+#include "FieldPlan.hpp"
+using namespace overlay_record;
+
+namespace {
+
+    struct Row {
+        long long   amount;
+        double      price;
+        int         count;
+        long long   id;
+    };
+
+    const size_t  N = 4096;
+
+    const RecordSchema&  schema() {
+        static const RecordSchema  s = RecordSchema::parse(
+                "name      text(12)\n"
+                "amount    integer(8)\n"
+                "price     packed(6,2)\n"
+                "count     int32be\n"
+                "id        int64\n");
+        return s;
+    }
+
+    std::vector<char>&  records() {
+        static std::vector<char>  buf;
+        if (buf.empty()) {
+            buf.resize(N * schema().size());
+            DynamicRecord  r(schema(), buf.data(), buf.size());
+            for (size_t k = 0; k < N; ++k, ++r) {
+                r.setInteger(schema().indexOf("amount"), k);
+                r.setReal(schema().indexOf("price"), k / 4.0);
+                r.setInteger(schema().indexOf("count"), k % 100);
+                r.setInteger(schema().indexOf("id"), k);
+            }
+        }
+        return buf;
+    }
+
+    void BM_Decode_PerField(bench::State& state) {
+        const size_t  amount = schema().indexOf("amount"), price = schema().indexOf("price");
+        const size_t  count  = schema().indexOf("count"),  id    = schema().indexOf("id");
+        std::vector<Row>  rows(N);
+        while (state.keepRunning()) {
+            DynamicRecord  r(schema(), records().data(), records().size());
+            for (size_t k = 0; k < N; ++k, ++r) {
+                rows[k].amount = r.integer(amount);
+                rows[k].price  = r.real(price);
+                rows[k].count  = (int)r.integer(count);
+                rows[k].id     = r.integer(id);
+            }
+            bench::clobberMemory();
+        }
+        state.setItemsProcessed(state.iterations() * N);
+    }
+    BENCHMARK(BM_Decode_PerField);
+
+    void BM_Decode_FieldPlan(bench::State& state) {
+        FieldPlan<Row>  plan(schema());
+        plan.bind("amount", &Row::amount).bind("price", &Row::price)
+            .bind("count", &Row::count).bind("id", &Row::id);
+        std::vector<Row>  rows(N);
+        while (state.keepRunning()) {
+            plan.decode(records().data(), N, rows.data());
+            bench::clobberMemory();
+        }
+        state.setItemsProcessed(state.iterations() * N);
+    }
+    BENCHMARK(BM_Decode_FieldPlan);
+
+}
@@ -0,0 +1,72 @@
+/*
+ * Filter_Bench.cpp
+ *
+ *  Selecting records, with overlays versus with a RecordFilter.
+ */
+
+#include <vector>
+#include "Benchmark.hpp"
+#include "RecordFilter.hpp"
+using namespace overlay_record;
+
+namespace {
+
+    struct R : public Record {
+        Text<24>            txt    = {this};
+        Text<4>             status = {this};
+        TextInteger<8>      amount = {this};
+        Integer             id     = {this};
+
+        R() = default;
+        R(char* buf, unsigned bufsiz) { assignStaticBuffer(buf, bufsiz); }
+    };
+
+    const size_t  N = 1 << 16;
+
+    std::vector<char>&  records() {
+        static std::vector<char>  buf;
+        if (buf.empty()) {
+            buf.assign(N * Record::layout<R>().size, '\0');
+            RecordView<R>  view(buf.data(), buf.size());
+            for (size_t k = 0; k < N; ++k) {
+                view[k].status = (k % 20 == 0) ? "OK" : "FAIL";
+                view[k].amount = k % 5000;
+                view[k].id     = k;
+            }
+        }
+        return buf;
+    }
+
+    void BM_Filter_Overlay(bench::State& state) {
+        std::vector<char>&  buf = records();
+        RecordView<const R>  view(buf.data(), buf.size());
+        std::vector<size_t>  rows;
+        while (state.keepRunning()) {
+            rows.clear();
+            size_t  k = 0;
+            for (const R& r : view) {
+                if (r.status.value() == "OK" && r.amount.value() > 1000) rows.push_back(k);
+                ++k;
+            }
+            bench::doNotOptimize(rows.data());
+        }
+        state.setItemsProcessed(state.iterations() * N);
+        state.setBytesProcessed(state.iterations() * buf.size());
+    }
+    BENCHMARK(BM_Filter_Overlay);
+
+    void BM_Filter_RecordFilter(bench::State& state) {
+        std::vector<char>&  buf = records();
+        R  proto;
+        RecordFilter<R>  filter;
+        filter.equals(proto.status, "OK").greater(proto.amount, 1000);
+        while (state.keepRunning()) {
+            std::vector<size_t>  rows = filter.select(buf.data(), N);
+            bench::doNotOptimize(rows.data());
+        }
+        state.setItemsProcessed(state.iterations() * N);
+        state.setBytesProcessed(state.iterations() * buf.size());
+    }
+    BENCHMARK(BM_Filter_RecordFilter);
+
+}
@@ -0,0 +1,120 @@
+/*
+ * Index_Bench.cpp
+ *
+ *  Looking up records by key, with scans versus with a RecordIndex.
+ */
+
+#include <vector>
+#include "Benchmark.hpp"
+#include "RecordIndex.hpp"
+using namespace overlay_record;
+
+namespace {
+
+    struct Customer : public Record {
+        Text<10>            id   = {this};
+        Text<30>            name = {this};
+        TextInteger<12>     account = {this};
+    };
+
+    struct Order : public Record {
+        Text<10>            customer = {this};
+        TextInteger<6>      qty      = {this};
+    };
+
+    const size_t  N = 1 << 16;     //customers
+    const size_t  M = 1 << 16;     //orders
+
+    std::string  customerId(size_t k) { return "C" + std::to_string(k * 13); }
+
+    std::vector<char>&  customers() {
+        static std::vector<char>  buf;
+        if (buf.empty()) {
+            buf.assign(N * Record::layout<Customer>().size, '\0');
+            RecordView<Customer>  view(buf.data(), buf.size());
+            for (size_t k = 0; k < N; ++k) {
+                view[k].id      = customerId(k);
+                view[k].account = 100000 + k;
+            }
+        }
+        return buf;
+    }
+
+    std::vector<char>&  orders() {
+        static std::vector<char>  buf;
+        if (buf.empty()) {
+            buf.assign(M * Record::layout<Order>().size, '\0');
+            RecordView<Order>  view(buf.data(), buf.size());
+            for (size_t k = 0; k < M; ++k) {
+                view[k].customer = customerId((k * 7919) % N);
+                view[k].qty      = k % 100;
+            }
+        }
+        return buf;
+    }
+
+    void BM_Index_ScanLookup(bench::State& state) {
+        RecordView<const Customer>  view(customers().data(), customers().size());
+        size_t  k = 0;
+        while (state.keepRunning()) {
+            const std::string  key = customerId((k++ * 7919) % N);
+            size_t  found = 0;
+            for (const Customer& c : view) {
+                if (c.id.value() == key) break;
+                ++found;
+            }
+            bench::doNotOptimize(found);
+        }
+        state.setItemsProcessed(state.iterations());
+    }
+    BENCHMARK(BM_Index_ScanLookup);
+
+    void BM_Index_Build(bench::State& state) {
+        Customer  proto;
+        while (state.keepRunning()) {
+            RecordIndex<Customer, Customer::Text<10>>  index(proto.id);
+            index.build(customers().data(), N);
+            bench::doNotOptimize(index.numSlots());
+        }
+        state.setItemsProcessed(state.iterations() * N);
+    }
+    BENCHMARK(BM_Index_Build);
+
+    void BM_Index_BuildDuplicates(bench::State& state) {
+        Order  proto;
+        while (state.keepRunning()) {
+            RecordIndex<Order, Order::TextInteger<6>>  index(proto.qty);
+            index.build(orders().data(), M);
+            bench::doNotOptimize(index.numKeys());
+        }
+        state.setItemsProcessed(state.iterations() * M);
+    }
+    BENCHMARK(BM_Index_BuildDuplicates);
+
+    void BM_Index_Find(bench::State& state) {
+        Customer  proto;
+        RecordIndex<Customer, Customer::Text<10>>  index(proto.id);
+        index.build(customers().data(), N);
+        RecordView<const Order>  view(orders().data(), orders().size());
+        while (state.keepRunning()) {
+            for (const Order& o : view) bench::doNotOptimize(index.find(o.customer.value()));
+        }
+        state.setItemsProcessed(state.iterations() * M);
+    }
+    BENCHMARK(BM_Index_Find);
+
+    void BM_Index_BatchLookup(bench::State& state) {
+        Customer  proto;
+        Order     order;
+        RecordIndex<Customer, Customer::Text<10>>  index(proto.id);
+        index.build(customers().data(), N);
+        std::vector<uint64_t>  matches(M);
+        while (state.keepRunning()) {
+            index.lookup<Order>(orders().data(), M, order.customer, matches.data());
+            bench::doNotOptimize(matches.data());
+        }
+        state.setItemsProcessed(state.iterations() * M);
+    }
+    BENCHMARK(BM_Index_BatchLookup);
+
+}
@@ -0,0 +1,117 @@
+/*
+ * Join_Bench.cpp
+ *
+ *  Joining and grouping records, with overlays and std::unordered_map
+ *  versus with RecordJoin and RecordGroupBy.
+ */
+
+#include <unordered_map>
+#include <vector>
+#include "Benchmark.hpp"
+#include "RecordGroupBy.hpp"
+#include "RecordJoin.hpp"
+using namespace overlay_record;
+
+namespace {
+
+    struct Customer : public Record {
+        Text<10>            id     = {this};
+        Text<30>            name   = {this};
+        Text<4>             region = {this};
+    };
+
+    struct Order : public Record {
+        Text<10>            customer = {this};
+        Text<4>             region   = {this};
+        TextInteger<8>      amount   = {this};
+        BigEndian<int32_t>  qty      = {this};
+    };
+
+    const size_t  N = 1 << 15;     //customers
+    const size_t  M = 1 << 17;     //orders
+
+    std::string  customerId(size_t k) { return "C" + std::to_string(k * 13); }
+
+    std::vector<char>&  customers() {
+        static std::vector<char>  buf;
+        if (buf.empty()) {
+            buf.assign(N * Record::layout<Customer>().size, '\0');
+            RecordView<Customer>  view(buf.data(), buf.size());
+            for (size_t k = 0; k < N; ++k) view[k].id = customerId(k);
+        }
+        return buf;
+    }
+
+    std::vector<char>&  orders() {
+        static std::vector<char>  buf;
+        if (buf.empty()) {
+            buf.assign(M * Record::layout<Order>().size, '\0');
+            RecordView<Order>  view(buf.data(), buf.size());
+            for (size_t k = 0; k < M; ++k) {
+                view[k].customer = customerId((k * 7919) % (N + N / 4));
+                view[k].region   = std::string(1, 'A' + k % 9);
+                view[k].amount   = (k * 104729) % 100000;
+                view[k].qty      = k % 50;
+            }
+        }
+        return buf;
+    }
+
+    void BM_Join_UnorderedMap(bench::State& state) {
+        RecordView<const Customer>  cs(customers().data(), customers().size());
+        RecordView<const Order>     os(orders().data(), orders().size());
+        std::vector<JoinMatch>  matches;
+        while (state.keepRunning()) {
+            std::unordered_map<std::string, uint64_t>  index;
+            for (size_t k = 0; k < N; ++k) index[cs[k].id.value()] = k;
+            matches.clear();
+            for (size_t k = 0; k < M; ++k) {
+                auto  it = index.find(os[k].customer.value());
+                if (it != index.end()) matches.push_back(JoinMatch{k, it->second});
+            }
+            bench::doNotOptimize(matches.data());
+        }
+        state.setItemsProcessed(state.iterations() * (N + M));
+    }
+    BENCHMARK(BM_Join_UnorderedMap);
+
+    void BM_Join_RecordJoin(bench::State& state) {
+        Order     order;
+        Customer  customer;
+        RecordJoin<Order, Customer, Order::Text<10>>  join(order.customer, customer.id);
+        while (state.keepRunning()) {
+            std::vector<JoinMatch>  matches = join.join(orders().data(), M, customers().data(), N);
+            bench::doNotOptimize(matches.data());
+        }
+        state.setItemsProcessed(state.iterations() * (N + M));
+    }
+    BENCHMARK(BM_Join_RecordJoin);
+
+    void BM_GroupBy_UnorderedMap(bench::State& state) {
+        RecordView<const Order>  os(orders().data(), orders().size());
+        while (state.keepRunning()) {
+            std::unordered_map<std::string, std::pair<long, long>>  groups;
+            for (const Order& o : os) {
+                std::pair<long, long>&  g = groups[o.region.value()];
+                g.first  += o.amount.value();
+                g.second  = std::max<long>(g.second, o.qty.value());
+            }
+            bench::doNotOptimize(groups.size());
+        }
+        state.setItemsProcessed(state.iterations() * M);
+    }
+    BENCHMARK(BM_GroupBy_UnorderedMap);
+
+    void BM_GroupBy_RecordGroupBy(bench::State& state) {
+        Order  proto;
+        RecordGroupBy<Order, Order::Text<4>>  byRegion(proto.region);
+        byRegion.sum(proto.amount).max(proto.qty);
+        while (state.keepRunning()) {
+            GroupedValues<Order::Text<4>>  groups = byRegion.aggregate(orders().data(), M);
+            bench::doNotOptimize(groups.size());
+        }
+        state.setItemsProcessed(state.iterations() * M);
+    }
+    BENCHMARK(BM_GroupBy_RecordGroupBy);
+
+}
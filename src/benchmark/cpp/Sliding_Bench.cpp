@@ -0,0 +1,135 @@
+/*
+ * Sliding_Bench.cpp
+ *
+ *  Scan throughput over a buffer of consecutive records.
+ */
+
+#include <vector>
+#include "Benchmark.hpp"
+#include "ColumnExport.hpp"
+#include "Parallel.hpp"
+using namespace overlay_record;
+
+namespace {
+
+    struct R : public Record {
+        Text<24>            txt    = {this};
+        Integer             id     = {this};
+        TextInteger<8>      amount = {this};
+        Double              rate   = {this};
+
+        R() = default;
+        R(char* buf, unsigned bufsiz) { assignStaticBuffer(buf, bufsiz); }
+    };
+
+    const size_t  N = 1 << 16;
+
+    std::vector<char>&  records() {
+        static std::vector<char>  buf;
+        if (buf.empty()) {
+            buf.assign(N * Record::layout<R>().size, '\0');
+            RecordView<R>  view(buf.data(), buf.size());
+            for (size_t k = 0; k < N; ++k) {
+                view[k].id     = k;
+                view[k].amount = k % 1000;
+            }
+        }
+        return buf;
+    }
+
+    void BM_Sliding_Increment(bench::State& state) {
+        std::vector<char>&  buf = records();
+        while (state.keepRunning()) {
+            R     r(buf.data(), buf.size());
+            long  sum = 0;
+            for (size_t k = 0; k < N; ++k, ++r) sum += r.id;
+            bench::doNotOptimize(sum);
+        }
+        state.setItemsProcessed(state.iterations() * N);
+        state.setBytesProcessed(state.iterations() * buf.size());
+    }
+    BENCHMARK(BM_Sliding_Increment);
+
+    void BM_Sliding_RecordView(bench::State& state) {
+        std::vector<char>&  buf = records();
+        RecordView<const R>  view(buf.data(), buf.size());
+        while (state.keepRunning()) {
+            long  sum = 0;
+            for (const R& r : view) sum += r.id;
+            bench::doNotOptimize(sum);
+        }
+        state.setItemsProcessed(state.iterations() * N);
+        state.setBytesProcessed(state.iterations() * buf.size());
+    }
+    BENCHMARK(BM_Sliding_RecordView);
+
+    void BM_Sliding_ExtractColumn(bench::State& state) {
+        std::vector<char>&  buf = records();
+        std::vector<int>    ids(N);
+        R  proto;
+        while (state.keepRunning()) {
+            extractColumn(proto.id, buf.data(), N, ids.data());
+            bench::clobberMemory();
+        }
+        state.setItemsProcessed(state.iterations() * N);
+    }
+    BENCHMARK(BM_Sliding_ExtractColumn);
+
+    void exportColumns(bench::State& state, const ParallelOptions* options) {
+        std::vector<char>&  buf = records();
+        RecordView<const R>  view(buf.data(), buf.size());
+        std::vector<int>     ids, amounts;
+        std::vector<double>  rates;
+        TextColumn           txts;
+        R  proto;
+        ColumnExport<R>  columns;
+        columns.add(proto.id, ids).add(proto.amount, amounts).add(proto.rate, rates).add(proto.txt, txts);
+        while (state.keepRunning()) {
+            state.pauseTiming();
+            ids.clear(); amounts.clear(); rates.clear(); txts.clear();
+            state.resumeTiming();
+            if (options) columns.exportFrom(view, *options);
+            else         columns.exportFrom(view);
+            bench::clobberMemory();
+        }
+        state.setItemsProcessed(state.iterations() * N);
+        state.setBytesProcessed(state.iterations() * buf.size());
+    }
+
+    void BM_Sliding_ColumnExport(bench::State& state) {
+        exportColumns(state, nullptr);
+    }
+    BENCHMARK(BM_Sliding_ColumnExport);
+
+    void BM_Sliding_ColumnExport_Parallel(bench::State& state) {
+        const ParallelOptions  options;
+        exportColumns(state, &options);
+    }
+    BENCHMARK(BM_Sliding_ColumnExport_Parallel);
+
+    void BM_Sliding_TextNumericScan(bench::State& state) {
+        std::vector<char>&  buf = records();
+        RecordView<const R>  view(buf.data(), buf.size());
+        while (state.keepRunning()) {
+            long  sum = 0;
+            for (const R& r : view) sum += r.amount;
+            bench::doNotOptimize(sum);
+        }
+        state.setItemsProcessed(state.iterations() * N);
+    }
+    BENCHMARK(BM_Sliding_TextNumericScan);
+
+    void BM_Sliding_ParallelReduce(bench::State& state) {
+        std::vector<char>&  buf = records();
+        RecordView<const R>  view(buf.data(), buf.size());
+        while (state.keepRunning()) {
+            long  sum = parallelReduce(view, 0L,
+                    [](long s, const R& r) { return s + r.amount; },
+                    [](long a, long b) { return a + b; });
+            bench::doNotOptimize(sum);
+        }
+        state.setItemsProcessed(state.iterations() * N);
+    }
+    BENCHMARK(BM_Sliding_ParallelReduce);
+
+}
@@ -0,0 +1,81 @@
+/*
+ * Sort_Bench.cpp
+ *
+ *  Sorting records, by comparing overlays versus by normalized keys.
+ */
+
+#include <algorithm>
+#include <vector>
+#include "Benchmark.hpp"
+#include "RecordSort.hpp"
+#include "RecordView.hpp"
+using namespace overlay_record;
+
+namespace {
+
+    struct R : public Record {
+        Text<24>            txt    = {this};
+        Text<4>             code   = {this};
+        TextInteger<8>      amount = {this};
+        BigEndian<int32_t>  id     = {this};
+
+        R() = default;
+        R(char* buf, unsigned bufsiz) { assignStaticBuffer(buf, bufsiz); }
+    };
+
+    const size_t  N = 1 << 16;
+
+    std::vector<char>&  records() {
+        static std::vector<char>  buf;
+        if (buf.empty()) {
+            buf.assign(N * Record::layout<R>().size, '\0');
+            RecordView<R>  view(buf.data(), buf.size());
+            for (size_t k = 0; k < N; ++k) {
+                view[k].code   = std::string(1, 'A' + k % 7);
+                view[k].amount = (k * 7919) % 100000;
+                view[k].id     = (k * 104729) % N;
+            }
+        }
+        return buf;
+    }
+
+    void BM_Sort_CompareOverlays(bench::State& state) {
+        RecordView<const R>  view(records().data(), records().size());
+        std::vector<size_t>  order(N);
+        while (state.keepRunning()) {
+            for (size_t k = 0; k < N; ++k) order[k] = k;
+            std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+                const std::string  ca = view[a].code.value(), cb = view[b].code.value();
+                return ca != cb ? ca < cb : view[a].amount.value() < view[b].amount.value();
+            });
+            bench::doNotOptimize(order.data());
+        }
+        state.setItemsProcessed(state.iterations() * N);
+    }
+    BENCHMARK(BM_Sort_CompareOverlays);
+
+    void BM_Sort_RadixKeys(bench::State& state) {
+        R  proto;
+        RecordSort<R>  sorter;
+        sorter.by(proto.code).by(proto.amount);
+        while (state.keepRunning()) {
+            std::vector<size_t>  order = sorter.order(records().data(), N);
+            bench::doNotOptimize(order.data());
+        }
+        state.setItemsProcessed(state.iterations() * N);
+    }
+    BENCHMARK(BM_Sort_RadixKeys);
+
+    void BM_Sort_MergeKeys(bench::State& state) {
+        R  proto;
+        RecordSort<R>  sorter;
+        sorter.by(proto.txt).by(proto.code).by(proto.amount);
+        while (state.keepRunning()) {
+            std::vector<size_t>  order = sorter.order(records().data(), N);
+            bench::doNotOptimize(order.data());
+        }
+        state.setItemsProcessed(state.iterations() * N);
+    }
+    BENCHMARK(BM_Sort_MergeKeys);
+
+}
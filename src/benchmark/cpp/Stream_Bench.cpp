@@ -0,0 +1,97 @@
+/*
+ * Stream_Bench.cpp
+ *
+ *  Record stream I/O, per record and block-buffered.
+ */
+
+#include <sstream>
+#include "Benchmark.hpp"
+#include "RecordStream.hpp"
+using namespace overlay_record;
+
+namespace {
+
+    struct R : public Record {
+        Text<24>            txt = {this};
+        Long                num = {this};
+
+        R() = default;
+        R(char* buf, unsigned bufsiz) { assignStaticBuffer(buf, bufsiz); }
+    };
+
+    const size_t  N = 1 << 14;
+
+    const std::string&  payload() {
+        static std::string  data;
+        if (data.empty()) {
+            std::ostringstream  os;
+            {
+                RecordWriter<R>  out(os);
+                for (size_t k = 0; k < N; ++k) out.append().num = k;
+            }
+            data = os.str();
+        }
+        return data;
+    }
+
+    void BM_Stream_WriteOperator(bench::State& state) {
+        char  buf[64] = {};
+        R     r(buf, sizeof(buf));
+        std::ostringstream  os;
+        while (state.keepRunning()) {
+            os.seekp(0);
+            for (size_t k = 0; k < N; ++k) os << r;
+        }
+        state.setItemsProcessed(state.iterations() * N);
+        state.setBytesProcessed(state.iterations() * N * r.size());
+    }
+    BENCHMARK(BM_Stream_WriteOperator);
+
+    void BM_Stream_ReadOperator(bench::State& state) {
+        char  buf[64];
+        R     r(buf, sizeof(buf));
+        std::istringstream  is(payload());
+        while (state.keepRunning()) {
+            is.clear();
+            is.seekg(0);
+            long  sum = 0;
+            for (size_t k = 0; k < N; ++k) {
+                is >> r;
+                sum += r.num;
+            }
+            bench::doNotOptimize(sum);
+        }
+        state.setItemsProcessed(state.iterations() * N);
+        state.setBytesProcessed(state.iterations() * payload().size());
+    }
+    BENCHMARK(BM_Stream_ReadOperator);
+
+    void BM_Stream_RecordWriter(bench::State& state) {
+        std::ostringstream  os;
+        while (state.keepRunning()) {
+            os.seekp(0);
+            RecordWriter<R>  out(os, 256 * 1024);
+            for (size_t k = 0; k < N; ++k) out.append().num = k;
+        }
+        state.setItemsProcessed(state.iterations() * N);
+        state.setBytesProcessed(state.iterations() * payload().size());
+    }
+    BENCHMARK(BM_Stream_RecordWriter);
+
+    void BM_Stream_RecordReader(bench::State& state) {
+        std::istringstream  is(payload());
+        while (state.keepRunning()) {
+            is.clear();
+            is.seekg(0);
+            RecordReader<R>  in(is, 256 * 1024);
+            long  sum = 0;
+            for (RecordView<R> v = in.nextBlock(); !v.empty(); v = in.nextBlock())
+                for (const R& r : v) sum += r.num;
+            bench::doNotOptimize(sum);
+        }
+        state.setItemsProcessed(state.iterations() * N);
+        state.setBytesProcessed(state.iterations() * payload().size());
+    }
+    BENCHMARK(BM_Stream_RecordReader);
+
+}
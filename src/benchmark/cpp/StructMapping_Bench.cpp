@@ -0,0 +1,81 @@
+/*
+ * StructMapping_Bench.cpp
+ *
+ *  Materializing rows, field by field versus with a StructMapping.
+ */
+
+#include <vector>
+#include "Benchmark.hpp"
+#include "RecordView.hpp"
+#include "StructMapping.hpp"
+using namespace overlay_record;
+
+namespace {
+
+    struct R : public Record {
+        Text<12>            name   = {this};
+        DecimalLong<8>      amount = {this};
+        Packed<6, double, 2> price = {this};
+        BigEndian<int32_t>  count  = {this};
+
+        R() = default;
+        R(char* buf, unsigned bufsiz) { assignStaticBuffer(buf, bufsiz); }
+    };
+
+    struct Row {
+        std::string     name;
+        long long       amount;
+        double          price;
+        int             count;
+    };
+
+    const size_t  N = 4096;
+
+    std::vector<char>&  records() {
+        static std::vector<char>  buf;
+        if (buf.empty()) {
+            buf.resize(N * Record::layout<R>().size);
+            R  r(buf.data(), buf.size());
+            for (size_t k = 0; k < N; ++k, ++r) {
+                r.name   = "customer";
+                r.amount = k;
+                r.price  = k / 4.0;
+                r.count  = k % 100;
+            }
+        }
+        return buf;
+    }
+
+    void BM_Rows_PerField(bench::State& state) {
+        std::vector<Row>  rows(N);
+        RecordView<R>  view(records().data(), records().size());
+        while (state.keepRunning()) {
+            size_t  k = 0;
+            for (const R& r : view) {
+                Row&  row = rows[k++];
+                row.name   = r.name.value();
+                row.amount = r.amount.value();
+                row.price  = r.price.value();
+                row.count  = r.count.value();
+            }
+            bench::clobberMemory();
+        }
+        state.setItemsProcessed(state.iterations() * N);
+    }
+    BENCHMARK(BM_Rows_PerField);
+
+    void BM_Rows_StructMapping(bench::State& state) {
+        auto  mapping = mapStruct<R, Row>(bindMember(&R::name,   &Row::name),
+                                          bindMember(&R::amount, &Row::amount),
+                                          bindMember(&R::price,  &Row::price),
+                                          bindMember(&R::count,  &Row::count));
+        std::vector<Row>  rows(N);
+        while (state.keepRunning()) {
+            mapping.decode(records().data(), N, rows.data());
+            bench::clobberMemory();
+        }
+        state.setItemsProcessed(state.iterations() * N);
+    }
+    BENCHMARK(BM_Rows_StructMapping);
+
+}
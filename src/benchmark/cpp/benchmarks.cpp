@@ -0,0 +1,96 @@
+/*
+ * benchmarks.cpp
+ *
+ *  Runs all registered benchmarks and writes the results as JSON.
+ *
+ *  usage: benchmarks [--filter=substring] [--min-time=seconds] [--out=file.json]
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include "Benchmark.hpp"
+using namespace std;
+
+static string  jsonString(const string& s) {
+    string  result = "\"";
+    for (char ch : s) {
+        if (ch == '"' || ch == '\\') result += '\\';
+        result += ch;
+    }
+    return result + "\"";
+}
+
+int main(int argc, char* argv[]) {
+    string  filter;
+    string  outFile;
+    double  minTime = 0.5;
+    for (int k = 1; k < argc; ++k) {
+        string  arg = argv[k];
+        if (arg.compare(0, 9, "--filter=") == 0)   filter  = arg.substr(9);
+        else if (arg.compare(0, 11, "--min-time=") == 0) minTime = atof(arg.substr(11).c_str());
+        else if (arg.compare(0, 6, "--out=") == 0) outFile = arg.substr(6);
+        else {
+            cerr << "usage: " << argv[0] << " [--filter=substring] [--min-time=seconds] [--out=file.json]" << endl;
+            return 1;
+        }
+    }
+
+    ofstream  file;
+    if (!outFile.empty()) file.open(outFile.c_str());
+    ostream&  out = outFile.empty() ? cout : file;
+
+    char  date[32];
+    time_t  now = time(nullptr);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+
+    out << "{\n"
+        << "  \"context\": {\n"
+        << "    \"date\": " << jsonString(date) << ",\n"
+        << "    \"num_cpus\": " << thread::hardware_concurrency() << ",\n"
+        << "    \"compiler\": " << jsonString(__VERSION__) << ",\n"
+        << "    \"min_time\": " << minTime << "\n"
+        << "  },\n"
+        << "  \"benchmarks\": [";
+
+    bool  first = true;
+    for (const bench::Benchmark& b : bench::registry()) {
+        if (!filter.empty() && b.name.find(filter) == string::npos) continue;
+
+        size_t  iterations = 1;
+        for (;;) {
+            bench::State  state(iterations);
+            b.fn(state);
+
+            const double  secs = state.seconds();
+            if (secs >= minTime || iterations >= 1000000000UL) {
+                cerr << b.name << ": " << secs * 1e9 / iterations << " ns/iteration" << endl;
+
+                out << (first ? "\n" : ",\n")
+                    << "    {\n"
+                    << "      \"name\": " << jsonString(b.name) << ",\n"
+                    << "      \"iterations\": " << iterations << ",\n"
+                    << "      \"real_time\": " << secs * 1e9 / iterations << ",\n"
+                    << "      \"time_unit\": \"ns\"";
+                if (state.itemsProcessed() > 0)
+                    out << ",\n      \"items_per_second\": " << state.itemsProcessed() / secs;
+                if (state.bytesProcessed() > 0)
+                    out << ",\n      \"bytes_per_second\": " << state.bytesProcessed() / secs;
+                out << "\n    }";
+                first = false;
+                break;
+            }
+
+            double  factor = secs > 0 ? 1.4 * minTime / secs : 10;
+            if (factor > 10) factor = 10;
+            if (factor < 2)  factor = 2;
+            iterations = (size_t)(iterations * factor);
+        }
+    }
+    out << "\n  ]\n}\n";
+    return 0;
+}
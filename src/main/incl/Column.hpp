@@ -0,0 +1,321 @@
+/*
+ * Column.hpp
+ *
+ *  Bulk access of one field across many records.
+ */
+
+#ifndef COLUMN_HPP_
+#define COLUMN_HPP_
+
+#include <cfloat>
+#include "Record.hpp"
+
+namespace overlay_record {
+
+    // -----------------------------------------------------
+    // --- Column kernels
+    // -----------------------------------------------------
+    /**
+     * Reads and writes a field at a fixed offset in <em>n</em> consecutive records of <em>stride</em> bytes.
+     * The generic kernel calls the converter per record; the pre-defined converters
+     * are specialized below, to tight loops without temporaries.
+     */
+    namespace detail {
+        /**
+         * Calls the converter per record.
+         */
+        template<typename Converter>
+        struct ConverterKernel {
+            template<typename Type>
+            static void extract(const char* p, unsigned size, size_t stride, size_t n, Type* out) {
+                for (size_t k = 0; k < n; ++k, p += stride) out[k] = Converter::fromStorage(p, size);
+            }
+
+            template<typename Type>
+            static void scatter(char* p, unsigned size, size_t stride, size_t n, const Type* in) {
+                for (size_t k = 0; k < n; ++k, p += stride) Converter::toStorage(in[k], p, size);
+            }
+        };
+    }
+
+    template<typename Converter>
+    struct ColumnKernel : detail::ConverterKernel<Converter> {};
+
+    template<typename Type>
+    struct ColumnKernel< Record::BinaryConverter<Type> > {
+        /**
+         * Copies four records per iteration; the loops count blocks and the remainder
+         * rather than compare k + 4 with n, so the bounds are plain for the optimizer.
+         */
+        static void extract(const char* p, unsigned, size_t stride, size_t n, Type* out) {
+            for (size_t b = n / 4; b > 0; --b, out += 4, p += 4 * stride) {
+                std::memcpy(out,     p,              sizeof(Type));
+                std::memcpy(out + 1, p + stride,     sizeof(Type));
+                std::memcpy(out + 2, p + 2 * stride, sizeof(Type));
+                std::memcpy(out + 3, p + 3 * stride, sizeof(Type));
+            }
+            for (size_t r = n % 4; r > 0; --r, ++out, p += stride) std::memcpy(out, p, sizeof(Type));
+        }
+
+        static void scatter(char* p, unsigned, size_t stride, size_t n, const Type* in) {
+            for (size_t b = n / 4; b > 0; --b, in += 4, p += 4 * stride) {
+                std::memcpy(p,              in,     sizeof(Type));
+                std::memcpy(p + stride,     in + 1, sizeof(Type));
+                std::memcpy(p + 2 * stride, in + 2, sizeof(Type));
+                std::memcpy(p + 3 * stride, in + 3, sizeof(Type));
+            }
+            for (size_t r = n % 4; r > 0; --r, ++in, p += stride) std::memcpy(p, in, sizeof(Type));
+        }
+    };
+
+    template<typename Type, ByteOrder ORDER>
+    struct ColumnKernel< Record::EndianConverter<Type, ORDER> > {
+        static void extract(const char* p, unsigned size, size_t stride, size_t n, Type* out) {
+            ColumnKernel< Record::BinaryConverter<Type> >::extract(p, size, stride, n, out);
+            if (ORDER != HOST_BYTE_ORDER) {
+                for (size_t k = 0; k < n; ++k) {
+                    out[k] = Record::EndianConverter<Type, ORDER>::fromStorage(reinterpret_cast<const char*>(out + k), size);
+                }
+            }
+        }
+
+        static void scatter(char* p, unsigned size, size_t stride, size_t n, const Type* in) {
+            for (size_t k = 0; k < n; ++k, p += stride) Record::EndianConverter<Type, ORDER>::toStorage(in[k], p, size);
+        }
+    };
+
+    template<char PAD>
+    struct ColumnKernel< Record::TextConverter<PAD> > {
+        static void extract(const char* p, unsigned size, size_t stride, size_t n, std::string* out) {
+            for (size_t k = 0; k < n; ++k, p += stride) out[k] = Record::TextConverter<PAD>::fromStorage(p, size);
+        }
+
+        static void scatter(char* p, unsigned size, size_t stride, size_t n, const std::string* in) {
+            for (size_t k = 0; k < n; ++k, p += stride) {
+                Record::TextConverter<PAD>::toStorage(in[k].data(), in[k].size(), p, size);
+            }
+        }
+    };
+
+    template<>
+    struct ColumnKernel< Record::HEXConverter > {
+        static void extract(const char* p, unsigned size, size_t stride, size_t n, std::string* out) {
+            for (size_t k = 0; k < n; ++k, p += stride) {
+                out[k].resize(2 * size);
+                Record::HEXConverter::encode(p, size, &out[k][0]);
+            }
+        }
+
+        static void scatter(char* p, unsigned size, size_t stride, size_t n, const std::string* in) {
+            for (size_t k = 0; k < n; ++k, p += stride) {
+                std::memset(p, '\0', size);
+                Record::HEXConverter::decode(in[k].data(), std::min<size_t>(2 * size, in[k].size()), p);
+            }
+        }
+    };
+
+    namespace detail {
+        /**
+         * Number type that a built-in character functor parses into, before it's narrowed to its
+         * result type, such as int for TO_SHORT; void for any other functor.
+         */
+        template<typename str2num> struct ParsedNumber                  { typedef void          type; };
+        template<> struct ParsedNumber<Record::TO_SHORT>                { typedef int           type; };
+        template<> struct ParsedNumber<Record::TO_INT>                  { typedef int           type; };
+        template<> struct ParsedNumber<Record::TO_LONG>                 { typedef long          type; };
+        template<> struct ParsedNumber<Record::TO_LONG_LONG>            { typedef long long     type; };
+        template<> struct ParsedNumber<Record::TO_UNSIGNED_LONG>        { typedef unsigned long type; };
+        template<> struct ParsedNumber<Record::TO_FLOAT>                { typedef float         type; };
+        template<> struct ParsedNumber<Record::TO_DOUBLE>               { typedef double        type; };
+        template<> struct ParsedNumber<Record::TO_LONG_DOUBLE>          { typedef long double   type; };
+
+        /**
+         * Parses the common case of what std::stoi, std::stod and their siblings accept, in place:
+         * leading blanks, a sign and at most as many digits as are exact in Number, followed by
+         * blanks or NULs for a float, and anything but a digit for an integer.
+         * Returns false for anything else, which is left to the functor.
+         */
+        template<typename Number>
+        bool  parseNumber(const char* p, const char* end, Number& result, std::true_type) {
+            while (p < end && *p == ' ') ++p;
+            const bool  negative = p < end && *p == '-';
+            if (p < end && (*p == '-' || *p == '+')) ++p;
+            if (negative && std::is_unsigned<Number>::value) return false;
+
+            const char*  first = p;
+            Number  magnitude = 0;
+            for (; p < end && static_cast<unsigned char>(*p - '0') < 10; ++p) {
+                if (p - first == std::numeric_limits<Number>::digits10) return false;
+                magnitude = magnitude * 10 + (*p - '0');
+            }
+            if (p == first) return false;
+            result = negative ? Number(0) - magnitude : magnitude;
+            return true;
+        }
+
+        template<typename Number>
+        bool  parseNumber(const char* p, const char* end, Number& result, std::false_type) {
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+            //m / 10^f is exact, when both are, and correctly rounded like strtod, without excess precision
+            static const int  MAX_EXACT_POWER = std::numeric_limits<Number>::digits >= 64 ? 27
+                                              : std::numeric_limits<Number>::digits >= 53 ? 22 : 10;
+            while (p < end && *p == ' ') ++p;
+            const bool  negative = p < end && *p == '-';
+            if (p < end && (*p == '-' || *p == '+')) ++p;
+
+            unsigned long long  mantissa = 0;
+            int  numDigits = 0, numDecimals = -1;
+            for (; p < end; ++p) {
+                if (static_cast<unsigned char>(*p - '0') < 10) {
+                    if (++numDigits > std::numeric_limits<Number>::digits10) return false;
+                    mantissa = mantissa * 10 + (*p - '0');
+                    if (numDecimals >= 0) ++numDecimals;
+                } else if (*p == '.' && numDecimals < 0) {
+                    numDecimals = 0;
+                } else break;
+            }
+            if (numDigits == 0 || numDecimals > MAX_EXACT_POWER) return false;
+            for (; p < end; ++p) if (*p != ' ' && *p != '\0') return false;
+
+            Number  value = static_cast<Number>(mantissa);
+            if (numDecimals > 0) {
+                Number  power = 1;
+                for (int k = 0; k < numDecimals; ++k) power *= 10;
+                value /= power;
+            }
+            result = negative ? -value : value;
+            return true;
+#else
+            return false;
+#endif
+        }
+
+        /**
+         * Formats an integer as std::to_string does, into buf, which must hold 24 characters.
+         * Returns the number of characters.
+         */
+        template<typename Type>
+        unsigned  formatInteger(Type v, char* buf) {
+            char  digits[24];
+            char* p = digits + sizeof(digits);
+            typedef typename std::make_unsigned<Type>::type  Magnitude;
+            const bool  negative = v < 0;
+            Magnitude  m = negative ? Magnitude(0) - static_cast<Magnitude>(v) : static_cast<Magnitude>(v);
+            do { *--p = char('0' + m % 10); m /= 10; } while (m != 0);
+            if (negative) *--p = '-';
+            const unsigned  n = digits + sizeof(digits) - p;
+            std::memcpy(buf, p, n);
+            return n;
+        }
+
+        /**
+         * Column kernel of numeric text with the functor str2num, which parses the built-in
+         * functors in place and falls back to the converter for all other text, or other functors.
+         * Either way, each value is the same as Field::value() gives, or sets.
+         */
+        template<typename Type, typename str2num, char PAD, typename Number = typename ParsedNumber<str2num>::type>
+        struct NumericTextKernel {
+            typedef Record::NumericConverter<Type, str2num, PAD>    Converter;
+            typedef decltype(std::declval<str2num&>()(std::declval<const std::string&>()))  Result;
+
+            static void extract(const char* p, unsigned size, size_t stride, size_t n, Type* out) {
+                for (size_t k = 0; k < n; ++k, p += stride) {
+                    Number  v;
+                    if (size > 0 && parseNumber(p, p + size, v, std::is_integral<Number>()))
+                        out[k] = static_cast<Type>(static_cast<Result>(v));
+                    else
+                        out[k] = Converter::fromStorage(p, size);
+                }
+            }
+
+            static void scatter(char* p, unsigned size, size_t stride, size_t n, const Type* in) {
+                scatter(p, size, stride, n, in, std::is_integral<Type>());
+            }
+
+        private:
+            static void scatter(char* p, unsigned size, size_t stride, size_t n, const Type* in, std::true_type) {
+                char  buf[24];
+                for (size_t k = 0; k < n; ++k, p += stride) {
+                    const unsigned  len = std::min(formatInteger(in[k], buf), size);
+                    std::memcpy(p, buf, len);
+                    std::memset(p + len, PAD, size - len);
+                }
+            }
+
+            static void scatter(char* p, unsigned size, size_t stride, size_t n, const Type* in, std::false_type) {
+                for (size_t k = 0; k < n; ++k, p += stride) Converter::toStorage(in[k], p, size);
+            }
+        };
+
+        template<typename Type, typename str2num, char PAD>
+        struct NumericTextKernel<Type, str2num, PAD, void> : ConverterKernel< Record::NumericConverter<Type, str2num, PAD> > {};
+    }
+
+    /**
+     * Numeric text of the built-in functors is parsed in place, instead of via std::string.
+     * Text beyond the common case, other functors and float formatting use the converter,
+     * so that values, errors included, are always the same as those of Field::value().
+     */
+    template<typename Type, typename str2num, char PAD>
+    struct ColumnKernel< Record::NumericConverter<Type, str2num, PAD> >
+            : detail::NumericTextKernel<Type, str2num, PAD> {};
+
+
+    // -----------------------------------------------------
+    // --- Column extraction
+    // -----------------------------------------------------
+    /**
+     * Copies the value of <em>field</em> from each of <em>nrecords</em> consecutive records
+     * starting at base, into out. The records are <em>stride</em> bytes apart.
+     */
+    template<typename Type, unsigned N, typename C>
+    void extractColumn(const Record::Field<Type, N, C>& field, const char* base, size_t nrecords, size_t stride, Type* out) {
+        ColumnKernel<C>::extract(base + field.outerOffset(), N, stride, nrecords, out);
+    }
+
+    /**
+     * Copies the value of <em>field</em> from each of <em>nrecords</em> consecutive records
+     * starting at base, into out. The stride is the size of the field's outermost record.
+     *
+     * <pre>
+     *   R  proto;
+     *   std::vector<int>  amounts(n);
+     *   extractColumn(proto.amount, buf, n, amounts.data());
+     * </pre>
+     */
+    template<typename Type, unsigned N, typename C>
+    void extractColumn(const Record::Field<Type, N, C>& field, const char* base, size_t nrecords, Type* out) {
+        extractColumn(field, base, nrecords, field.record->outermost().size(), out);
+    }
+
+
+
+    // -----------------------------------------------------
+    // --- Column scatter
+    // -----------------------------------------------------
+    /**
+     * Assigns in[k] to <em>field</em> of record k, for each of <em>nrecords</em> consecutive records
+     * starting at base. The records are <em>stride</em> bytes apart.
+     */
+    template<typename Type, unsigned N, typename C>
+    void scatterColumn(const Record::Field<Type, N, C>& field, char* base, size_t nrecords, size_t stride, const Type* in) {
+        ColumnKernel<C>::scatter(base + field.outerOffset(), N, stride, nrecords, in);
+    }
+
+    /**
+     * Assigns in[k] to <em>field</em> of record k, for each of <em>nrecords</em> consecutive records
+     * starting at base. The stride is the size of the field's outermost record.
+     *
+     * <pre>
+     *   R  proto;
+     *   scatterColumn(proto.amount, buf, n, amounts.data());
+     * </pre>
+     */
+    template<typename Type, unsigned N, typename C>
+    void scatterColumn(const Record::Field<Type, N, C>& field, char* base, size_t nrecords, const Type* in) {
+        scatterColumn(field, base, nrecords, field.record->outermost().size(), in);
+    }
+
+}
+
+#endif /* COLUMN_HPP_ */
@@ -0,0 +1,277 @@
+/*
+ * ColumnExport.hpp
+ *
+ *  Transposition of record ranges into columns.
+ */
+
+#ifndef COLUMN_EXPORT_HPP_
+#define COLUMN_EXPORT_HPP_
+
+#include "Column.hpp"
+#include "Parallel.hpp"
+#include "RecordStream.hpp"
+
+namespace overlay_record {
+
+    // -----------------------------------------------------
+    // --- class TextColumn
+    // -----------------------------------------------------
+    /**
+     * Column of variable-length strings, stored as one character buffer and
+     * size()+1 offsets into it, as used by columnar formats.
+     * Value k is data[offsets[k] .. offsets[k+1]).
+     */
+    class TextColumn {
+        std::vector<size_t>     offsets_ = std::vector<size_t>(1, 0);
+        std::string             data_;
+
+    public:
+        size_t      size()  const { return offsets_.size() - 1; }
+        bool        empty() const { return size() == 0; }
+
+        const std::vector<size_t>&  offsets() const { return offsets_; }
+        const std::string&          data()    const { return data_; }
+
+        TextView    operator [](size_t k) const {
+            return TextView(data_.data() + offsets_[k], offsets_[k + 1] - offsets_[k]);
+        }
+
+        /**
+         * Makes room for n more values of together <em>bytes</em> characters.
+         * Grows geometrically, so repeated calls don't reallocate every time.
+         */
+        void        reserve(size_t n, size_t bytes) {
+            if (offsets_.size() + n > offsets_.capacity())
+                offsets_.reserve(std::max(offsets_.size() + n, 2 * offsets_.capacity()));
+            if (data_.size() + bytes > data_.capacity())
+                data_.reserve(std::max(data_.size() + bytes, 2 * data_.capacity()));
+        }
+
+        void        push_back(const char* s, size_t n) {
+            data_.append(s, n);
+            offsets_.push_back(data_.size());
+        }
+
+        void        push_back(const TextView& s) { push_back(s.data(), s.size()); }
+
+        /**
+         * Appends all values of that, keeping their order.
+         */
+        void        append(const TextColumn& that) {
+            const size_t  base = data_.size();
+            reserve(that.size(), that.data_.size());
+            data_ += that.data_;
+            for (size_t k = 1; k < that.offsets_.size(); ++k) offsets_.push_back(base + that.offsets_[k]);
+        }
+
+        void        clear() {
+            offsets_.assign(1, 0);
+            data_.clear();
+        }
+    };
+
+
+    namespace detail {
+        /**
+         * Destination of one field in a ColumnExport.
+         * A pass over a range is prepare(), then exportChunk() per chunk in any order
+         * and from any thread, then finish().
+         */
+        struct ColumnSink {
+            virtual ~ColumnSink() = default;
+            virtual void    prepare(size_t numRecords, size_t numChunks) = 0;
+            virtual void    exportChunk(const char* base, size_t n, size_t stride, size_t at, size_t chunk) = 0;
+            virtual void    finish() = 0;
+        };
+
+        /**
+         * Fixed-width values, extracted with the field's ColumnKernel directly into their final position.
+         */
+        template<typename Type, typename C>
+        class ArraySink : public ColumnSink {
+            unsigned                offset, size;
+            std::vector<Type>&      column;
+            size_t                  first = 0;
+
+        public:
+            ArraySink(unsigned offset, unsigned size, std::vector<Type>& column)
+                : offset(offset), size(size), column(column) {}
+
+            void    prepare(size_t numRecords, size_t) override {
+                first = column.size();
+                column.resize(first + numRecords);
+            }
+
+            void    exportChunk(const char* base, size_t n, size_t stride, size_t at, size_t) override {
+                ColumnKernel<C>::extract(base + offset, size, stride, n, column.data() + first + at);
+            }
+
+            void    finish() override {}
+        };
+
+        /**
+         * Text values, without trailing pad and NUL characters when TRIM.
+         * Each chunk is collected separately, and appended in record order by finish().
+         */
+        template<bool TRIM, char PAD>
+        class TextSink : public ColumnSink {
+            unsigned                offset, size;
+            TextColumn&             column;
+            std::vector<TextColumn> parts;
+
+            static void  collect(const char* p, unsigned size, size_t stride, size_t n, TextColumn& out) {
+                out.reserve(n, n * size);
+                for (size_t k = 0; k < n; ++k, p += stride) {
+                    size_t  len = size;
+                    if (TRIM) while (len > 0 && (p[len - 1] == PAD || p[len - 1] == '\0')) --len;
+                    out.push_back(p, len);
+                }
+            }
+
+        public:
+            TextSink(unsigned offset, unsigned size, TextColumn& column)
+                : offset(offset), size(size), column(column) {}
+
+            void    prepare(size_t, size_t numChunks) override {
+                parts.clear();
+                if (numChunks > 1) parts.resize(numChunks);
+            }
+
+            void    exportChunk(const char* base, size_t n, size_t stride, size_t, size_t chunk) override {
+                collect(base + offset, size, stride, n, parts.empty() ? column : parts[chunk]);
+            }
+
+            void    finish() override {
+                for (const TextColumn& part : parts) column.append(part);
+                parts.clear();
+            }
+        };
+    }
+
+
+    // -----------------------------------------------------
+    // --- class ColumnExport
+    // -----------------------------------------------------
+    /**
+     * Transposes records of RecordType into one column per selected field.
+     * Fixed-width fields go to std::vector of their type, using the same kernels as extractColumn(),
+     * and text fields go to a TextColumn, without their trailing padding.
+     * Blob fields go to a TextColumn of their raw bytes.
+     *
+     * The records are processed in blocks of about blockBytes, exporting all columns of a block
+     * while it is in cache. Each export appends to the columns, so a file can be
+     * exported from a RecordView (also of a MappedRecordFile), from a stream, or piecewise.
+     *
+     * <pre>
+     *   R  proto;
+     *   std::vector<int>  amounts;
+     *   TextColumn        names;
+     *   ColumnExport<R>   columns;
+     *   columns.add(proto.amount, amounts).add(proto.name, names);
+     *   columns.exportFrom(file.records(), ParallelOptions());
+     * </pre>
+     */
+    template<typename RecordType>
+    class ColumnExport {
+        std::vector<std::unique_ptr<detail::ColumnSink>>    sinks;
+        unsigned                                            stride = Record::layout<RecordType>().size;
+        size_t                                              blockBytes;
+
+        template<typename Field>
+        unsigned  offsetOf(const Field& field) const {
+            const unsigned  offset = field.outerOffset();
+            if (offset + field.size() > stride) throw IndexOutOfBounds(offset + field.size(), stride);
+            return offset;
+        }
+
+        /**
+         * Exports n records at base, as one chunk, in blocks.
+         */
+        void  exportChunk(const char* base, size_t n, size_t at, size_t chunk) {
+            size_t  blockRecords = blockBytes / stride;
+            if (blockRecords == 0) blockRecords = 1;
+            for (size_t k = 0; k < n; k += blockRecords) {
+                const size_t  m = std::min(blockRecords, n - k);
+                for (auto& sink : sinks) sink->exportChunk(base + k * stride, m, stride, at + k, chunk);
+            }
+        }
+
+    public:
+        /**
+         * Default block size; most of a typical L2 cache.
+         */
+        static const size_t  DEFAULT_BLOCK_BYTES = 128 * 1024;
+
+        explicit ColumnExport(size_t blockBytes = DEFAULT_BLOCK_BYTES) : blockBytes(blockBytes) {}
+
+        /**
+         * Exports <em>field</em> into column.
+         * The field is taken from any instance of RecordType, which need not have storage.
+         */
+        template<typename Type, unsigned N, typename C>
+        ColumnExport&  add(const Record::Field<Type, N, C>& field, std::vector<Type>& column) {
+            sinks.emplace_back(new detail::ArraySink<Type, C>(offsetOf(field), N, column));
+            return *this;
+        }
+
+        template<unsigned N, char PAD>
+        ColumnExport&  add(const Record::Field<std::string, N, Record::TextConverter<PAD>>& field, TextColumn& column) {
+            sinks.emplace_back(new detail::TextSink<true, PAD>(offsetOf(field), N, column));
+            return *this;
+        }
+
+        template<unsigned N>
+        ColumnExport&  add(const Record::Field<std::string, N, Record::HEXConverter>& field, TextColumn& column) {
+            sinks.emplace_back(new detail::TextSink<false, '\0'>(offsetOf(field), N, column));
+            return *this;
+        }
+
+        size_t  numColumns() const { return sinks.size(); }
+
+        /**
+         * Exports n consecutive records at base.
+         */
+        void  exportFrom(const char* base, size_t n) {
+            for (auto& sink : sinks) sink->prepare(n, 1);
+            exportChunk(base, n, 0, 0);
+            for (auto& sink : sinks) sink->finish();
+        }
+
+        template<typename R>
+        void  exportFrom(const RecordView<R>& view) {
+            exportFrom(view.data(), view.size());
+        }
+
+        /**
+         * Exports view in parallel, with chunks scheduled as by parallelForEach().
+         * The columns are in record order, as when exported sequentially.
+         */
+        template<typename R>
+        void  exportFrom(const RecordView<R>& view, const ParallelOptions& options) {
+            const detail::ChunkPlan  plan(view.size(), stride, options);
+            for (auto& sink : sinks) sink->prepare(view.size(), plan.numChunks);
+            detail::runChunks(view, plan, [&](unsigned, const RecordView<R>& chunk) {
+                const size_t  at = (chunk.data() - view.data()) / stride;
+                exportChunk(chunk.data(), chunk.size(), at, at / plan.chunkRecords);
+            });
+            for (auto& sink : sinks) sink->finish();
+        }
+
+        /**
+         * Exports all records of a stream, one block at a time.
+         * Returns the number of records exported.
+         */
+        size_t  exportFrom(std::istream& is, size_t blockSize = DEFAULT_BLOCK_SIZE) {
+            RecordReader<RecordType>  reader(is, blockSize);
+            size_t  total = 0;
+            for (RecordView<RecordType> block = reader.nextBlock(); block.size() > 0; block = reader.nextBlock()) {
+                exportFrom(block);
+                total += block.size();
+            }
+            return total;
+        }
+    };
+
+}
+
+#endif /* COLUMN_EXPORT_HPP_ */
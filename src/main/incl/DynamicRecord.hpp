@@ -0,0 +1,671 @@
+/*
+ * DynamicRecord.hpp
+ *
+ *  Records with a layout loaded at runtime, from a schema.
+ */
+
+#ifndef DYNAMIC_RECORD_HPP_
+#define DYNAMIC_RECORD_HPP_
+
+#include <istream>
+#include <memory>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+#include "Record.hpp"
+
+namespace overlay_record {
+
+    /**
+     * Thrown for an invalid schema, or an unknown field name.
+     */
+    struct SchemaError : public std::invalid_argument {
+        SchemaError(const std::string& msg) : std::invalid_argument(msg) {}
+    };
+
+    /**
+     * Storage type of a schema field.
+     */
+    enum class SchemaType {
+        TEXT,                               // text(N)
+        INTEGER, DECIMAL,                   // integer(N), decimal(N): numbers as text
+        INT8, INT16, INT32, INT64,          // int8 ... int64, optionally suffixed be or le
+        UINT8, UINT16, UINT32, UINT64,      // uint8 ... uint64
+        FLOAT32, FLOAT64,                   // float32, float64
+        PACKED, ZONED,                      // packed(N[,S]), zoned(N[,S])
+        BLOB,                               // blob(N): binary, accessed as HEX text
+        GROUP                               // group ... end: embedded record
+    };
+
+    /**
+     * A field of a RecordSchema. Fields of groups and array items are flattened,
+     * and named by their path, such as <code>address.zip</code> and <code>codes[2]</code>.
+     */
+    struct SchemaField {
+        std::string     name;
+        SchemaType      type;
+        unsigned        offset;
+        unsigned        size;
+        unsigned        scale;      //implied decimals of PACKED and ZONED
+        ByteOrder       order;      //of binary numbers
+
+        /**
+         * Returns true for fields holding whole numbers.
+         */
+        bool  isIntegral() const {
+            switch (type) {
+                case SchemaType::INTEGER:
+                case SchemaType::INT8:  case SchemaType::INT16:  case SchemaType::INT32:  case SchemaType::INT64:
+                case SchemaType::UINT8: case SchemaType::UINT16: case SchemaType::UINT32: case SchemaType::UINT64:
+                    return true;
+                case SchemaType::PACKED:
+                case SchemaType::ZONED:
+                    return scale == 0;
+                default:
+                    return false;
+            }
+        }
+
+        /**
+         * Returns true for fields holding numbers with decimals.
+         */
+        bool  isReal() const {
+            switch (type) {
+                case SchemaType::DECIMAL:
+                case SchemaType::FLOAT32:
+                case SchemaType::FLOAT64:
+                    return true;
+                case SchemaType::PACKED:
+                case SchemaType::ZONED:
+                    return scale > 0;
+                default:
+                    return false;
+            }
+        }
+
+        bool  isNumeric() const {
+            return isIntegral() || isReal();
+        }
+
+        FieldKind  kind() const {
+            switch (type) {
+                case SchemaType::TEXT:      return FieldKind::TEXT;
+                case SchemaType::INTEGER:
+                case SchemaType::DECIMAL:   return FieldKind::NUMERIC;
+                case SchemaType::PACKED:    return FieldKind::PACKED_DECIMAL;
+                case SchemaType::ZONED:     return FieldKind::ZONED_DECIMAL;
+                case SchemaType::BLOB:      return FieldKind::HEX;
+                case SchemaType::GROUP:     return FieldKind::EMBED;
+                default:                    return FieldKind::BINARY;
+            }
+        }
+    };
+
+
+    // -----------------------------------------------------
+    // --- class RecordSchema
+    // -----------------------------------------------------
+    /**
+     * Runtime layout of a record, parsed from a text description with one field per line.
+     * Fields are placed one after the other, as the members of a Record subclass.
+     *
+     * <pre>
+     *   # name     type            options
+     *   id         text(8)
+     *   amount     integer(10)
+     *   rate       float64be
+     *   price      packed(5,2)
+     *   codes      text(3)         occurs 4
+     *   address    group
+     *     street   text(20)
+     *     zip      integer(5)
+     *   end
+     *   all        text(8)         at id       # overlay from start of id
+     *   tail       text(2)         after id    # overlay from end of id
+     * </pre>
+     *
+     * Resolve names with indexOf() once, and access the fields by index.
+     */
+    class RecordSchema {
+        std::vector<SchemaField>                    fieldList;
+        std::unordered_map<std::string, size_t>     index;
+        unsigned                                    recordSize = 0;
+
+        struct Decl {
+            std::string         name;
+            SchemaType          type  = SchemaType::TEXT;
+            unsigned            size  = 0;
+            unsigned            scale = 0;
+            ByteOrder           order = HOST_BYTE_ORDER;
+            unsigned            count = 0;      //0: not an array
+            int                 placement = 0;  //0: next, 1: at, 2: after
+            std::string         ref;
+            int                 line  = 0;
+            std::vector<Decl>   children;
+        };
+
+        static SchemaError  error(int line, const std::string& msg) {
+            return SchemaError("Schema line " + std::to_string(line) + ": " + msg);
+        }
+
+        static unsigned  number(const std::string& s, int line) {
+            if (s.empty() || s.find_first_not_of("0123456789") != std::string::npos)
+                throw error(line, "expected a number, got '" + s + "'");
+            return static_cast<unsigned>(std::stoul(s));
+        }
+
+        /**
+         * Parses a type such as <code>text(8)</code>, <code>packed(5,2)</code> or <code>int32be</code>.
+         */
+        static void  parseType(const std::string& token, Decl& d) {
+            std::string  name = token;
+            std::vector<unsigned>  args;
+            const size_t  paren = token.find('(');
+            if (paren != std::string::npos) {
+                if (token.back() != ')') throw error(d.line, "missing ')' in '" + token + "'");
+                name = token.substr(0, paren);
+                std::istringstream  is(token.substr(paren + 1, token.size() - paren - 2));
+                for (std::string arg; std::getline(is, arg, ',');) args.push_back(number(arg, d.line));
+            }
+
+            struct Binary { const char* name; SchemaType type; unsigned size; };
+            static const Binary  binaries[] = {
+                {"int8",  SchemaType::INT8,  1}, {"int16",  SchemaType::INT16,  2},
+                {"int32", SchemaType::INT32, 4}, {"int64",  SchemaType::INT64,  8},
+                {"uint8", SchemaType::UINT8, 1}, {"uint16", SchemaType::UINT16, 2},
+                {"uint32", SchemaType::UINT32, 4}, {"uint64", SchemaType::UINT64, 8},
+                {"float32", SchemaType::FLOAT32, 4}, {"float64", SchemaType::FLOAT64, 8},
+            };
+            for (const Binary& b : binaries) {
+                const std::string  base = b.name;
+                if (name.compare(0, base.size(), base) != 0) continue;
+                const std::string  suffix = name.substr(base.size());
+                if (suffix.empty())      d.order = HOST_BYTE_ORDER;
+                else if (suffix == "be") d.order = ByteOrder::BIG;
+                else if (suffix == "le") d.order = ByteOrder::LITTLE;
+                else continue;
+                if (!args.empty()) throw error(d.line, "no size expected for '" + name + "'");
+                d.type = b.type;
+                d.size = b.size;
+                return;
+            }
+
+            struct Sized { const char* name; SchemaType type; bool scaled; };
+            static const Sized  sized[] = {
+                {"text", SchemaType::TEXT, false}, {"integer", SchemaType::INTEGER, false},
+                {"decimal", SchemaType::DECIMAL, false}, {"blob", SchemaType::BLOB, false},
+                {"packed", SchemaType::PACKED, true}, {"zoned", SchemaType::ZONED, true},
+            };
+            for (const Sized& t : sized) {
+                if (name != t.name) continue;
+                if (args.empty() || args.size() > (t.scaled ? 2U : 1U) || args[0] == 0)
+                    throw error(d.line, "invalid size of '" + token + "'");
+                d.type  = t.type;
+                d.size  = args[0];
+                d.scale = args.size() > 1 ? args[1] : 0;
+                return;
+            }
+
+            if (name == "group" && args.empty()) {
+                d.type = SchemaType::GROUP;
+                return;
+            }
+            throw error(d.line, "unknown type '" + token + "'");
+        }
+
+        /**
+         * Parses declarations until 'end' or end of input.
+         */
+        static std::vector<Decl>  parseBlock(std::istream& is, int& line, bool nested) {
+            std::vector<Decl>  decls;
+            for (std::string text; std::getline(is, text);) {
+                ++line;
+                const size_t  comment = text.find('#');
+                if (comment != std::string::npos) text.erase(comment);
+
+                std::istringstream  tokens(text);
+                std::vector<std::string>  words;
+                for (std::string w; tokens >> w;) words.push_back(w);
+                if (words.empty()) continue;
+
+                if (words[0] == "end" && words.size() == 1) {
+                    if (!nested) throw error(line, "'end' without 'group'");
+                    return decls;
+                }
+                if (words.size() < 2) throw error(line, "expected a name and a type");
+
+                Decl  d;
+                d.name = words[0];
+                d.line = line;
+                if (d.name.find_first_of(".[]") != std::string::npos) throw error(line, "invalid name '" + d.name + "'");
+                parseType(words[1], d);
+
+                for (size_t k = 2; k < words.size(); k += 2) {
+                    if (k + 1 >= words.size()) throw error(line, "missing value of '" + words[k] + "'");
+                    if (words[k] == "occurs") {
+                        d.count = number(words[k + 1], line);
+                        if (d.count == 0) throw error(line, "non-positive number of items");
+                    } else if (words[k] == "at" || words[k] == "after") {
+                        d.placement = words[k] == "at" ? 1 : 2;
+                        d.ref = words[k + 1];
+                    } else {
+                        throw error(line, "unknown option '" + words[k] + "'");
+                    }
+                }
+
+                if (d.type == SchemaType::GROUP) {
+                    d.children = parseBlock(is, line, true);
+                    if (d.children.empty()) throw error(d.line, "empty group '" + d.name + "'");
+                }
+                decls.push_back(std::move(d));
+            }
+            if (nested) throw error(line, "missing 'end' of group");
+            return decls;
+        }
+
+        /**
+         * Places decls from offset base, with the same rules as Record.
+         * Returns the size of the block, i.e. its largest end offset.
+         */
+        unsigned  place(const std::vector<Decl>& decls, unsigned base, const std::string& prefix) {
+            struct Extent { unsigned start, end; };
+            std::unordered_map<std::string, Extent>  siblings;
+            unsigned  last   = base;
+            unsigned  maxEnd = base;
+
+            for (const Decl& d : decls) {
+                unsigned  start = last;
+                if (d.placement != 0) {
+                    auto  ref = siblings.find(d.ref);
+                    if (ref == siblings.end()) throw error(d.line, "unknown field '" + d.ref + "'");
+                    start = d.placement == 1 ? ref->second.start : ref->second.end;
+                }
+
+                const unsigned  n = d.count > 0 ? d.count : 1;
+                unsigned  itemSize = d.size;
+                for (unsigned k = 0; k < n; ++k) {
+                    const std::string  name  = prefix + d.name + (d.count > 0 ? "[" + std::to_string(k) + "]" : "");
+                    const unsigned     begin = start + k * itemSize;
+                    const size_t       ix    = add({name, d.type, begin, d.size, d.scale, d.order}, d.line);
+                    if (d.type == SchemaType::GROUP) {
+                        itemSize = place(d.children, begin, name + ".") - begin;
+                        fieldList[ix].size = itemSize;
+                    }
+                }
+
+                const unsigned  end = start + n * itemSize;
+                siblings[d.name] = {start, end};
+                last = end;
+                if (maxEnd < end) maxEnd = end;
+            }
+            return maxEnd;
+        }
+
+        size_t  add(const SchemaField& f, int line) {
+            if (!index.emplace(f.name, fieldList.size()).second) throw error(line, "duplicate field '" + f.name + "'");
+            fieldList.push_back(f);
+            return fieldList.size() - 1;
+        }
+
+    public:
+        RecordSchema() = default;
+
+        /**
+         * Parses a schema from its text.
+         */
+        static RecordSchema  parse(const std::string& text) {
+            std::istringstream  is(text);
+            return parse(is);
+        }
+
+        static RecordSchema  parse(std::istream& is) {
+            int  line = 0;
+            std::vector<Decl>  decls = parseBlock(is, line, false);
+            if (decls.empty()) throw SchemaError("No fields defined");
+
+            RecordSchema  schema;
+            schema.recordSize = schema.place(decls, 0, "");
+            return schema;
+        }
+
+        /**
+         * Returns the record size in number of bytes.
+         */
+        unsigned    size()  const { return recordSize; }
+
+        /**
+         * Returns the number of fields, including groups and array items.
+         */
+        size_t      count() const { return fieldList.size(); }
+
+        const std::vector<SchemaField>&  fields() const { return fieldList; }
+
+        const SchemaField&  operator [](size_t ix) const { return fieldList[ix]; }
+
+        /**
+         * Returns the index of a field, given its path.
+         * Intended to be resolved once, up front.
+         */
+        size_t  indexOf(const std::string& name) const {
+            auto  it = index.find(name);
+            if (it == index.end()) throw SchemaError("Unknown field '" + name + "'");
+            return it->second;
+        }
+
+        bool    contains(const std::string& name) const {
+            return index.count(name) > 0;
+        }
+
+        /**
+         * Returns the layout in the same form as Record::layout().
+         */
+        RecordLayout  layout() const {
+            RecordLayout  result;
+            for (const SchemaField& f : fieldList) result.fields.push_back({f.offset, f.size, f.kind()});
+            result.size = recordSize;
+            return result;
+        }
+    };
+
+
+    namespace detail {
+        template<typename Type>
+        Type  loadBinary(const char* p, ByteOrder order) {
+            return order == ByteOrder::BIG
+                 ? Record::EndianConverter<Type, ByteOrder::BIG>::fromStorage(p, sizeof(Type))
+                 : Record::EndianConverter<Type, ByteOrder::LITTLE>::fromStorage(p, sizeof(Type));
+        }
+
+        template<typename Type>
+        void  storeBinary(Type v, char* p, ByteOrder order) {
+            if (order == ByteOrder::BIG) Record::EndianConverter<Type, ByteOrder::BIG>::toStorage(v, p, sizeof(Type));
+            else                         Record::EndianConverter<Type, ByteOrder::LITTLE>::toStorage(v, p, sizeof(Type));
+        }
+
+        inline double  pow10(unsigned n) {
+            double  p = 1;
+            while (n-- > 0) p *= 10;
+            return p;
+        }
+
+        inline SchemaError  notNumeric(const SchemaField& f) {
+            return SchemaError("Not a numeric field '" + f.name + "'");
+        }
+    }
+
+
+    // -----------------------------------------------------
+    // --- class DynamicRecord
+    // -----------------------------------------------------
+    /**
+     * Overlay record with the layout of a RecordSchema.
+     * Fields are accessed by index, and converted with the same converters as Record fields.
+     * The schema must outlive its records.
+     *
+     * <pre>
+     *   RecordSchema  schema = RecordSchema::parse(text);
+     *   const size_t  amount = schema.indexOf("amount");
+     *   DynamicRecord  r(schema, buf, bufsiz);
+     *   for (...; ++r) total += r.integer(amount);
+     * </pre>
+     */
+    class DynamicRecord {
+        const RecordSchema*         schema_;
+        char*                       buffer = nullptr;
+        std::unique_ptr<char[]>     dynamicBuffer;
+
+        const SchemaField&  field(size_t ix) const {
+            return (*schema_)[ix];
+        }
+
+        char*  at(const SchemaField& f) const {
+            return begin() + f.offset;
+        }
+
+    public:
+        explicit DynamicRecord(const RecordSchema& schema) : schema_(&schema) {}
+
+        DynamicRecord(const RecordSchema& schema, char* buf, unsigned bufsiz) : schema_(&schema) {
+            assignStaticBuffer(buf, bufsiz);
+        }
+
+        /**
+         * Copies a record. The copy overlays the same storage, unless the record
+         * owns its storage, in which case the copy gets a buffer of its own.
+         */
+        DynamicRecord(const DynamicRecord& that) : schema_(that.schema_), buffer(that.buffer) {
+            if (that.dynamicBuffer) {
+                allocateDynamicBuffer();
+                std::memcpy(buffer, that.buffer, size());
+            }
+        }
+
+        DynamicRecord(DynamicRecord&& that) noexcept
+                : schema_(that.schema_), buffer(that.buffer), dynamicBuffer(std::move(that.dynamicBuffer)) {
+            if (dynamicBuffer) that.buffer = nullptr;
+        }
+
+        DynamicRecord&  operator =(DynamicRecord that) {
+            schema_ = that.schema_;
+            std::swap(buffer, that.buffer);
+            std::swap(dynamicBuffer, that.dynamicBuffer);
+            return *this;
+        }
+
+        DynamicRecord&  allocateDynamicBuffer() {
+            dynamicBuffer.reset(new char[size()]);
+            std::memset(dynamicBuffer.get(), 0x0, size());
+            buffer = dynamicBuffer.get();
+            return *this;
+        }
+
+        DynamicRecord&  assignStaticBuffer(char* buf, unsigned bufsiz) {
+            if (bufsiz < size()) throw StorageOverflow();
+            dynamicBuffer.reset();
+            buffer = buf;
+            return *this;
+        }
+
+        const RecordSchema&  schema() const { return *schema_; }
+
+        unsigned size() const { return schema_->size(); }
+
+        char* begin() const {
+            if (buffer == nullptr) throw UnInitialized("Buffer is null");
+            return buffer;
+        }
+
+        char* end() const {
+            return begin() + size();
+        }
+
+        /**
+         * Moves <em>n</em> record positions over the underlying buffer.
+         */
+        char* operator +=(int n) {
+            buffer += n * (int)size();
+            return buffer;
+        }
+
+        char* operator ++() { return *this += +1; }
+        char* operator --() { return *this += -1; }
+
+        /**
+         * Returns the storage of field ix, without any copying.
+         */
+        TextView  view(size_t ix) const {
+            const SchemaField&  f = field(ix);
+            return TextView(at(f), f.size);
+        }
+
+        /**
+         * Returns the value of field ix as text.
+         * Blobs are returned in HEX, and numbers are formatted.
+         */
+        std::string  text(size_t ix) const {
+            const SchemaField&  f = field(ix);
+            switch (f.type) {
+                case SchemaType::TEXT:  return Record::TextConverter<>::fromStorage(at(f), f.size);
+                case SchemaType::BLOB:  return Record::HEXConverter::fromStorage(at(f), f.size);
+                case SchemaType::GROUP: return std::string(at(f), f.size);
+                default:                break;
+            }
+            if (f.isIntegral()) return std::to_string(integer(ix));
+
+            char  buf[32];
+            std::snprintf(buf, sizeof(buf), "%.15g", real(ix));
+            return buf;
+        }
+
+        /**
+         * Returns the value of a numeric field ix, as a whole number.
+         * Throws std::overflow_error for a UINT64 value beyond the range of long long.
+         */
+        long long  integer(size_t ix) const {
+            const SchemaField&  f = field(ix);
+            const char*  p = at(f);
+            switch (f.type) {
+                case SchemaType::INTEGER: return Record::DecimalConverter<long long>::fromStorage(p, f.size);
+                case SchemaType::INT8:    return detail::loadBinary<int8_t>(p, f.order);
+                case SchemaType::INT16:   return detail::loadBinary<int16_t>(p, f.order);
+                case SchemaType::INT32:   return detail::loadBinary<int32_t>(p, f.order);
+                case SchemaType::INT64:   return detail::loadBinary<int64_t>(p, f.order);
+                case SchemaType::UINT8:   return detail::loadBinary<uint8_t>(p, f.order);
+                case SchemaType::UINT16:  return detail::loadBinary<uint16_t>(p, f.order);
+                case SchemaType::UINT32:  return detail::loadBinary<uint32_t>(p, f.order);
+                case SchemaType::UINT64: {
+                    const uint64_t  v = detail::loadBinary<uint64_t>(p, f.order);
+                    if (v > static_cast<uint64_t>(std::numeric_limits<long long>::max())) throw std::overflow_error("Number doesn't fit");
+                    return static_cast<long long>(v);
+                }
+                case SchemaType::PACKED:
+                    if (f.scale == 0) return Record::PackedDecimalConverter<long long>::fromStorage(p, f.size);
+                    break;
+                case SchemaType::ZONED:
+                    if (f.scale == 0) return Record::ZonedDecimalConverter<long long>::fromStorage(p, f.size);
+                    break;
+                default:
+                    break;
+            }
+            if (f.isReal()) return static_cast<long long>(real(ix));
+            throw detail::notNumeric(f);
+        }
+
+        /**
+         * Returns the value of a numeric field ix.
+         */
+        double  real(size_t ix) const {
+            const SchemaField&  f = field(ix);
+            const char*  p = at(f);
+            switch (f.type) {
+                case SchemaType::DECIMAL: return Record::DecimalConverter<double>::fromStorage(p, f.size);
+                case SchemaType::FLOAT32: return detail::loadBinary<float>(p, f.order);
+                case SchemaType::FLOAT64: return detail::loadBinary<double>(p, f.order);
+                case SchemaType::UINT64:  return static_cast<double>(detail::loadBinary<uint64_t>(p, f.order));
+                case SchemaType::PACKED:
+                    return Record::PackedDecimalConverter<long long>::fromStorage(p, f.size) / detail::pow10(f.scale);
+                case SchemaType::ZONED:
+                    return Record::ZonedDecimalConverter<long long>::fromStorage(p, f.size) / detail::pow10(f.scale);
+                default:
+                    break;
+            }
+            if (f.isIntegral()) return static_cast<double>(integer(ix));
+            throw detail::notNumeric(f);
+        }
+
+        /**
+         * Sets a numeric field ix.
+         */
+        void  setInteger(size_t ix, long long v) {
+            const SchemaField&  f = field(ix);
+            char*  p = at(f);
+            switch (f.type) {
+                case SchemaType::INTEGER: Record::DecimalConverter<long long>::toStorage(v, p, f.size); return;
+                case SchemaType::INT8:    detail::storeBinary<int8_t>(v, p, f.order);   return;
+                case SchemaType::INT16:   detail::storeBinary<int16_t>(v, p, f.order);  return;
+                case SchemaType::INT32:   detail::storeBinary<int32_t>(v, p, f.order);  return;
+                case SchemaType::INT64:   detail::storeBinary<int64_t>(v, p, f.order);  return;
+                case SchemaType::UINT8:   detail::storeBinary<uint8_t>(v, p, f.order);  return;
+                case SchemaType::UINT16:  detail::storeBinary<uint16_t>(v, p, f.order); return;
+                case SchemaType::UINT32:  detail::storeBinary<uint32_t>(v, p, f.order); return;
+                case SchemaType::UINT64:  detail::storeBinary<uint64_t>(v, p, f.order); return;
+                case SchemaType::PACKED:
+                    if (f.scale == 0) { Record::PackedDecimalConverter<long long>::toStorage(v, p, f.size); return; }
+                    break;
+                case SchemaType::ZONED:
+                    if (f.scale == 0) { Record::ZonedDecimalConverter<long long>::toStorage(v, p, f.size); return; }
+                    break;
+                default:
+                    break;
+            }
+            if (f.isReal()) return setReal(ix, static_cast<double>(v));
+            throw detail::notNumeric(f);
+        }
+
+        /**
+         * Sets a numeric field ix. Whole number fields get the rounded value.
+         */
+        void  setReal(size_t ix, double v) {
+            const SchemaField&  f = field(ix);
+            char*  p = at(f);
+            switch (f.type) {
+                case SchemaType::DECIMAL: Record::DecimalConverter<double>::toStorage(v, p, f.size); return;
+                case SchemaType::FLOAT32: detail::storeBinary<float>(static_cast<float>(v), p, f.order); return;
+                case SchemaType::FLOAT64: detail::storeBinary<double>(v, p, f.order); return;
+                case SchemaType::PACKED:
+                    Record::PackedDecimalConverter<long long>::toStorage(std::llround(v * detail::pow10(f.scale)), p, f.size);
+                    return;
+                case SchemaType::ZONED:
+                    Record::ZonedDecimalConverter<long long>::toStorage(std::llround(v * detail::pow10(f.scale)), p, f.size);
+                    return;
+                default:
+                    break;
+            }
+            if (f.isIntegral()) return setInteger(ix, std::llround(v));
+            throw detail::notNumeric(f);
+        }
+
+        /**
+         * Sets field ix from text. Blobs take HEX, and numbers are parsed.
+         */
+        void  setText(size_t ix, const char* v, size_t n) {
+            const SchemaField&  f = field(ix);
+            switch (f.type) {
+                case SchemaType::TEXT:
+                case SchemaType::GROUP:
+                    Record::TextConverter<>::toStorage(v, n, at(f), f.size);
+                    return;
+                case SchemaType::BLOB:
+                    Record::HEXConverter::toStorage(v, n, at(f), f.size);
+                    return;
+                default:
+                    break;
+            }
+            if (f.isIntegral()) setInteger(ix, Record::DecimalConverter<long long>::fromStorage(v, n));
+            else                setReal(ix, Record::DecimalConverter<double>::fromStorage(v, n));
+        }
+
+        void  setText(size_t ix, const std::string& v) { setText(ix, v.data(), v.size()); }
+        void  setText(size_t ix, const char* v)        { setText(ix, v, std::strlen(v)); }
+        void  setText(size_t ix, const TextView& v)    { setText(ix, v.data(), v.size()); }
+    };
+
+    /**
+     * Writes a dynamic record binary, to a stream.
+     */
+    inline std::ostream&  operator <<(std::ostream& os, const DynamicRecord& rec) {
+        os.write(rec.begin(), rec.size());
+        return os;
+    }
+
+    /**
+     * Reads a dynamic record binary from a stream, directly into its storage.
+     */
+    inline std::istream&  operator >>(std::istream& is, DynamicRecord& rec) {
+        is.read(rec.begin(), rec.size());
+        return is;
+    }
+
+}
+
+#endif /* DYNAMIC_RECORD_HPP_ */
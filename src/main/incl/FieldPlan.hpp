@@ -0,0 +1,294 @@
+/*
+ * FieldPlan.hpp
+ *
+ *  Precompiled decoding and encoding of schema-defined records.
+ */
+
+#ifndef FIELD_PLAN_HPP_
+#define FIELD_PLAN_HPP_
+
+#include <tuple>
+#include "DynamicRecord.hpp"
+
+namespace overlay_record {
+
+    /**
+     * One operation of a FieldPlan: converts the field at <em>offset</em> of a record,
+     * from or to the member at <em>member</em> of the target object.
+     */
+    struct PlanStep {
+        typedef void (*Decode)(const char* field, const PlanStep& step, char* member);
+        typedef void (*Encode)(const char* member, const PlanStep& step, char* field);
+
+        unsigned    offset;
+        unsigned    size;
+        size_t      member;
+        double      factor;     //10^scale of PACKED and ZONED
+        Decode      decode;
+        Encode      encode;
+    };
+
+    namespace detail {
+        /**
+         * Conversion kernels between the storage of a field and a member of type Member.
+         * Each kernel is specialized for one storage type and byte order, so a step does no dispatch of its own.
+         */
+        template<typename Member, bool numeric = std::is_arithmetic<Member>::value>
+        struct PlanKernels;
+
+        template<typename Member>
+        struct PlanKernels<Member, true> {
+            static Member&  member(char* m) { return *reinterpret_cast<Member*>(m); }
+            static Member   member(const char* m) { return *reinterpret_cast<const Member*>(m); }
+
+            template<typename Type, ByteOrder ORDER>
+            static void decodeBinary(const char* f, const PlanStep&, char* m) {
+                member(m) = static_cast<Member>(Record::EndianConverter<Type, ORDER>::fromStorage(f, sizeof(Type)));
+            }
+            template<typename Type, ByteOrder ORDER>
+            static void encodeBinary(const char* m, const PlanStep&, char* f) {
+                Record::EndianConverter<Type, ORDER>::toStorage(static_cast<Type>(member(m)), f, sizeof(Type));
+            }
+
+            template<typename Type>
+            static void decodeText(const char* f, const PlanStep& s, char* m) {
+                member(m) = static_cast<Member>(Record::DecimalConverter<Type>::fromStorage(f, s.size));
+            }
+            template<typename Type>
+            static void encodeText(const char* m, const PlanStep& s, char* f) {
+                Record::DecimalConverter<Type>::toStorage(static_cast<Type>(member(m)), f, s.size);
+            }
+
+            template<typename Converter>
+            static void decodeScaled(const char* f, const PlanStep& s, char* m) {
+                const long long  v = Converter::fromStorage(f, s.size);
+                member(m) = s.factor == 1 ? static_cast<Member>(v) : static_cast<Member>(v / s.factor);
+            }
+            template<typename Converter>
+            static void encodeScaled(const char* m, const PlanStep& s, char* f) {
+                const long long  v = std::is_integral<Member>::value && s.factor == 1
+                                   ? static_cast<long long>(member(m))
+                                   : std::llround(static_cast<double>(member(m)) * s.factor);
+                Converter::toStorage(v, f, s.size);
+            }
+
+            template<typename Type>
+            static void select(const SchemaField& f, PlanStep& step) {
+                if (f.order == ByteOrder::BIG) {
+                    step.decode = &decodeBinary<Type, ByteOrder::BIG>;
+                    step.encode = &encodeBinary<Type, ByteOrder::BIG>;
+                } else {
+                    step.decode = &decodeBinary<Type, ByteOrder::LITTLE>;
+                    step.encode = &encodeBinary<Type, ByteOrder::LITTLE>;
+                }
+            }
+
+            static bool select(const SchemaField& f, PlanStep& step) {
+                switch (f.type) {
+                    case SchemaType::INT8:    select<int8_t>(f, step);   return true;
+                    case SchemaType::INT16:   select<int16_t>(f, step);  return true;
+                    case SchemaType::INT32:   select<int32_t>(f, step);  return true;
+                    case SchemaType::INT64:   select<int64_t>(f, step);  return true;
+                    case SchemaType::UINT8:   select<uint8_t>(f, step);  return true;
+                    case SchemaType::UINT16:  select<uint16_t>(f, step); return true;
+                    case SchemaType::UINT32:  select<uint32_t>(f, step); return true;
+                    case SchemaType::UINT64:  select<uint64_t>(f, step); return true;
+                    case SchemaType::FLOAT32: select<float>(f, step);    return true;
+                    case SchemaType::FLOAT64: select<double>(f, step);   return true;
+                    case SchemaType::INTEGER:
+                        step.decode = &decodeText<long long>;
+                        step.encode = &encodeText<long long>;
+                        return true;
+                    case SchemaType::DECIMAL:
+                        step.decode = &decodeText<double>;
+                        step.encode = &encodeText<double>;
+                        return true;
+                    case SchemaType::PACKED:
+                        step.decode = &decodeScaled<Record::PackedDecimalConverter<long long>>;
+                        step.encode = &encodeScaled<Record::PackedDecimalConverter<long long>>;
+                        return true;
+                    case SchemaType::ZONED:
+                        step.decode = &decodeScaled<Record::ZonedDecimalConverter<long long>>;
+                        step.encode = &encodeScaled<Record::ZonedDecimalConverter<long long>>;
+                        return true;
+                    default:
+                        return false;
+                }
+            }
+        };
+
+        template<>
+        struct PlanKernels<std::string, false> {
+            static std::string&  member(char* m) { return *reinterpret_cast<std::string*>(m); }
+            static const std::string&  member(const char* m) { return *reinterpret_cast<const std::string*>(m); }
+
+            static void decodeText(const char* f, const PlanStep& s, char* m) {
+                Record::TextConverter<>::fromStorage(f, s.size, member(m));
+            }
+            static void encodeText(const char* m, const PlanStep& s, char* f) {
+                Record::TextConverter<>::toStorage(member(m), f, s.size);
+            }
+
+            static void decodeHEX(const char* f, const PlanStep& s, char* m) {
+                std::string&  v = member(m);
+                v.resize(2 * s.size);
+                Record::HEXConverter::encode(f, s.size, &v[0]);
+            }
+            static void encodeHEX(const char* m, const PlanStep& s, char* f) {
+                Record::HEXConverter::toStorage(member(m), f, s.size);
+            }
+
+            static bool select(const SchemaField& f, PlanStep& step) {
+                switch (f.type) {
+                    case SchemaType::TEXT:
+                    case SchemaType::GROUP:
+                        step.decode = &decodeText;
+                        step.encode = &encodeText;
+                        return true;
+                    case SchemaType::BLOB:
+                        step.decode = &decodeHEX;
+                        step.encode = &encodeHEX;
+                        return true;
+                    default:
+                        return false;
+                }
+            }
+        };
+
+        template<>
+        struct PlanKernels<TextView, false> {
+            static void decodeView(const char* f, const PlanStep& s, char* m) {
+                *reinterpret_cast<TextView*>(m) = TextView(f, s.size);
+            }
+            static void encodeView(const char* m, const PlanStep& s, char* f) {
+                const TextView&  v = *reinterpret_cast<const TextView*>(m);
+                if (v.data() != f) Record::TextConverter<>::toStorage(v.data(), v.size(), f, s.size);
+            }
+
+            static bool select(const SchemaField&, PlanStep& step) {
+                step.decode = &decodeView;
+                step.encode = &encodeView;
+                return true;
+            }
+        };
+    }
+
+
+    // -----------------------------------------------------
+    // --- class FieldPlan
+    // -----------------------------------------------------
+    /**
+     * Decodes records of a RecordSchema into objects of Target, and encodes them back,
+     * as one loop over precompiled steps of (offset, size, kernel).
+     * The kernels are selected once, when binding a field to a member, by the field's
+     * storage type and the member's type, so no per-value dispatch remains.
+     *
+     * Members can be arithmetic types (numeric fields), std::string (text, group and, in HEX, blob fields)
+     * or TextView (any field, refers to the record's storage).
+     * Target can be a struct, bound by member pointers, or a std::tuple, bound by element index.
+     *
+     * <pre>
+     *   struct Row { std::string id; long long amount; double rate; };
+     *   FieldPlan<Row>  plan(schema);
+     *   plan.bind("id", &Row::id).bind("amount", &Row::amount).bind("rate", &Row::rate);
+     *
+     *   Row  row;
+     *   plan.decode(record, row);
+     * </pre>
+     */
+    template<typename Target>
+    class FieldPlan {
+        const RecordSchema*     schema_;
+        std::vector<PlanStep>   plan;
+
+        typedef typename std::aligned_storage<sizeof(Target), alignof(Target)>::type  Storage;
+
+        template<typename Member>
+        FieldPlan&  add(const std::string& name, size_t member) {
+            const SchemaField&  f = (*schema_)[schema_->indexOf(name)];
+
+            PlanStep  step;
+            step.offset = f.offset;
+            step.size   = f.size;
+            step.member = member;
+            step.factor = detail::pow10(f.scale);
+            if (!detail::PlanKernels<Member>::select(f, step)) {
+                throw SchemaError("Incompatible member type for field '" + name + "'");
+            }
+            plan.push_back(step);
+            return *this;
+        }
+
+    public:
+        explicit FieldPlan(const RecordSchema& schema) : schema_(&schema) {}
+
+        /**
+         * Binds field <em>name</em> to a member of Target.
+         */
+        template<typename Member>
+        FieldPlan&  bind(const std::string& name, Member Target::* member) {
+            Storage  storage;
+            const Target*  target = reinterpret_cast<const Target*>(&storage);
+            const size_t   offset = reinterpret_cast<const char*>(&(target->*member)) - reinterpret_cast<const char*>(target);
+            return add<Member>(name, offset);
+        }
+
+        /**
+         * Binds field <em>name</em> to element I, when Target is a std::tuple.
+         */
+        template<size_t I>
+        FieldPlan&  bind(const std::string& name) {
+            typedef typename std::tuple_element<I, Target>::type  Member;
+            Storage  storage;
+            Target&  target = *reinterpret_cast<Target*>(&storage);
+            const size_t  offset = reinterpret_cast<const char*>(&std::get<I>(target)) - reinterpret_cast<const char*>(&target);
+            return add<Member>(name, offset);
+        }
+
+        const RecordSchema&             schema() const { return *schema_; }
+        const std::vector<PlanStep>&    steps()  const { return plan; }
+
+        /**
+         * Decodes the bound fields of one record.
+         */
+        void  decode(const char* record, Target& target) const {
+            char*  object = reinterpret_cast<char*>(&target);
+            for (const PlanStep& s : plan) s.decode(record + s.offset, s, object + s.member);
+        }
+
+        void  decode(const DynamicRecord& record, Target& target) const {
+            decode(record.begin(), target);
+        }
+
+        /**
+         * Decodes <em>n</em> consecutive records into out[0..n).
+         */
+        void  decode(const char* records, size_t n, Target* out) const {
+            const unsigned  stride = schema_->size();
+            for (size_t k = 0; k < n; ++k, records += stride) decode(records, out[k]);
+        }
+
+        /**
+         * Encodes the bound members into one record. Unbound fields are left as is.
+         */
+        void  encode(const Target& source, char* record) const {
+            const char*  object = reinterpret_cast<const char*>(&source);
+            for (const PlanStep& s : plan) s.encode(object + s.member, s, record + s.offset);
+        }
+
+        void  encode(const Target& source, DynamicRecord& record) const {
+            encode(source, record.begin());
+        }
+
+        /**
+         * Encodes in[0..n) into <em>n</em> consecutive records.
+         */
+        void  encode(const Target* in, size_t n, char* records) const {
+            const unsigned  stride = schema_->size();
+            for (size_t k = 0; k < n; ++k, records += stride) encode(in[k], records);
+        }
+    };
+
+}
+
+#endif /* FIELD_PLAN_HPP_ */
@@ -0,0 +1,196 @@
+/*
+ * MappedRecordFile.hpp
+ *
+ *  Memory-mapped file of fixed-size records.
+ */
+
+#ifndef MAPPED_RECORD_FILE_HPP_
+#define MAPPED_RECORD_FILE_HPP_
+
+#include <string>
+#include <cerrno>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "RecordView.hpp"
+
+namespace overlay_record {
+
+    /**
+     * Access mode of a mapped file.
+     */
+    enum class MapMode { READ_ONLY, READ_WRITE };
+
+    /**
+     * Expected access pattern, passed on to madvise().
+     */
+    enum class MapAdvice { NORMAL, SEQUENTIAL, RANDOM };
+
+    // -----------------------------------------------------
+    // --- class MappedRecordFile
+    // -----------------------------------------------------
+    /**
+     * A file of fixed-size records, mapped into memory and
+     * exposed as a range of overlays, without any copying.
+     * A trailing partial record is ignored.
+     * The pages of a READ_ONLY file are not writable, hence it requires a const RecordType,
+     * which is also what selects READ_ONLY by default.
+     *
+     * <pre>
+     *   MappedRecordFile<const R>  file("data.bin");
+     *   for (const R& r : file) sum += r.amount;
+     * </pre>
+     */
+    template<typename RecordType>
+    class MappedRecordFile {
+        typedef typename detail::RangeTraits<RecordType>::Pointer   Pointer;
+
+        std::string path;
+        int         fd      = -1;
+        char*       storage = nullptr;
+        size_t      length  = 0;
+        MapMode     mode    = MapMode::READ_ONLY;
+        RecordView<RecordType>  view;
+
+        static std::system_error  failure(const std::string& what, const std::string& path) {
+            return std::system_error(errno, std::generic_category(), what + " " + path);
+        }
+
+        void map(MapAdvice advice, bool hugePages) {
+            if (length > 0) {
+                int   prot = PROT_READ | (mode == MapMode::READ_WRITE ? PROT_WRITE : 0);
+                void* addr = ::mmap(nullptr, length, prot, MAP_SHARED, fd, 0);
+                if (addr == MAP_FAILED) {
+                    std::system_error  err = failure("mmap", path);
+                    ::close(fd);
+                    throw err;
+                }
+                storage = static_cast<char*>(addr);
+                advise(advice);
+#ifdef MADV_HUGEPAGE
+                if (hugePages) ::madvise(storage, length, MADV_HUGEPAGE);
+#else
+                (void) hugePages;
+#endif
+            }
+            view = RecordView<RecordType>(storage, length);
+        }
+
+        void unmap() {
+            if (storage != nullptr) ::munmap(storage, length);
+            if (fd >= 0) ::close(fd);
+            fd      = -1;
+            storage = nullptr;
+            length  = 0;
+        }
+
+    public:
+        typedef typename RecordView<RecordType>::iterator   iterator;
+        typedef RecordType                                  reference;
+
+        /**
+         * Maps an existing file.
+         * @param path      file name
+         * @param mode      READ_ONLY (default for a const RecordType) or READ_WRITE (default otherwise)
+         * @param advice    expected access pattern
+         * @param hugePages if true, ask for transparent huge pages (where supported)
+         * @throws std::invalid_argument if mode is READ_ONLY and RecordType is not const
+         */
+        MappedRecordFile(const std::string& path,
+                         MapMode mode = std::is_const<RecordType>::value ? MapMode::READ_ONLY : MapMode::READ_WRITE,
+                         MapAdvice advice = MapAdvice::SEQUENTIAL, bool hugePages = false)
+                : path(path), mode(mode) {
+            if (mode == MapMode::READ_ONLY && !std::is_const<RecordType>::value) {
+                throw std::invalid_argument("READ_ONLY mapping requires a const record type: " + path);
+            }
+            fd = ::open(path.c_str(), mode == MapMode::READ_WRITE ? O_RDWR : O_RDONLY);
+            if (fd < 0) throw failure("open", path);
+
+            struct stat  st;
+            if (::fstat(fd, &st) < 0) {
+                std::system_error  err = failure("fstat", path);
+                ::close(fd);
+                throw err;
+            }
+            length = st.st_size;
+            map(advice, hugePages);
+        }
+
+        /**
+         * Creates (or truncates) a file with room for <em>numRecords</em> zero-filled records,
+         * and maps it READ_WRITE.
+         */
+        MappedRecordFile(const std::string& path, size_t numRecords,
+                         MapAdvice advice = MapAdvice::SEQUENTIAL, bool hugePages = false)
+                : path(path), mode(MapMode::READ_WRITE) {
+            fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+            if (fd < 0) throw failure("open", path);
+
+            length = numRecords * Record::layout<RecordType>().size;
+            if (::ftruncate(fd, length) < 0) {
+                std::system_error  err = failure("ftruncate", path);
+                ::close(fd);
+                throw err;
+            }
+            map(advice, hugePages);
+        }
+
+        MappedRecordFile(const MappedRecordFile&) = delete;
+        MappedRecordFile&  operator =(const MappedRecordFile&) = delete;
+
+        MappedRecordFile(MappedRecordFile&& that)
+                : path(std::move(that.path)), fd(that.fd), storage(that.storage), length(that.length), mode(that.mode), view(that.view) {
+            that.fd      = -1;
+            that.storage = nullptr;
+            that.length  = 0;
+            that.view    = RecordView<RecordType>();
+        }
+
+        ~MappedRecordFile() {
+            unmap();
+        }
+
+        /**
+         * Changes the expected access pattern.
+         */
+        void advise(MapAdvice advice) {
+            if (storage == nullptr) return;
+            int  flag = MADV_NORMAL;
+            if (advice == MapAdvice::SEQUENTIAL) flag = MADV_SEQUENTIAL;
+            if (advice == MapAdvice::RANDOM)     flag = MADV_RANDOM;
+            ::madvise(storage, length, flag);
+        }
+
+        /**
+         * Flushes modified pages to the file.
+         */
+        void sync() {
+            if (storage != nullptr && mode == MapMode::READ_WRITE) {
+                if (::msync(storage, length, MS_SYNC) < 0) throw failure("msync", path);
+            }
+        }
+
+        /**
+         * Returns the records as a view.
+         */
+        const RecordView<RecordType>&   records() const { return view; }
+
+        size_t      size()       const { return view.size(); }
+        bool        empty()      const { return view.empty(); }
+        unsigned    recordSize() const { return view.recordSize(); }
+        Pointer     data()       const { return storage; }
+        size_t      fileSize()   const { return length; }
+
+        iterator    begin() const { return view.begin(); }
+        iterator    end()   const { return view.end(); }
+        reference   operator [](size_t ix) const { return view[ix]; }
+        reference   at(size_t ix) const { return view.at(ix); }
+    };
+
+}
+
+#endif /* MAPPED_RECORD_FILE_HPP_ */
@@ -0,0 +1,238 @@
+/*
+ * Parallel.hpp
+ *
+ *  Parallel scanning of record ranges.
+ */
+
+#ifndef PARALLEL_HPP_
+#define PARALLEL_HPP_
+
+#include <atomic>
+#include <thread>
+#include <exception>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+#include "RecordView.hpp"
+
+namespace overlay_record {
+
+    /**
+     * Tuning of the parallel operations.
+     */
+    struct ParallelOptions {
+        unsigned    threads    = 0;             //0 means std::thread::hardware_concurrency()
+        size_t      chunkBytes = 256 * 1024;    //approximate amount of records per unit of work
+
+        ParallelOptions() = default;
+        ParallelOptions(unsigned threads, size_t chunkBytes = 256 * 1024)
+                : threads(threads), chunkBytes(chunkBytes) {}
+    };
+
+    namespace detail {
+        /**
+         * Hands out chunk numbers to workers. Each worker starts with a contiguous
+         * share of the chunks, and when done, steals chunks from the other shares.
+         */
+        class ChunkScheduler {
+            /**
+             * One share per cache line, as workers update theirs concurrently.
+             */
+            struct alignas(64) Share {
+                std::atomic<size_t>   next;
+                size_t                end;
+            };
+
+            std::unique_ptr<char[]>   memory;      //operator new[] need not align beyond max_align_t
+            Share*                    shares;
+            unsigned                  numWorkers;
+
+        public:
+            ChunkScheduler(size_t numChunks, unsigned numWorkers)
+                    : memory(new char[(numWorkers + 1) * sizeof(Share)]), numWorkers(numWorkers) {
+                void*   storage = memory.get();
+                size_t  space   = (numWorkers + 1) * sizeof(Share);
+                shares = static_cast<Share*>(std::align(alignof(Share), numWorkers * sizeof(Share), storage, space));
+                for (unsigned w = 0; w < numWorkers; ++w) {
+                    new (&shares[w]) Share();
+                    shares[w].next.store(numChunks * w / numWorkers);
+                    shares[w].end = numChunks * (w + 1) / numWorkers;
+                }
+            }
+
+            /**
+             * Assigns the next chunk for worker w. Returns false when all chunks are taken.
+             */
+            bool next(unsigned w, size_t& chunk) {
+                for (unsigned k = 0; k < numWorkers; ++k) {
+                    Share&  share = shares[(w + k) % numWorkers];
+                    if (share.next.load(std::memory_order_relaxed) >= share.end) continue;
+                    chunk = share.next.fetch_add(1, std::memory_order_relaxed);
+                    if (chunk < share.end) return true;
+                }
+                return false;
+            }
+        };
+
+        /**
+         * Threads, which are joined when it goes out of scope. Hence, when starting a thread throws,
+         * the threads already started are joined, instead of destroyed while joinable, which terminates.
+         */
+        class JoiningThreads {
+            std::vector<std::thread>  threads;
+
+        public:
+            JoiningThreads() = default;
+            JoiningThreads(const JoiningThreads&) = delete;
+            JoiningThreads&  operator =(const JoiningThreads&) = delete;
+
+            ~JoiningThreads() {
+                join();
+            }
+
+            template<typename Function, typename... Args>
+            void start(Function&& fn, Args&&... args) {
+                threads.emplace_back(std::forward<Function>(fn), std::forward<Args>(args)...);
+            }
+
+            void join() {
+                for (auto& t : threads) if (t.joinable()) t.join();
+            }
+        };
+
+        /**
+         * Splitting of a view into chunks, and the number of workers to process them.
+         */
+        struct ChunkPlan {
+            size_t      chunkRecords;
+            size_t      numChunks;
+            unsigned    numWorkers;
+
+            ChunkPlan(size_t numRecords, unsigned recordSize, const ParallelOptions& options) {
+                chunkRecords = options.chunkBytes / (recordSize > 0 ? recordSize : 1);
+                if (chunkRecords == 0) chunkRecords = 1;
+                numChunks = (numRecords + chunkRecords - 1) / chunkRecords;
+
+                numWorkers = options.threads != 0 ? options.threads : std::thread::hardware_concurrency();
+                if (numWorkers == 0) numWorkers = 1;
+                if (numWorkers > numChunks) numWorkers = numChunks > 0 ? numChunks : 1;
+            }
+        };
+
+        /**
+         * Runs body(worker, task) for the tasks 0..numTasks-1, on the calling thread plus additional threads.
+         * The first exception thrown by body stops the work, and is rethrown.
+         */
+        template<typename Body>
+        void runTasks(size_t numTasks, unsigned numWorkers, Body body) {
+            ChunkScheduler      scheduler(numTasks, numWorkers);
+            std::atomic<bool>   failed(false);
+            std::exception_ptr  error;
+            std::atomic_flag    errorLock = ATOMIC_FLAG_INIT;
+
+            auto  worker = [&](unsigned w) {
+                try {
+                    size_t  task;
+                    while (!failed.load(std::memory_order_relaxed) && scheduler.next(w, task)) {
+                        body(w, task);
+                    }
+                } catch (...) {
+                    if (!errorLock.test_and_set()) error = std::current_exception();
+                    failed = true;
+                }
+            };
+
+            JoiningThreads  threads;
+            try {
+                for (unsigned w = 1; w < numWorkers; ++w) threads.start(worker, w);
+            } catch (...) {
+                failed = true;
+                throw;
+            }
+            worker(0);
+            threads.join();
+
+            if (error) std::rethrow_exception(error);
+        }
+
+        /**
+         * Runs body(worker, chunk) over the chunks of view, as above.
+         */
+        template<typename RecordType, typename Body>
+        void runChunks(const RecordView<RecordType>& view, const ChunkPlan& plan, Body body) {
+            const size_t  chunkRecords = plan.chunkRecords;
+            runTasks(plan.numChunks, plan.numWorkers, [&](unsigned w, size_t chunk) {
+                body(w, view.subview(chunk * chunkRecords, chunkRecords));
+            });
+        }
+
+        /**
+         * Invokes fn(record) for every record of chunk, sliding one overlay over them
+         * rather than creating one per record.
+         */
+        template<typename RecordType, typename Function>
+        void slideOver(const RecordView<RecordType>& chunk, Function fn) {
+            typename RangeTraits<RecordType>::Sliding  overlay;
+            const char*  end = chunk.data() + chunk.size() * chunk.recordSize();
+            for (const char* pos = chunk.data(); pos != end; pos += chunk.recordSize()) {
+                RecordType&  r = overlay.slideTo(pos);
+                fn(r);
+            }
+        }
+    }
+
+    // -----------------------------------------------------
+    // --- Parallel operations
+    // -----------------------------------------------------
+    /**
+     * Invokes fn(record) for every record in view, in parallel.
+     * The records are split into chunks of about options.chunkBytes, and each worker
+     * thread uses overlays of its own, so fn only needs to be safe for concurrent
+     * invocation on different records. Idle workers steal chunks from busy ones.
+     *
+     * <pre>
+     *   std::atomic<long>  n(0);
+     *   parallelForEach(file.records(), [&](R& r){ if (r.status == "OK") ++n; });
+     * </pre>
+     */
+    template<typename RecordType, typename Function>
+    void parallelForEach(const RecordView<RecordType>& view, Function fn, const ParallelOptions& options = ParallelOptions()) {
+        const detail::ChunkPlan  plan(view.size(), view.recordSize(), options);
+        detail::runChunks(view, plan, [&](unsigned, const RecordView<RecordType>& chunk) {
+            detail::slideOver(chunk, fn);
+        });
+    }
+
+    /**
+     * Folds all records in view into one value, in parallel.
+     * Each worker starts from <em>identity</em> and folds its records with
+     * accumulate(value, record), and the partial results are folded with combine(value, value).
+     * As workers steal chunks, combine must be associative and commutative.
+     *
+     * <pre>
+     *   long  total = parallelReduce(view, 0L,
+     *                    [](long sum, R& r){ return sum + r.amount; },
+     *                    [](long a, long b){ return a + b; });
+     * </pre>
+     */
+    template<typename RecordType, typename Value, typename Accumulate, typename Combine>
+    Value parallelReduce(const RecordView<RecordType>& view, Value identity, Accumulate accumulate, Combine combine,
+                         const ParallelOptions& options = ParallelOptions()) {
+        const detail::ChunkPlan  plan(view.size(), view.recordSize(), options);
+
+        std::vector<Value>  partial(plan.numWorkers, identity);
+        detail::runChunks(view, plan, [&](unsigned w, const RecordView<RecordType>& chunk) {
+            Value  value = std::move(partial[w]);
+            detail::slideOver(chunk, [&](RecordType& r) { value = accumulate(std::move(value), r); });
+            partial[w] = std::move(value);
+        });
+
+        Value  result = std::move(partial[0]);
+        for (unsigned w = 1; w < plan.numWorkers; ++w) result = combine(std::move(result), std::move(partial[w]));
+        return result;
+    }
+
+}
+
+#endif /* PARALLEL_HPP_ */
@@ -18,6 +18,14 @@
 #include <stdexcept>
 #include <type_traits>
 #include <cstring>
+#include <cstdint>
+#include <cstdlib>
+#include <cstdio>
+#include <cmath>
+#include <limits>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 namespace overlay_record {
 
@@ -50,6 +58,13 @@ namespace overlay_record {
         UnInitialized(std::string msg) : std::logic_error(msg) {}
     };
 
+    /**
+     * Exception thrown when writing to a record over read-only storage.
+     */
+    struct ReadOnlyStorage : public std::logic_error {
+        ReadOnlyStorage() : std::logic_error("Storage is read-only") {}
+    };
+
 
     // -----------------------------------------------------
     // --- Type Aliases
@@ -57,6 +72,66 @@ namespace overlay_record {
     typedef unsigned      FieldSize;
 
 
+    // -----------------------------------------------------
+    // --- class TextView
+    // -----------------------------------------------------
+    /**
+     * Non-owning view of a sequence of characters, such as the storage of a text field.
+     * Reading a field as a view involves no allocation and no copying.
+     */
+    class TextView {
+        const char*     first  = nullptr;
+        size_t          length = 0;
+
+    public:
+        TextView() = default;
+        TextView(const char* s, size_t n) : first(s), length(n) {}
+        TextView(const char* s) : first(s), length(std::strlen(s)) {}
+        TextView(const std::string& s) : first(s.data()), length(s.size()) {}
+
+        const char*     data()  const { return first; }
+        size_t          size()  const { return length; }
+        bool            empty() const { return length == 0; }
+        const char*     begin() const { return first; }
+        const char*     end()   const { return first + length; }
+        char            operator [](size_t ix) const { return first[ix]; }
+
+        /**
+         * Returns a copy as a string.
+         */
+        std::string     str() const { return std::string(first, length); }
+
+        /**
+         * Returns the view without trailing pad and NUL characters.
+         */
+        TextView        trimmed(char pad = ' ') const {
+            size_t  n = length;
+            while (n > 0 && (first[n - 1] == pad || first[n - 1] == '\0')) --n;
+            return TextView(first, n);
+        }
+
+        bool            startsWith(const TextView& prefix) const {
+            return prefix.length <= length && std::memcmp(first, prefix.first, prefix.length) == 0;
+        }
+
+        int             compare(const TextView& that) const {
+            int  result = std::memcmp(first, that.first, std::min(length, that.length));
+            if (result != 0) return result;
+            return length < that.length ? -1 : (length > that.length ? +1 : 0);
+        }
+
+        friend bool operator ==(const TextView& a, const TextView& b) {
+            return a.length == b.length && std::memcmp(a.first, b.first, a.length) == 0;
+        }
+        friend bool operator !=(const TextView& a, const TextView& b) { return !(a == b); }
+        friend bool operator < (const TextView& a, const TextView& b) { return a.compare(b) < 0; }
+
+        friend std::ostream&  operator <<(std::ostream& os, const TextView& v) {
+            return os.write(v.first, v.length);
+        }
+    };
+
+
     // -----------------------------------------------------
     // --- class FieldBase
     // -----------------------------------------------------
@@ -69,6 +144,19 @@ namespace overlay_record {
 
         FieldBase() = default;
 
+        /**
+         * When copied as part of a record, the copy belongs to the new record.
+         * Otherwise, it refers to the same record as the original.
+         */
+        FieldBase(const FieldBase& that) noexcept;
+
+        /**
+         * Assignment keeps the owning record.
+         */
+        FieldBase&  operator =(const FieldBase&) {
+            return *this;
+        }
+
         unsigned    startOffset() const {
             return fieldOffset;
         }
@@ -77,6 +165,85 @@ namespace overlay_record {
             return startOffset() + fieldSize;
         }
 
+        /**
+         * Returns the offset within the outermost record, which differs from
+         * startOffset() for a field of an embedded record.
+         */
+        unsigned    outerOffset() const;
+
+    };
+
+    // -----------------------------------------------------
+    // --- Decimal text options
+    // -----------------------------------------------------
+    /**
+     * Placement of a number formatted into a text field.
+     * LEFT: digits followed by padding, RIGHT: padding followed by digits,
+     * ZERO_FILL: sign and leading zeros followed by digits.
+     */
+    enum class NumberAlign { LEFT, RIGHT, ZERO_FILL };
+
+    /**
+     * What to do when a number doesn't fit its field or type.
+     * SATURATE: use the largest (smallest) representable value, THROW: throw std::overflow_error.
+     */
+    enum class OverflowPolicy { SATURATE, THROW };
+
+
+    /**
+     * Byte order of a binary field.
+     */
+    enum class ByteOrder { LITTLE, BIG };
+
+    /**
+     * Byte order of the host.
+     */
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    const ByteOrder  HOST_BYTE_ORDER = ByteOrder::BIG;
+#else
+    const ByteOrder  HOST_BYTE_ORDER = ByteOrder::LITTLE;
+#endif
+
+
+    // -----------------------------------------------------
+    // --- class RecordLayout
+    // -----------------------------------------------------
+    /**
+     * Kind of converter used by a field.
+     */
+    enum class FieldKind { TEXT, NUMERIC, BINARY, HEX, EMBED, CUSTOM, PACKED_DECIMAL, ZONED_DECIMAL };
+
+    /**
+     * Maps a converter type to its FieldKind.
+     * Specialized for the pre-defined converters, below class Record.
+     */
+    template<typename Converter>
+    struct ConverterKind {
+        static const FieldKind value = FieldKind::CUSTOM;
+    };
+
+    /**
+     * Enables the character overloads of a field for text and HEX converters only,
+     * so that other fields keep taking plain literals, such as <code>rec.amount = 0</code>.
+     */
+    template<typename Converter, typename T = void>
+    using IfCharacterConverter = typename std::enable_if<ConverterKind<Converter>::value == FieldKind::TEXT
+                                                      || ConverterKind<Converter>::value == FieldKind::HEX, T>::type;
+
+    /**
+     * Description of the layout of a Record subclass.
+     * Computed once per type by Record::layout<RecordType>(), and shared by all users.
+     * Array fields are described item by item, embedded records as one field.
+     */
+    struct RecordLayout {
+        struct FieldInfo {
+            unsigned    offset;
+            unsigned    size;
+            FieldKind   kind;
+        };
+
+        std::vector<FieldInfo>  fields;
+        unsigned                size = 0;
     };
 
     // -----------------------------------------------------
@@ -88,70 +255,339 @@ namespace overlay_record {
      * plus a constructor which provides the storage.
      */
     class Record {
-        std::vector<FieldBase*>   fields;
+        unsigned    numFields = 0;
+        unsigned    lastOffset = 0;
         char*       buffer = nullptr;
         unsigned    bufferSize = 0;
         char*       dynamicBuffer = nullptr;
+        Record*     firstEmbedded = nullptr;    //embedded records, bound along with this one
+        Record*     nextEmbedded = nullptr;
+        Record*     enclosing = nullptr;        //record this one is embedded in, if any
+        unsigned    embeddedOffset = 0;
+        bool        readOnly = false;          //refuses writable access to its storage
+
+        /**
+         * Target of Record::layout() while it constructs its prototype record.
+         */
+        struct LayoutCapture {
+            RecordLayout*   layout = nullptr;
+            const Record*   owner  = nullptr;
+        };
+
+        static LayoutCapture&   layoutCapture() {
+            static thread_local LayoutCapture  capture;
+            return capture;
+        }
+
+        /**
+         * The record being copied (or moved) from, and the one being constructed,
+         * while the fields of a record are copied.
+         */
+        struct CopyContext {
+            const Record*   source;
+            Record*         target;
+        };
+
+        static CopyContext&     copyContext() {
+            static thread_local CopyContext  context;
+            return context;
+        }
+
+        friend struct FieldBase;
+
+        /**
+         * Registers a field in O(1), without any allocation.
+         */
+        void addField(const FieldBase* f, FieldKind kind) {
+            ++numFields;
+            lastOffset = f->endOffset();
+            if (bufferSize < lastOffset) bufferSize = lastOffset;
+
+            LayoutCapture&  capture = layoutCapture();
+            if (capture.owner == this) {
+                capture.layout->fields.push_back({f->fieldOffset, f->fieldSize, kind});
+            }
+        }
+
+        /**
+         * Registers an embedded record, which is bound at the given offset of this record.
+         */
+        void addEmbedded(Record* embedded, unsigned offset) {
+            embedded->embeddedOffset = offset;
+            embedded->enclosing      = this;
+            embedded->nextEmbedded   = firstEmbedded;
+            firstEmbedded            = embedded;
+            if (buffer != nullptr) embedded->bind(buffer + offset);
+        }
+
+        /**
+         * Sets the storage of this record and of all its embedded records.
+         * Binding eagerly here, keeps all read access free of side effects.
+         */
+        void bind(char* buf) {
+            buffer = buf;
+            if (firstEmbedded != nullptr) bindEmbedded(buf);
+        }
+
+        void bindEmbedded(char* buf) {
+            for (Record* e = firstEmbedded; e != nullptr; e = e->nextEmbedded) {
+                e->bind(buf != nullptr ? buf + e->embeddedOffset : nullptr);
+            }
+        }
+
+        void setReadOnly(bool flag) {
+            readOnly = flag;
+            for (Record* e = firstEmbedded; e != nullptr; e = e->nextEmbedded) e->setReadOnly(flag);
+        }
 
         void disposeDynamicBuffer() {
             if (dynamicBuffer != nullptr) {
-                delete dynamicBuffer;
+                delete[] dynamicBuffer;
                 dynamicBuffer = nullptr;
-                buffer        = nullptr;
+                bind(nullptr);
             }
         }
 
     public:
-        Record() = default;
+        Record() {
+            LayoutCapture&  capture = layoutCapture();
+            if (capture.layout != nullptr && capture.owner == nullptr) capture.owner = this;
+        }
 
+        /**
+         * Copies a record. The copy overlays the same storage, unless the record
+         * owns its storage, in which case the copy gets a dynamic buffer of its own.
+         * The fields of the copy belong to the copy.
+         */
+        Record(const Record& that)
+                : numFields(that.numFields), lastOffset(that.lastOffset), bufferSize(that.bufferSize),
+                  readOnly(that.readOnly) {
+            copyContext() = {&that, this};
+            if (that.dynamicBuffer != nullptr) {
+                dynamicBuffer = new char[bufferSize];
+                std::memcpy(dynamicBuffer, that.dynamicBuffer, bufferSize);
+                buffer = dynamicBuffer;
+            } else {
+                buffer = that.buffer;
+            }
+        }
+
+        /**
+         * Moves a record, without any allocation or copying of its storage.
+         * A moved-from record that owned its storage, is left without storage.
+         */
+        Record(Record&& that) noexcept
+                : numFields(that.numFields), lastOffset(that.lastOffset), buffer(that.buffer),
+                  bufferSize(that.bufferSize), dynamicBuffer(that.dynamicBuffer), readOnly(that.readOnly) {
+            copyContext() = {&that, this};
+            if (that.dynamicBuffer != nullptr) {
+                that.dynamicBuffer = nullptr;
+                that.bind(nullptr);
+            }
+        }
+
+        /**
+         * Assigns the storage of that record, with the same semantics as copying.
+         */
+        Record&     operator =(const Record& that) {
+            if (this != &that) {
+                disposeDynamicBuffer();
+                if (that.dynamicBuffer != nullptr) {
+                    allocateDynamicBuffer();
+                    std::memcpy(dynamicBuffer, that.dynamicBuffer, size());
+                } else {
+                    bind(that.buffer);
+                }
+                setReadOnly(that.readOnly);
+            }
+            return *this;
+        }
+
+        Record&     operator =(Record&& that) noexcept {
+            if (this != &that) {
+                disposeDynamicBuffer();
+                dynamicBuffer = that.dynamicBuffer;
+                bind(that.buffer);
+                setReadOnly(that.readOnly);
+                if (that.dynamicBuffer != nullptr) {
+                    that.dynamicBuffer = nullptr;
+                    that.bind(nullptr);
+                }
+            }
+            return *this;
+        }
+
+        /**
+         * Frees the storage only; the embedded records are already destroyed, so they are not unbound.
+         */
         virtual ~Record() {
-            disposeDynamicBuffer();
+            delete[] dynamicBuffer;
+            CopyContext&  context = copyContext();
+            if (context.target == this || context.source == this) context = CopyContext();
         }
 
         Record&     allocateDynamicBuffer() {
+            disposeDynamicBuffer();
             dynamicBuffer = new char[ size() ];
             std::memset(dynamicBuffer, 0x0, size());
-            buffer = dynamicBuffer;
+            bind(dynamicBuffer);
+            setReadOnly(false);
             return *this;
         }
 
         Record&     assignStaticBuffer(char* buf, unsigned bufsiz) {
             if (bufsiz < size()) throw StorageOverflow();
-            buffer = buf;
             if (dynamicBuffer != nullptr) disposeDynamicBuffer();
+            bind(buf);
+            setReadOnly(false);
+            return *this;
+        }
+
+        /**
+         * Moves this record to the storage at buf, without any checks.
+         * For an overlay that does not own its storage and slides over a buffer
+         * of records, which has been checked as a whole.
+         */
+        Record&     slideTo(char* buf) {
+            bind(buf);
+            return *this;
+        }
+
+        /**
+         * Replaces shared storage with a private copy, which makes this record a deep copy.
+         * Does nothing if it already owns its storage.
+         */
+        Record&     detach() {
+            if (dynamicBuffer == nullptr && buffer != nullptr) {
+                char*  shared = buffer;
+                dynamicBuffer = new char[ size() ];
+                std::memcpy(dynamicBuffer, shared, size());
+                bind(dynamicBuffer);
+                setReadOnly(false);
+            }
             return *this;
         }
 
+        /**
+         * Returns true if it owns its storage.
+         */
+        bool        ownsBuffer() const {
+            return dynamicBuffer != nullptr;
+        }
+
+        /**
+         * Uses the read-only storage provided in buf, such as a read-only mapped file.
+         * The record refuses writes: any writable access to its storage, or that of its
+         * embedded records and of copies of it, throws ReadOnlyStorage, until it's given other storage.
+         * Reading has no side effects, so any number of threads can read the same record concurrently.
+         */
+        const Record&   assignReadOnlyBuffer(const char* buf, unsigned bufsiz) {
+            assignStaticBuffer(const_cast<char*>(buf), bufsiz);
+            setReadOnly(true);
+            return *this;
+        }
+
+        /**
+         * Returns true if it refuses writes.
+         */
+        bool        isReadOnly() const {
+            return readOnly;
+        }
+
         unsigned    getLastOffset() const {
-            if (fields.empty()) return 0;
-            auto last = fields.back();
-            return last->fieldOffset + last->fieldSize;
+            return lastOffset;
+        }
+
+        /**
+         * Returns the record this one is embedded in, directly or not; itself if not embedded.
+         */
+        const Record&   outermost() const {
+            const Record*  r = this;
+            while (r->enclosing != nullptr) r = r->enclosing;
+            return *r;
         }
 
-        void updateBufferSize() {
-            auto result = std::max_element(fields.begin(), fields.end(), [](FieldBase* left, FieldBase* right){
-                return left->endOffset() < right->endOffset();
-            });
-            bufferSize = (*result)->endOffset();
+        /**
+         * Returns the offset of this record within outermost().
+         */
+        unsigned    outerOffset() const {
+            unsigned  offset = 0;
+            for (const Record* r = this; r->enclosing != nullptr; r = r->enclosing) offset += r->embeddedOffset;
+            return offset;
         }
 
         unsigned size() const {
-            if (fields.empty()) throw UnInitialized("No fields defined. Record.hpp:" + __LINE__);
+            if (numFields == 0) throw UnInitialized("No fields defined");
             return bufferSize;
         }
 
+        /**
+         * Returns the layout of RecordType.
+         * It's computed once, from a default-constructed prototype, and then shared.
+         */
+        template<typename RecordType>
+        static const RecordLayout&  layout() {
+            static_assert(std::is_base_of<Record, RecordType>::value, "Requires a Record subclass");
+            static const RecordLayout  instance = captureLayout<RecordType>();
+            return instance;
+        }
+
+    private:
+        /**
+         * Points the layout capture at a layout, and restores the previous capture when destroyed,
+         * also if the prototype constructor throws.
+         */
+        struct LayoutCaptureGuard {
+            LayoutCapture&  capture;
+            LayoutCapture   saved;
+
+            LayoutCaptureGuard(RecordLayout* layout) : capture(layoutCapture()), saved(capture) {
+                capture.layout = layout;
+                capture.owner  = nullptr;
+            }
+            ~LayoutCaptureGuard() { capture = saved; }
+
+            LayoutCaptureGuard(const LayoutCaptureGuard&) = delete;
+            LayoutCaptureGuard&  operator =(const LayoutCaptureGuard&) = delete;
+        };
+
+        template<typename RecordType>
+        static RecordLayout  captureLayout() {
+            RecordLayout  result;
+            {
+                LayoutCaptureGuard  guard(&result);
+                RecordType  prototype;
+                result.size = prototype.size();
+            }
+            return result;
+        }
+
+    public:
+
         /**
          * Returns the start address of a record.
+         * A const record only hands out its storage as const,
+         * and a read-only record only as const.
          */
-        char* begin() const {
-            if (buffer == nullptr) throw UnInitialized("Buffer is null. Record.hpp:" + __LINE__);
+        char* begin() {
+            if (buffer == nullptr) throw UnInitialized("Buffer is null");
+            if (readOnly) throw ReadOnlyStorage();
+            return buffer;
+        }
+
+        const char* begin() const {
+            if (buffer == nullptr) throw UnInitialized("Buffer is null");
             return buffer;
         }
 
         /**
          * Returns the end address of a record.
          */
-        char* end() const {
+        char* end() {
+            return begin() + size();
+        }
+
+        const char* end() const {
             return begin() + size();
         }
 
@@ -160,8 +596,7 @@ namespace overlay_record {
          * It's assumed that sizeof(buf) is sufficient.
          */
         Record& operator <<(char* buf) {
-            if (buffer == nullptr) throw UnInitialized("Buffer is null Record.hpp:" + __LINE__);
-            std::memcpy(buffer, buf, size());
+            std::memcpy(begin(), buf, size());
             return *this;
         }
 
@@ -180,7 +615,7 @@ namespace overlay_record {
          * It's assumed that the buffer has sufficient size.
          */
         char* operator +=(int n) {
-            buffer += n * size();
+            bind(buffer + n * (int)size());
             return buffer;
         }
 
@@ -221,8 +656,7 @@ namespace overlay_record {
                 this->record      = record;
                 this->fieldSize   = field_size;
                 this->fieldOffset = offset;
-                record->fields.push_back(this);
-                record->updateBufferSize();
+                record->addField(this, ConverterKind<converter>::value);
             }
 
             /**
@@ -253,15 +687,24 @@ namespace overlay_record {
 
             /**
              * Returns its start address.
+             * The storage of a const field is const.
              */
-            char*   begin() const {
+            char*   begin() {
                 return record->begin() + fieldOffset;
             }
 
+            const char*   begin() const {
+                return static_cast<const Record*>(record)->begin() + fieldOffset;
+            }
+
             /**
              * Returns its end address.
              */
-            char*   end() const {
+            char*   end() {
+                return begin() + size();
+            }
+
+            const char*   end() const {
                 return begin() + size();
             }
 
@@ -279,6 +722,13 @@ namespace overlay_record {
                 return std::string(begin(), end());
             }
 
+            /**
+             * Returns a view of its storage, without any copying.
+             */
+            TextView view() const {
+                return TextView(begin(), size());
+            }
+
             /**
              * Sets its value.
              * Uses its converter::toStorage() function.
@@ -288,6 +738,25 @@ namespace overlay_record {
                 converter::toStorage(v, begin(), size());
             }
 
+            /**
+             * Sets its value from characters, without a temporary string.
+             * Only for text and HEX fields.
+             */
+            template<typename C = converter, typename = IfCharacterConverter<C>>
+            void value(const char* v, size_t n) {
+                converter::toStorage(v, n, begin(), size());
+            }
+
+            template<typename C = converter, typename = IfCharacterConverter<C>>
+            void value(const char* v) {
+                converter::toStorage(v, begin(), size());
+            }
+
+            template<typename C = converter, typename = IfCharacterConverter<C>>
+            void value(const TextView& v) {
+                converter::toStorage(v.data(), v.size(), begin(), size());
+            }
+
             /**
              * Returns its value.
              * Uses its converter::fromStorage() function.
@@ -310,6 +779,25 @@ namespace overlay_record {
                 value(v);
                 return *this;
             }
+
+            template<typename C = converter, typename = IfCharacterConverter<C>>
+            Field<FieldType, field_size, converter>&
+            operator =(const char* v) {
+                value(v);
+                return *this;
+            }
+
+            /**
+             * Copies the content of that field.
+             */
+            Field(const Field&) = default;
+
+            Field<FieldType, field_size, converter>&
+            operator =(const Field& that) {
+                if (that.record->buffer == nullptr) return *this;
+                if (begin() != that.begin()) std::memmove(begin(), that.begin(), size());
+                return *this;
+            }
             
         };
 
@@ -331,7 +819,7 @@ namespace overlay_record {
             	static_assert(std::is_default_constructible<ItemType>::value,
             	             "Requires default-constructible elements");
 
-                for (int k = 0; k < COUNT; ++k) {
+                for (unsigned k = 0; k < COUNT; ++k) {
                     items[k].init(record, record->getLastOffset());
                 }
             }
@@ -344,13 +832,21 @@ namespace overlay_record {
 
                 unsigned offset = alignField.fieldOffset + (alignStart ? 0 : alignField.fieldSize);
                 items[0].init(record, offset);
-                for (int k = 1; k < COUNT; ++k) {
+                for (unsigned k = 1; k < COUNT; ++k) {
                     items[k].init(record, record->getLastOffset());
                 }
             }
 
             ItemType& operator[](int ix) {
-                if (0 <= ix && ix < numItems) {
+                if (0 <= ix && ix < (int)numItems) {
+                    return items[ix];
+                } else {
+                    throw IndexOutOfBounds(ix, numItems);
+                }
+            }
+
+            const ItemType& operator[](int ix) const {
+                if (0 <= ix && ix < (int)numItems) {
                     return items[ix];
                 } else {
                     throw IndexOutOfBounds(ix, numItems);
@@ -375,11 +871,24 @@ namespace overlay_record {
             iterator  begin() { return iterator(*this, 0); }
             iterator  end()   { return iterator(*this, COUNT); }
 
+            class const_iterator {
+                const Array<TYPE, COUNT>&   arr;
+                int                         ix;
+
+            public:
+                const_iterator(const Array<TYPE, COUNT>& _arr, int _ix) : arr(_arr), ix(_ix) {}
+                const TYPE&     operator *() const { return arr[ix]; }
+                const_iterator& operator ++() { ++ix; return *this; };
+                bool            operator !=(const const_iterator& that) const { return this->ix != that.ix; }
+            };
+            const_iterator  begin() const { return const_iterator(*this, 0); }
+            const_iterator  end()   const { return const_iterator(*this, COUNT); }
+
             // --- Support for array assignment ---
             void  assign(std::initializer_list<typename ItemType::TYPE> values) {
                 if (COUNT == values.size()) {
                     auto v = values.begin();
-                    for (int k=0; k<COUNT; ++k, ++v) items[k].value( *v );
+                    for (unsigned k=0; k<COUNT; ++k, ++v) items[k].value( *v );
                 } else {
                     throw IndexOutOfBounds(values.size(), numItems);
                 }
@@ -400,7 +909,7 @@ namespace overlay_record {
             std::string  toString(std::string SEP = ", ", std::string LEFT = "[", std::string RIGHT = "]") const {
                 std::string  result = S( items[0].value(), std::is_arithmetic<typename ItemType::TYPE>() );
 
-                for (int k=1; k<COUNT; ++k)  result += SEP + S( items[k].value(), std::is_arithmetic<typename ItemType::TYPE>() );
+                for (unsigned k=1; k<COUNT; ++k)  result += SEP + S( items[k].value(), std::is_arithmetic<typename ItemType::TYPE>() );
                 return LEFT + result + RIGHT;
             }
         };
@@ -420,8 +929,13 @@ namespace overlay_record {
                 this->record      = record;
                 this->fieldSize   = embeddedRecord.size();
                 this->fieldOffset = offset;
-                record->fields.push_back(this);
-                record->updateBufferSize();
+                record->addField(this, FieldKind::EMBED);
+                record->addEmbedded(&embeddedRecord, offset);
+            }
+
+            Embed(const Embed& that, CopyContext outer) noexcept : FieldBase(that), embeddedRecord(that.embeddedRecord) {
+                copyContext() = outer;
+                if (record != that.record) record->addEmbedded(&embeddedRecord, fieldOffset);
             }
 
         public:
@@ -429,30 +943,57 @@ namespace overlay_record {
                 init(record, record->getLastOffset());
             }
 
+            /**
+             * When copied as part of a record, the embedded record is bound to the new record.
+             */
+            Embed(const Embed& that) noexcept : Embed(that, copyContext()) {}
+
+            /**
+             * Copies the content of that embedded record.
+             */
+            Embed&  operator =(const Embed& that) {
+                if (that.record->buffer == nullptr) return *this;
+                if (begin() != that.begin()) std::memmove(begin(), that.begin(), size());
+                return *this;
+            }
+
             template<typename T, unsigned N, typename C>
             Embed(Record* record, const Field<T, N, C>& alignField, bool alignStart = true) {
                 init(record, alignField.fieldOffset + (alignStart ? 0 : alignField.fieldSize));
             }
 
+            /**
+             * Returns the embedded record.
+             * It's bound whenever the owning record is bound or slides, so access has no side effects.
+             */
             RecordType*     operator ->() {
-            	if (embeddedRecord.buffer == nullptr) {
-            		embeddedRecord.buffer = begin();
-            	}
+                return &embeddedRecord;
+            }
 
+            const RecordType*   operator ->() const {
                 return &embeddedRecord;
             }
 
             /**
              * Returns its start address.
+             * The storage of a const field is const.
              */
-            char*   begin() const {
+            char*   begin() {
                 return record->begin() + fieldOffset;
             }
 
+            const char*   begin() const {
+                return static_cast<const Record*>(record)->begin() + fieldOffset;
+            }
+
             /**
              * Returns its end address.
              */
-            char*   end() const {
+            char*   end() {
+                return begin() + size();
+            }
+
+            const char*   end() const {
                 return begin() + size();
             }
 
@@ -471,19 +1012,46 @@ namespace overlay_record {
         // -----------------------------------------------------
         template<char PAD = ' '>
         struct TextConverter {
-            static void toStorage(std::string& v, char* offset, unsigned size) {
-                std::fill_n(offset, size, PAD);
-                v.copy(offset, size);
+            static void toStorage(const char* v, size_t n, char* offset, unsigned size) {
+                if (n > size) n = size;
+                std::memcpy(offset, v, n);
+                std::memset(offset + n, PAD, size - n);
             }
 
-            static std::string fromStorage(char* offset, unsigned size) {
-            	std::string  payload(offset, offset + size);
+            static void toStorage(const std::string& v, char* offset, unsigned size) {
+                toStorage(v.data(), v.size(), offset, size);
+            }
 
-            	std::string  result(size, PAD);
-            	for (int k=0; k<payload.size(); ++k)
-            		if (payload[k]) result[k] = payload[k];
+            static void toStorage(const char* v, char* offset, unsigned size) {
+                toStorage(v, std::strlen(v), offset, size);
+            }
+
+            /**
+             * Returns a copy, with NUL characters replaced by PAD.
+             * The replacement is a branch-free loop the compiler can vectorize.
+             */
+            static std::string fromStorage(const char* offset, unsigned size) {
+                std::string  result;
+                fromStorage(offset, size, result);
+                return result;
+            }
 
-            	return result;
+            /**
+             * Same as above, but reuses the capacity of result instead of returning a new string.
+             */
+            static void fromStorage(const char* offset, unsigned size, std::string& result) {
+                result.assign(offset, size);
+                char*  data = &result[0];
+                for (unsigned k = 0; k < size; ++k)
+                    data[k] = (data[k] == '\0') ? PAD : data[k];
+            }
+
+            /**
+             * Returns a view of the storage, without any copying.
+             * NUL characters are not replaced.
+             */
+            static TextView view(const char* offset, unsigned size) {
+                return TextView(offset, size);
             }
         };
 
@@ -494,54 +1062,566 @@ namespace overlay_record {
                 std::to_string(v).copy(offset, size);
             }
 
-            static Type fromStorage(char* offset, size_t size) {
+            static Type fromStorage(const char* offset, size_t size) {
                 str2num f;
                 return f(std::string(offset, offset + size));
             }
         };
 
+        /**
+         * Parses and formats numbers directly against the field's characters,
+         * without allocation, locale or exceptions (unless OverflowPolicy::THROW).
+         * Leading and trailing pad/blanks and a leading sign are accepted when parsing.
+         * Runs of 8 digits are parsed 8 bytes at a time (SWAR) on little-endian targets.
+         */
+        template<typename Type, char PAD = ' ',
+                 NumberAlign ALIGN = NumberAlign::LEFT,
+                 OverflowPolicy OVERFLOW_POLICY = OverflowPolicy::SATURATE>
+        struct DecimalConverter {
+            static_assert(std::is_arithmetic<Type>::value, "Requires a numeric type");
+
+            static void toStorage(Type v, char* offset, size_t size) {
+                format(v, offset, size, std::is_integral<Type>());
+            }
+
+            static Type fromStorage(const char* offset, size_t size) {
+                return parse(offset, size, std::is_integral<Type>());
+            }
+
+        private:
+            typedef unsigned long long  Magnitude;
+
+            static bool isBlank(char c) {
+                return c == PAD || c == ' ' || c == '\0';
+            }
+
+            static bool isDigit(char c) {
+                return static_cast<unsigned char>(c - '0') < 10;
+            }
+
+            static Magnitude  powerOf10(unsigned k) {
+                static const Magnitude  table[] = {
+                    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+                    100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL,
+                    10000000000000ULL, 100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+                    100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL
+                };
+                return table[k];
+            }
+
+            static void overflow() {
+                if (OVERFLOW_POLICY == OverflowPolicy::THROW) throw std::overflow_error("Number doesn't fit");
+            }
+
+            /**
+             * Accumulates the digits at p into magnitude, 8 at a time where possible.
+             * Returns the first non-digit position.
+             */
+            static const char* digits(const char* p, const char* end, Magnitude& magnitude, bool& overflowed) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+                while (end - p >= 8) {
+                    uint64_t  chunk;
+                    std::memcpy(&chunk, p, 8);
+                    const uint64_t  allDigits = (chunk & 0xF0F0F0F0F0F0F0F0ULL)
+                                              | (((chunk + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4);
+                    if (allDigits != 0x3333333333333333ULL) break;
+
+                    chunk -= 0x3030303030303030ULL;
+                    chunk  = (chunk * 10) + (chunk >> 8);
+                    chunk  = (((chunk & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32)))
+                           + (((chunk >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+
+                    if (magnitude > (std::numeric_limits<Magnitude>::max() - chunk) / 100000000ULL) overflowed = true;
+                    magnitude = magnitude * 100000000ULL + chunk;
+                    p += 8;
+                }
+#endif
+                for (; p < end && isDigit(*p); ++p) {
+                    const unsigned  d = *p - '0';
+                    if (magnitude > (std::numeric_limits<Magnitude>::max() - d) / 10) overflowed = true;
+                    magnitude = magnitude * 10 + d;
+                }
+                return p;
+            }
+
+            static Type parse(const char* p, size_t size, std::true_type) {
+                const char*  end = p + size;
+                while (p < end && isBlank(*p)) ++p;
+
+                bool  negative = false;
+                if (p < end && (*p == '-' || *p == '+')) negative = (*p++ == '-');
+
+                Magnitude  magnitude  = 0;
+                bool       overflowed = false;
+                digits(p, end, magnitude, overflowed);
+
+                const Magnitude  maxValue = static_cast<Magnitude>(std::numeric_limits<Type>::max());
+                const Magnitude  limit    = (negative && std::is_signed<Type>::value) ? maxValue + 1 : maxValue;
+                if (negative && !std::is_signed<Type>::value && magnitude > 0) overflowed = true;
+
+                if (overflowed || magnitude > limit) {
+                    overflow();
+                    return negative ? std::numeric_limits<Type>::min() : std::numeric_limits<Type>::max();
+                }
+                return negative ? static_cast<Type>(0 - magnitude) : static_cast<Type>(magnitude);
+            }
+
+            static Type parse(const char* p, size_t size, std::false_type) {
+                const char*  begin = p;
+                const char*  end   = p + size;
+                while (p < end && isBlank(*p)) ++p;
+
+                bool  negative = false;
+                if (p < end && (*p == '-' || *p == '+')) negative = (*p++ == '-');
+
+                Magnitude   mantissa  = 0;
+                int         exponent  = 0;
+                unsigned    numDigits = 0;
+                for (; p < end && isDigit(*p); ++p) {
+                    if (numDigits < 19) { mantissa = mantissa * 10 + (*p - '0'); if (mantissa) ++numDigits; }
+                    else ++exponent;
+                }
+                if (p < end && *p == '.') {
+                    for (++p; p < end && isDigit(*p); ++p) {
+                        if (numDigits < 19) { mantissa = mantissa * 10 + (*p - '0'); --exponent; if (mantissa) ++numDigits; }
+                    }
+                }
+                if (p < end && (*p == 'e' || *p == 'E')) return slowParse(begin, size);
+
+                // Exact when both mantissa and power of 10 are exact doubles
+                static const double  exact[] = {
+                    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+                };
+                if (mantissa > (1ULL << 53) || exponent < -22 || exponent > 22) return slowParse(begin, size);
+
+                double  result = static_cast<double>(mantissa);
+                result = exponent < 0 ? result / exact[-exponent] : result * exact[exponent];
+                return static_cast<Type>(negative ? -result : result);
+            }
+
+            static Type slowParse(const char* p, size_t size) {
+                char  buf[64];
+                const size_t  n = std::min(size, sizeof(buf) - 1);
+                std::memcpy(buf, p, n);
+                buf[n] = '\0';
+                return static_cast<Type>(std::strtod(buf, nullptr));
+            }
+
+            /**
+             * Places the characters [first, first + n) with an optional sign into the field.
+             */
+            static void place(bool negative, const char* first, size_t n, char* offset, size_t size) {
+                const size_t  width = n + (negative ? 1 : 0);
+                const size_t  fill  = size - width;
+                if (ALIGN == NumberAlign::LEFT) {
+                    if (negative) *offset++ = '-';
+                    std::memcpy(offset, first, n);
+                    std::memset(offset + n, PAD, fill);
+                } else if (ALIGN == NumberAlign::RIGHT) {
+                    std::memset(offset, PAD, fill);
+                    offset += fill;
+                    if (negative) *offset++ = '-';
+                    std::memcpy(offset, first, n);
+                } else {
+                    if (negative) *offset++ = '-';
+                    std::memset(offset, '0', fill);
+                    std::memcpy(offset + fill, first, n);
+                }
+            }
+
+            static void saturate(bool negative, char* offset, size_t size) {
+                overflow();
+                if (size == 0) return;
+                if (negative && !std::is_signed<Type>::value) {
+                    place(false, "0", 1, offset, size);
+                    return;
+                }
+                const size_t  n = size - (negative ? 1 : 0);
+                if (negative) *offset++ = '-';
+                std::memset(offset, '9', n);
+            }
+
+            /**
+             * Writes the decimal digits of m right-aligned ending at last, two at a time.
+             * Returns the start of the digits.
+             */
+            static char* formatDigits(Magnitude m, char* last) {
+                static const char  pairs[] =
+                    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+                    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+                    "8081828384858687888990919293949596979899";
+                while (m >= 100) {
+                    const unsigned  ix = (m % 100) * 2;
+                    m /= 100;
+                    *--last = pairs[ix + 1];
+                    *--last = pairs[ix];
+                }
+                if (m >= 10) {
+                    *--last = pairs[m * 2 + 1];
+                    *--last = pairs[m * 2];
+                } else {
+                    *--last = static_cast<char>('0' + m);
+                }
+                return last;
+            }
+
+            static void format(Type v, char* offset, size_t size, std::true_type) {
+                const bool       negative  = v < 0;
+                const Magnitude  magnitude = negative ? 0 - static_cast<Magnitude>(v) : static_cast<Magnitude>(v);
+
+                char   buf[24];
+                char*  first = formatDigits(magnitude, buf + sizeof(buf));
+                const size_t  n = buf + sizeof(buf) - first;
+
+                if (n + (negative ? 1 : 0) > size) saturate(negative, offset, size);
+                else place(negative, first, n, offset, size);
+            }
+
+            static void format(Type v, char* offset, size_t size, std::false_type) {
+                const double  x        = static_cast<double>(v);
+                const bool    negative = std::signbit(x) && x != 0;
+                const double  absolute = std::fabs(x);
+
+                if (!(absolute < 1e17)) {
+                    char  buf[32];
+                    int   n = std::snprintf(buf, sizeof(buf), "%.*g", (int)std::min<size_t>(size, 17), x);
+                    if (n < 0 || (size_t)n > size) saturate(negative, offset, size);
+                    else place(false, buf, n, offset, size);
+                    return;
+                }
+
+                // Integer part plus as many decimals as fit in the field, rounded
+                const size_t  signWidth = negative ? 1 : 0;
+                char   buf[48];
+                char*  last = buf + sizeof(buf);
+                const Magnitude  intPart   = static_cast<Magnitude>(absolute);
+                const size_t     intDigits = last - formatDigits(intPart, last);
+                if (intDigits + signWidth > size) { saturate(negative, offset, size); return; }
+
+                size_t  room     = size - signWidth - intDigits;
+                size_t  decimals = room >= 2 ? std::min<size_t>(room - 1, 17 - std::min<size_t>(intDigits, 17)) : 0;
+                for (;;) {
+                    const Magnitude  scale  = powerOf10(decimals);
+                    const Magnitude  scaled = static_cast<Magnitude>(std::llround(absolute * scale));
+                    char*  first = last;
+                    if (decimals > 0) {
+                        Magnitude  fraction = scaled % scale;
+                        for (size_t k = 0; k < decimals; ++k, fraction /= 10) *--first = static_cast<char>('0' + fraction % 10);
+                        *--first = '.';
+                    }
+                    first = formatDigits(scaled / scale, first);
+
+                    const size_t  n = last - first;
+                    if (n + signWidth <= size) { place(negative && scaled != 0, first, n, offset, size); return; }
+                    if (decimals == 0) { saturate(negative, offset, size); return; }
+                    --decimals;
+                }
+            }
+        };
+
         template<typename Type>
         struct BinaryConverter {
             static void toStorage(Type v, char* offset, size_t size) {
                 std::memcpy(offset, &v, sizeof(Type));
             }
 
-            static Type fromStorage(char* offset, size_t size) {
+            static Type fromStorage(const char* offset, size_t size) {
                 Type v = Type(); //=0
                 std::memcpy(&v, offset, sizeof(Type));
                 return v;
             }
         };
 
+        /**
+         * Binary value stored in the given byte order, regardless of the host's.
+         * Uses the compiler's byte-swap intrinsics when the orders differ.
+         */
+        template<typename Type, ByteOrder ORDER>
+        struct EndianConverter {
+            static_assert(sizeof(Type) == 1 || sizeof(Type) == 2 || sizeof(Type) == 4 || sizeof(Type) == 8,
+                          "Requires a 1, 2, 4 or 8 byte type");
+
+            static void toStorage(Type v, char* offset, size_t size) {
+                char  bytes[sizeof(Type)];
+                std::memcpy(bytes, &v, sizeof(Type));
+                if (ORDER != HOST_BYTE_ORDER) swap(bytes, std::integral_constant<size_t, sizeof(Type)>());
+                std::memcpy(offset, bytes, sizeof(Type));
+            }
+
+            static Type fromStorage(const char* offset, size_t size) {
+                char  bytes[sizeof(Type)];
+                std::memcpy(bytes, offset, sizeof(Type));
+                if (ORDER != HOST_BYTE_ORDER) swap(bytes, std::integral_constant<size_t, sizeof(Type)>());
+                Type  v;
+                std::memcpy(&v, bytes, sizeof(Type));
+                return v;
+            }
+
+        private:
+            static void swap(char*, std::integral_constant<size_t, 1>) {}
+
+            static void swap(char* bytes, std::integral_constant<size_t, 2>) {
+                uint16_t  x; std::memcpy(&x, bytes, 2);
+                x = __builtin_bswap16(x);
+                std::memcpy(bytes, &x, 2);
+            }
+
+            static void swap(char* bytes, std::integral_constant<size_t, 4>) {
+                uint32_t  x; std::memcpy(&x, bytes, 4);
+                x = __builtin_bswap32(x);
+                std::memcpy(bytes, &x, 4);
+            }
+
+            static void swap(char* bytes, std::integral_constant<size_t, 8>) {
+                uint64_t  x; std::memcpy(&x, bytes, 8);
+                x = __builtin_bswap64(x);
+                std::memcpy(bytes, &x, 8);
+            }
+        };
+
+        /**
+         * Conversion between a value and the unsigned digits of a decimal
+         * with SCALE implied decimals. Shared by the packed and zoned converters.
+         */
+        template<typename Type, unsigned SCALE>
+        struct ScaledDecimal {
+            /**
+             * Returns the digits of |v|, saturated to numDigits digits.
+             */
+            static unsigned long long  scaledMagnitude(Type v, size_t numDigits) {
+                unsigned long long  limit = 1;
+                for (size_t k = 0; k < numDigits && k < 19; ++k) limit *= 10;
+                double  scaled = std::fabs(static_cast<double>(v));
+                for (unsigned k = 0; k < SCALE; ++k) scaled *= 10;
+                unsigned long long  m = std::is_integral<Type>::value && SCALE == 0
+                        ? (v < 0 ? 0 - static_cast<unsigned long long>(v) : static_cast<unsigned long long>(v))
+                        : static_cast<unsigned long long>(std::llround(scaled));
+                return (numDigits < 19 && m >= limit) ? limit - 1 : m;
+            }
+
+            static Type unscaled(unsigned long long m, bool negative) {
+                if (std::is_integral<Type>::value && SCALE == 0) {
+                    return negative ? static_cast<Type>(0 - m) : static_cast<Type>(m);
+                }
+                double  v = static_cast<double>(m);
+                for (unsigned k = 0; k < SCALE; ++k) v /= 10;
+                return static_cast<Type>(negative ? -v : v);
+            }
+        };
+
+        /**
+         * Packed decimal (COBOL COMP-3): two digits per byte, and the sign in the last nibble
+         * (C or F positive, D negative). A field of N bytes holds 2N-1 digits.
+         * SCALE is the number of implied decimals, for floating-point types.
+         * Values that don't fit are saturated.
+         */
+        template<typename Type, unsigned SCALE = 0>
+        struct PackedDecimalConverter : private ScaledDecimal<Type, SCALE> {
+            typedef ScaledDecimal<Type, SCALE>  Scale;
+
+            static void toStorage(Type v, char* offset, size_t size) {
+                unsigned char*  bytes    = reinterpret_cast<unsigned char*>(offset);
+                const bool      negative = v < 0;
+                unsigned long long  m = Scale::scaledMagnitude(v, size * 2 - 1);
+
+                bytes[size - 1] = static_cast<unsigned char>(((m % 10) << 4) | (negative ? 0x0D : 0x0C));
+                m /= 10;
+                for (size_t k = size - 1; k > 0; --k) {
+                    const unsigned  lo = m % 10; m /= 10;
+                    const unsigned  hi = m % 10; m /= 10;
+                    bytes[k - 1] = static_cast<unsigned char>((hi << 4) | lo);
+                }
+            }
+
+            static Type fromStorage(const char* offset, size_t size) {
+                const unsigned char*  bytes = reinterpret_cast<const unsigned char*>(offset);
+                unsigned long long    m = 0;
+                for (size_t k = 0; k + 1 < size; ++k) {
+                    m = m * 10 + digit(bytes[k] >> 4);
+                    m = m * 10 + digit(bytes[k] & 0x0F);
+                }
+                m = m * 10 + digit(bytes[size - 1] >> 4);
+                const unsigned  sign = bytes[size - 1] & 0x0F;
+                return Scale::unscaled(m, sign == 0x0D || sign == 0x0B);
+            }
+
+        private:
+            static unsigned digit(unsigned nibble) {
+                return nibble < 10 ? nibble : 0;
+            }
+        };
+
+        /**
+         * Zoned decimal (EBCDIC, COBOL DISPLAY): one digit per byte in the low nibble,
+         * zone F, and the sign in the zone of the last byte (C or F positive, D negative).
+         * SCALE is the number of implied decimals, for floating-point types.
+         * Values that don't fit are saturated.
+         */
+        template<typename Type, unsigned SCALE = 0>
+        struct ZonedDecimalConverter : private ScaledDecimal<Type, SCALE> {
+            typedef ScaledDecimal<Type, SCALE>  Scale;
+
+            static void toStorage(Type v, char* offset, size_t size) {
+                unsigned char*  bytes    = reinterpret_cast<unsigned char*>(offset);
+                const bool      negative = v < 0;
+                unsigned long long  m = Scale::scaledMagnitude(v, size);
+
+                for (size_t k = size; k > 0; --k, m /= 10) {
+                    bytes[k - 1] = static_cast<unsigned char>(0xF0 | (m % 10));
+                }
+                bytes[size - 1] = static_cast<unsigned char>((negative ? 0xD0 : 0xC0) | (bytes[size - 1] & 0x0F));
+            }
+
+            static Type fromStorage(const char* offset, size_t size) {
+                const unsigned char*  bytes = reinterpret_cast<const unsigned char*>(offset);
+                unsigned long long    m = 0;
+                for (size_t k = 0; k < size; ++k) {
+                    const unsigned  d = bytes[k] & 0x0F;
+                    m = m * 10 + (d < 10 ? d : 0);
+                }
+                const unsigned  zone = bytes[size - 1] >> 4;
+                return Scale::unscaled(m, zone == 0x0D || zone == 0x0B);
+            }
+
+        };
+
+        /**
+         * Converts between binary bytes and upper-case HEX text (lower-case accepted).
+         * Table-driven, with an SSE2 path for 16 bytes at a time where available.
+         */
         struct HEXConverter {
-        	static void toStorage(const std::string& payload, void* offset, size_t size) {
-        		const size_t	N    = std::min(2 * size, payload.size());
+        	static void toStorage(const char* payload, size_t n, void* offset, size_t size) {
         		unsigned char*	data = reinterpret_cast<unsigned char*>(offset);
         		std::memset(data, '\0', size);
+        		decode(payload, std::min(2 * size, n), data);
+        	}
+
+        	static void toStorage(const std::string& payload, void* offset, size_t size) {
+        		toStorage(payload.data(), payload.size(), offset, size);
+        	}
 
-        		std::stringstream  buf;
-        		buf >> std::hex;
-        		for (size_t payloadIdx = 0, dataIdx = 0; payloadIdx < N; ++dataIdx) {
-        			const char byteStr[3] = {
-        					payload[payloadIdx++], payload[payloadIdx++], '\0'
-        			};
+        	static void toStorage(const char* payload, void* offset, size_t size) {
+        		toStorage(payload, std::strlen(payload), offset, size);
+        	}
+
+        	static std::string fromStorage(const void* offset, size_t size) {
+        		std::string  result(2 * size, '0');
+        		encode(offset, size, &result[0]);
+        		return result;
+        	}
 
-        			buf.clear(); buf.str(byteStr);
-        			int byteValue = 0; buf >> byteValue;
-        			data[dataIdx] = static_cast<unsigned char>(byteValue);
+        	/**
+        	 * Writes 2*n HEX characters of the n bytes at src, into dst.
+        	 */
+        	static void encode(const void* src, size_t n, char* dst) {
+        		const unsigned char*	bytes = reinterpret_cast<const unsigned char*>(src);
+        		size_t  k = 0;
+#if defined(__SSE2__)
+        		const __m128i  lowNibble = _mm_set1_epi8(0x0F);
+        		const __m128i  nine      = _mm_set1_epi8(9);
+        		const __m128i  digits    = _mm_set1_epi8('0');
+        		const __m128i  letters   = _mm_set1_epi8('A' - '0' - 10);
+        		for (; k + 16 <= n; k += 16) {
+        			const __m128i  x  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + k));
+        			const __m128i  hi = _mm_and_si128(_mm_srli_epi16(x, 4), lowNibble);
+        			const __m128i  lo = _mm_and_si128(x, lowNibble);
+        			__m128i  first  = _mm_unpacklo_epi8(hi, lo);
+        			__m128i  second = _mm_unpackhi_epi8(hi, lo);
+        			first  = _mm_add_epi8(_mm_add_epi8(first, digits),  _mm_and_si128(_mm_cmpgt_epi8(first, nine),  letters));
+        			second = _mm_add_epi8(_mm_add_epi8(second, digits), _mm_and_si128(_mm_cmpgt_epi8(second, nine), letters));
+        			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * k),      first);
+        			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * k + 16), second);
+        		}
+#endif
+        		const char*  pairs = hexPairs();
+        		for (; k < n; ++k) {
+        			dst[2 * k]     = pairs[2 * bytes[k]];
+        			dst[2 * k + 1] = pairs[2 * bytes[k] + 1];
         		}
         	}
 
-        	static std::string fromStorage(void* offset, size_t size) {
-        		unsigned char*	payload = reinterpret_cast<unsigned char*>(offset);
+        	/**
+        	 * Writes the bytes of the n HEX characters at src, into dst.
+        	 * Invalid characters count as 0, and a trailing odd character as a single digit.
+        	 */
+        	static void decode(const char* src, size_t n, void* dst) {
+        		unsigned char*	bytes = reinterpret_cast<unsigned char*>(dst);
+        		const signed char*  nibbles = hexNibbles();
+        		size_t  k = 0;
+#if defined(__SSE2__)
+        		for (; k + 32 <= n; k += 32) {
+        			__m128i  first, second;
+        			if (!decodeNibbles(src + k, first) || !decodeNibbles(src + k + 16, second)) break;
+        			const __m128i  mask = _mm_set1_epi16(0x00FF);
+        			const __m128i  a = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(first, mask), 4),  _mm_srli_epi16(first, 8));
+        			const __m128i  b = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(second, mask), 4), _mm_srli_epi16(second, 8));
+        			_mm_storeu_si128(reinterpret_cast<__m128i*>(bytes + k / 2), _mm_packus_epi16(a, b));
+        		}
+#endif
+        		for (; k + 2 <= n; k += 2) {
+        			const signed char  hi = nibbles[static_cast<unsigned char>(src[k])];
+        			const signed char  lo = nibbles[static_cast<unsigned char>(src[k + 1])];
+        			bytes[k / 2] = (lo < 0)
+        					? static_cast<unsigned char>(hi < 0 ? 0 : hi)
+        					: static_cast<unsigned char>(((hi < 0 ? 0 : hi) << 4) | lo);
+        		}
+        		if (k < n) {
+        			const signed char  hi = nibbles[static_cast<unsigned char>(src[k])];
+        			bytes[k / 2] = static_cast<unsigned char>(hi < 0 ? 0 : hi);
+        		}
+        	}
 
-        		std::stringstream  buf;
-        		buf << std::hex << std::setfill('0') << std::uppercase;
-        		for (size_t k=0; k<size; ++k)
-        			buf << std::setw(2) << static_cast<int>( payload[k] );
+        private:
+        	static const char*  hexPairs() {
+        		static const char  pairs[] =
+        			"000102030405060708090A0B0C0D0E0F101112131415161718191A1B1C1D1E1F"
+        			"202122232425262728292A2B2C2D2E2F303132333435363738393A3B3C3D3E3F"
+        			"404142434445464748494A4B4C4D4E4F505152535455565758595A5B5C5D5E5F"
+        			"606162636465666768696A6B6C6D6E6F707172737475767778797A7B7C7D7E7F"
+        			"808182838485868788898A8B8C8D8E8F909192939495969798999A9B9C9D9E9F"
+        			"A0A1A2A3A4A5A6A7A8A9AAABACADAEAFB0B1B2B3B4B5B6B7B8B9BABBBCBDBEBF"
+        			"C0C1C2C3C4C5C6C7C8C9CACBCCCDCECFD0D1D2D3D4D5D6D7D8D9DADBDCDDDEDF"
+        			"E0E1E2E3E4E5E6E7E8E9EAEBECEDEEEFF0F1F2F3F4F5F6F7F8F9FAFBFCFDFEFF";
+        		return pairs;
+        	}
 
-        		return buf.str();
+        	/**
+        	 * Nibble value of each character, or -1 if not a HEX digit.
+        	 */
+        	static const signed char*  hexNibbles() {
+        		static const signed char  nibbles[256] = {
+        			-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+        			-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,  0, 1, 2, 3, 4, 5, 6, 7, 8, 9,-1,-1,-1,-1,-1,-1,
+        			-1,10,11,12,13,14,15,-1,-1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+        			-1,10,11,12,13,14,15,-1,-1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+        			-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+        			-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+        			-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+        			-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1
+        		};
+        		return nibbles;
         	}
+
+#if defined(__SSE2__)
+        	/**
+        	 * Converts 16 HEX characters into nibble values.
+        	 * Returns false if any of them is not a HEX digit.
+        	 */
+        	static bool decodeNibbles(const char* src, __m128i& result) {
+        		const __m128i  c      = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+        		const __m128i  digit  = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+        		const __m128i  letter = _mm_sub_epi8(_mm_or_si128(c, _mm_set1_epi8(0x20)), _mm_set1_epi8('a' - 10));
+        		// signed compares: values outside the ranges, including wrapped ones, fail
+        		const __m128i  isDigit  = _mm_and_si128(_mm_cmpgt_epi8(digit, _mm_set1_epi8(-1)),
+        		                                        _mm_cmplt_epi8(digit, _mm_set1_epi8(10)));
+        		const __m128i  isLetter = _mm_and_si128(_mm_cmpgt_epi8(letter, _mm_set1_epi8(9)),
+        		                                        _mm_cmplt_epi8(letter, _mm_set1_epi8(16)));
+        		if (_mm_movemask_epi8(_mm_or_si128(isDigit, isLetter)) != 0xFFFF) return false;
+        		result = _mm_or_si128(_mm_and_si128(isDigit, digit), _mm_and_si128(isLetter, letter));
+        		return true;
+        	}
+#endif
         };
 
 
@@ -613,17 +1693,29 @@ namespace overlay_record {
         template<int size>
         using Text = Field<std::string, size, TextConverter<>>;
 
+        template<int size, typename converter = NumericConverter<int, TO_INT>>
+        using TextInteger = Field<int, size, converter>;
+
+        template<int size, typename converter = NumericConverter<float, TO_FLOAT>>
+        using TextFloat = Field<float, size, converter>;
+
+        template<int size>
+        using DecimalInteger = TextInteger<size, DecimalConverter<int>>;
+
+        template<int size>
+        using DecimalLong = Field<long long, size, DecimalConverter<long long>>;
+
         template<int size>
-        using TextInteger = Field<int, size, NumericConverter<int, TO_INT>>;
+        using DecimalFloat = TextFloat<size, DecimalConverter<float>>;
 
         template<int size>
-        using TextFloat = Field<float, size, NumericConverter<float, TO_FLOAT>>;
+        using DecimalDouble = Field<double, size, DecimalConverter<double>>;
 
         template<typename Type>
         using BinaryType = Field<Type, sizeof(Type), BinaryConverter<Type>>;
 
         using Byte     = BinaryType<char>;
-        using Short    = BinaryType<int>;
+        using Short    = BinaryType<int>;   //N.B. 4 bytes; use Int16 for a 2 byte field
         using Integer  = BinaryType<int>;
         using Long     = BinaryType<long>;
 
@@ -634,26 +1726,111 @@ namespace overlay_record {
         using Word     = BinaryType<short>;
         using QUAD     = BinaryType<long long>;
 
+        using Int8     = BinaryType<int8_t>;
+        using Int16    = BinaryType<int16_t>;
+        using Int32    = BinaryType<int32_t>;
+        using Int64    = BinaryType<int64_t>;
+        using UInt8    = BinaryType<uint8_t>;
+        using UInt16   = BinaryType<uint16_t>;
+        using UInt32   = BinaryType<uint32_t>;
+        using UInt64   = BinaryType<uint64_t>;
+
+        template<typename Type>
+        using BigEndian    = Field<Type, sizeof(Type), EndianConverter<Type, ByteOrder::BIG>>;
+
+        template<typename Type>
+        using LittleEndian = Field<Type, sizeof(Type), EndianConverter<Type, ByteOrder::LITTLE>>;
+
+        template<int size, typename Type = long long, unsigned scale = 0>
+        using Packed   = Field<Type, size, PackedDecimalConverter<Type, scale>>;
+
+        template<int size, typename Type = long long, unsigned scale = 0>
+        using Zoned    = Field<Type, size, ZonedDecimalConverter<Type, scale>>;
+
         template<int size>
         using Blob	   = Field<std::string, size, HEXConverter>;
     };
 
+    inline unsigned FieldBase::outerOffset() const {
+        return record->outerOffset() + fieldOffset;
+    }
+
+    inline FieldBase::FieldBase(const FieldBase& that) noexcept
+            : record(that.record), fieldOffset(that.fieldOffset), fieldSize(that.fieldSize) {
+        const Record::CopyContext&  context = Record::copyContext();
+        if (context.source != nullptr && context.source == that.record) {
+            //belongs to the record being copied, iff at the same relative position
+            const uintptr_t  from = reinterpret_cast<uintptr_t>(&that) - reinterpret_cast<uintptr_t>(that.record);
+            const uintptr_t  to   = reinterpret_cast<uintptr_t>(this)  - reinterpret_cast<uintptr_t>(context.target);
+            if (from == to) record = context.target;
+        }
+    }
+
+    template<char PAD>
+    struct ConverterKind< Record::TextConverter<PAD> > {
+        static const FieldKind value = FieldKind::TEXT;
+    };
+
+    template<typename Type, typename str2num, char PAD>
+    struct ConverterKind< Record::NumericConverter<Type, str2num, PAD> > {
+        static const FieldKind value = FieldKind::NUMERIC;
+    };
+
+    template<typename Type, char PAD, NumberAlign ALIGN, OverflowPolicy OVERFLOW_POLICY>
+    struct ConverterKind< Record::DecimalConverter<Type, PAD, ALIGN, OVERFLOW_POLICY> > {
+        static const FieldKind value = FieldKind::NUMERIC;
+    };
+
+    template<typename Type>
+    struct ConverterKind< Record::BinaryConverter<Type> > {
+        static const FieldKind value = FieldKind::BINARY;
+    };
+
+    template<typename Type, ByteOrder ORDER>
+    struct ConverterKind< Record::EndianConverter<Type, ORDER> > {
+        static const FieldKind value = FieldKind::BINARY;
+    };
+
+    template<typename Type, unsigned SCALE>
+    struct ConverterKind< Record::PackedDecimalConverter<Type, SCALE> > {
+        static const FieldKind value = FieldKind::PACKED_DECIMAL;
+    };
+
+    template<typename Type, unsigned SCALE>
+    struct ConverterKind< Record::ZonedDecimalConverter<Type, SCALE> > {
+        static const FieldKind value = FieldKind::ZONED_DECIMAL;
+    };
+
+    template<>
+    struct ConverterKind< Record::HEXConverter > {
+        static const FieldKind value = FieldKind::HEX;
+    };
+
+    /**
+     * Returns a copy of rec, with storage of its own.
+     */
+    template<typename RecordType>
+    inline RecordType  deepCopy(const RecordType& rec) {
+        RecordType  copy(rec);
+        copy.detach();
+        return copy;
+    }
+
     /**
      * Writes a record binary, to a stream.
+     * For bulk writing, use RecordWriter (RecordStream.hpp) instead.
      */
-    inline std::ostream&  operator <<(std::ostream& os, Record& rec) {
+    inline std::ostream&  operator <<(std::ostream& os, const Record& rec) {
         os.write(rec.begin(), rec.size());
         return os;
     }
 
     /**
-     * Reads a record binary from a stream.
+     * Reads a record binary from a stream, directly into its storage.
+     * For bulk reading, use RecordReader (RecordStream.hpp) instead.
      */
     inline std::istream&  operator >>(std::istream& is, Record& rec) {
-        char  buf[rec.size()];
-        is.read(buf, rec.size());
-        rec << buf;
-
+        is.read(rec.begin(), rec.size());
         return is;
     }
 
@@ -0,0 +1,147 @@
+/*
+ * RecordArena.hpp
+ *
+ *  Pooled storage for many records.
+ */
+
+#ifndef RECORD_ARENA_HPP_
+#define RECORD_ARENA_HPP_
+
+#include <vector>
+#include "RecordStream.hpp"
+
+namespace overlay_record {
+
+    // -----------------------------------------------------
+    // --- class RecordArena
+    // -----------------------------------------------------
+    /**
+     * Hands out record storage from large, cache-line aligned slabs, instead of
+     * one heap allocation per record. Consecutive allocations are adjacent
+     * within a slab, so a batch of records can be written with one write() per slab.
+     * All storage is released, or reused after reset(), at once.
+     *
+     * <pre>
+     *   RecordArena  arena;
+     *   for (...) {
+     *       R  r;
+     *       arena.allocate(r);
+     *       r.txt = "abc";
+     *   }
+     *   arena.writeTo(out);
+     * </pre>
+     */
+    class RecordArena {
+        std::vector<detail::RecordBlock>    slabs;
+        std::vector<size_t>                 used;
+        size_t                              slabSize;
+        size_t                              current = 0;    //slab to allocate from
+
+    public:
+        /**
+         * Default slab size of a RecordArena.
+         */
+        static const size_t  DEFAULT_SLAB_SIZE = 1024 * 1024;
+
+        /**
+         * Descriptor of the used part of a slab.
+         */
+        struct Block {
+            char*       data;
+            size_t      size;
+        };
+
+        explicit RecordArena(size_t slabSize = DEFAULT_SLAB_SIZE) : slabSize(slabSize) {}
+
+        RecordArena(const RecordArena&) = delete;
+        RecordArena&  operator =(const RecordArena&) = delete;
+        RecordArena(RecordArena&&) = default;
+        RecordArena&  operator =(RecordArena&&) = default;
+
+        /**
+         * Returns <em>n</em> zero-filled bytes, valid until reset() or destruction.
+         * Requests larger than the slab size get a slab of their own.
+         */
+        char*   allocate(size_t n) {
+            while (current < slabs.size() && used[current] + n > slabs[current].size()) ++current;
+            if (current == slabs.size()) {
+                slabs.emplace_back(n > slabSize ? n : slabSize, 1);
+                used.push_back(0);
+            }
+
+            char*  storage = slabs[current].data() + used[current];
+            used[current] += n;
+            std::memset(storage, 0x0, n);
+            return storage;
+        }
+
+        /**
+         * Assigns zero-filled storage from this arena to rec.
+         */
+        template<typename RecordType>
+        typename std::enable_if<std::is_base_of<Record, RecordType>::value, RecordType&>::type
+        allocate(RecordType& rec) {
+            const size_t  n = rec.size();
+            rec.assignStaticBuffer(allocate(n), n);
+            return rec;
+        }
+
+        /**
+         * Makes all storage available again, without releasing it.
+         * Records using storage of this arena must not be accessed afterwards.
+         */
+        void    reset() {
+            for (size_t& n : used) n = 0;
+            current = 0;
+        }
+
+        /**
+         * Releases all storage.
+         */
+        void    release() {
+            slabs.clear();
+            used.clear();
+            current = 0;
+        }
+
+        /**
+         * Returns the number of bytes handed out.
+         */
+        size_t  size() const {
+            size_t  total = 0;
+            for (size_t n : used) total += n;
+            return total;
+        }
+
+        /**
+         * Returns the number of bytes reserved.
+         */
+        size_t  capacity() const {
+            size_t  total = 0;
+            for (auto& slab : slabs) total += slab.size();
+            return total;
+        }
+
+        /**
+         * Returns the used part of each slab, in allocation order.
+         */
+        std::vector<Block>  blocks() const {
+            std::vector<Block>  result;
+            for (size_t k = 0; k < slabs.size(); ++k) {
+                if (used[k] > 0) result.push_back({slabs[k].data(), used[k]});
+            }
+            return result;
+        }
+
+        /**
+         * Writes all handed-out storage to os, with one write per slab.
+         */
+        std::ostream&   writeTo(std::ostream& os) const {
+            for (const Block& b : blocks()) os.write(b.data, b.size);
+            return os;
+        }
+    };
+
+}
+
+#endif /* RECORD_ARENA_HPP_ */
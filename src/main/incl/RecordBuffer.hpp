@@ -0,0 +1,203 @@
+/*
+ * RecordBuffer.hpp
+ *
+ *  Owning, growable container of fixed-size records.
+ */
+
+#ifndef RECORD_BUFFER_HPP_
+#define RECORD_BUFFER_HPP_
+
+#include <functional>
+#include "RecordStream.hpp"
+
+namespace overlay_record {
+
+    // -----------------------------------------------------
+    // --- class RecordBuffer
+    // -----------------------------------------------------
+    /**
+     * Contiguous, growable array of fixed-size records, with a std::vector like API.
+     * The storage is cache-line aligned and grows geometrically.
+     * Records are returned as new overlays by value, as with RecordView, which refer to
+     * the storage until the buffer grows and moves its records.
+     * A const buffer hands out read-only records only.
+     *
+     * <pre>
+     *   RecordBuffer<R>  table;
+     *   R  r = table.push_back();
+     *   r.txt = "abc";
+     *   out.write(table.data(), table.size() * table.recordSize());
+     * </pre>
+     */
+    template<typename RecordType>
+    class RecordBuffer {
+        unsigned            stride = Record::layout<RecordType>().size;
+        detail::RecordBlock block;
+        size_t              count  = 0;
+
+        void grow(size_t minCapacity) {
+            size_t  newCapacity = 2 * capacity();
+            if (newCapacity < minCapacity) newCapacity = minCapacity;
+            reserve(newCapacity);
+        }
+
+    public:
+        typedef RecordIterator<RecordType>          iterator;
+        typedef RecordIterator<const RecordType>    const_iterator;
+        typedef RecordType                          value_type;
+        typedef RecordType                          reference;
+        typedef const RecordType                    const_reference;
+        typedef size_t                          size_type;
+
+        RecordBuffer() = default;
+
+        /**
+         * Creates a buffer of <em>n</em> zero-filled records.
+         */
+        explicit RecordBuffer(size_t n) {
+            resize(n);
+        }
+
+        RecordBuffer(const RecordBuffer& that) {
+            reserve(that.count);
+            if (that.count > 0) std::memcpy(block.data(), that.block.data(), that.count * stride);
+            count = that.count;
+        }
+
+        RecordBuffer(RecordBuffer&& that) : block(std::move(that.block)), count(that.count) {
+            that.count = 0;
+        }
+
+        RecordBuffer&  operator =(RecordBuffer that) {
+            std::swap(block, that.block);
+            std::swap(count, that.count);
+            return *this;
+        }
+
+        /**
+         * Returns the number of records.
+         */
+        size_t      size()     const { return count; }
+        bool        empty()    const { return count == 0; }
+
+        /**
+         * Returns the number of records that fit without growing.
+         */
+        size_t      capacity() const { return block.size() / stride; }
+
+        /**
+         * Returns the record size in number of bytes.
+         */
+        unsigned    recordSize() const { return stride; }
+
+        /**
+         * Returns the start address of the first record.
+         * The records are contiguous, so size() * recordSize() bytes can be written as is.
+         */
+        char*       data()       { return block.data(); }
+        const char* data() const { return block.data(); }
+
+        /**
+         * Makes room for at least <em>n</em> records.
+         */
+        void reserve(size_t n) {
+            if (n <= capacity()) return;
+            detail::RecordBlock  larger(n * stride, stride);
+            if (count > 0) std::memcpy(larger.data(), block.data(), count * stride);
+            block = std::move(larger);
+        }
+
+        /**
+         * Changes the number of records. New records are zero-filled.
+         */
+        void resize(size_t n) {
+            if (n > capacity()) grow(n);
+            if (n > count) std::memset(block.data() + count * stride, 0x0, (n - count) * stride);
+            count = n;
+        }
+
+        void clear() {
+            count = 0;
+        }
+
+        /**
+         * Appends a zero-filled record and returns an overlay of it.
+         */
+        reference   push_back() {
+            if (count == capacity()) grow(count + 1);
+            std::memset(block.data() + count * stride, 0x0, stride);
+            return (*this)[count++];
+        }
+
+        /**
+         * Appends a copy of rec, which may be a record of this buffer.
+         * Throws StorageOverflow if rec is not of the record size.
+         */
+        reference   push_back(const Record& rec) {
+            if (rec.size() != stride) throw StorageOverflow();
+            const char*  src = rec.begin();
+            if (count == capacity()) {
+                const char*  first  = block.data();
+                const bool   inside = !std::less<const char*>()(src, first)
+                                      && std::less<const char*>()(src, first + count * stride);
+                const size_t at     = inside ? src - first : 0;
+                grow(count + 1);
+                if (inside) src = block.data() + at;
+            }
+            std::memcpy(block.data() + count * stride, src, stride);
+            return (*this)[count++];
+        }
+
+        void pop_back() {
+            if (count > 0) --count;
+        }
+
+        /**
+         * Returns an overlay of record ix, without bounds check.
+         */
+        reference   operator [](size_t ix) {
+            return detail::RangeTraits<RecordType>::at(block.data() + ix * stride);
+        }
+
+        const_reference  operator [](size_t ix) const {
+            return detail::RangeTraits<const RecordType>::at(block.data() + ix * stride);
+        }
+
+        /**
+         * Returns record ix, with bounds check.
+         */
+        reference   at(size_t ix) {
+            if (ix >= count) throw IndexOutOfBounds(ix, count);
+            return (*this)[ix];
+        }
+
+        const_reference  at(size_t ix) const {
+            if (ix >= count) throw IndexOutOfBounds(ix, count);
+            return (*this)[ix];
+        }
+
+        reference        front()       { return (*this)[0]; }
+        const_reference  front() const { return (*this)[0]; }
+        reference        back()        { return (*this)[count - 1]; }
+        const_reference  back()  const { return (*this)[count - 1]; }
+
+        iterator        begin()       { return iterator(block.data(), stride); }
+        const_iterator  begin() const { return const_iterator(block.data(), stride); }
+        iterator        end()         { return iterator(block.data() + count * stride, stride); }
+        const_iterator  end()   const { return const_iterator(block.data() + count * stride, stride); }
+
+        /**
+         * Returns the records as a view.
+         */
+        RecordView<RecordType>  view() {
+            return RecordView<RecordType>(block.data(), block.data() + count * stride);
+        }
+
+        RecordView<const RecordType>  view() const {
+            return RecordView<const RecordType>(block.data(), block.data() + count * stride);
+        }
+    };
+
+}
+
+#endif /* RECORD_BUFFER_HPP_ */
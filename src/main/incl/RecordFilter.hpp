@@ -0,0 +1,354 @@
+/*
+ * RecordFilter.hpp
+ *
+ *  Selection of records by predicates on their raw field bytes.
+ */
+
+#ifndef RECORD_FILTER_HPP_
+#define RECORD_FILTER_HPP_
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include "Column.hpp"
+#include "RecordView.hpp"
+
+namespace overlay_record {
+
+    namespace detail {
+        /**
+         * Number of records evaluated together by a RecordFilter.
+         */
+        const size_t  FILTER_BLOCK = 1024;
+
+        /**
+         * Type of a bound on a numeric field; not deduced, so that e.g. an int bound fits a long field.
+         */
+        template<typename Type>
+        using NumericBound = typename std::enable_if<std::is_arithmetic<Type>::value, Type>::type;
+
+        /**
+         * Condition on one field of a record, evaluated for a block of records at a time.
+         * Candidates are indexes of records within the block, in ascending order.
+         */
+        struct RecordPredicate {
+            virtual ~RecordPredicate() = default;
+
+            /**
+             * Writes the indexes of the matching records among all n records at base to sel.
+             * Returns the number of matches.
+             */
+            virtual size_t  selectAll(const char* base, size_t stride, size_t n, uint32_t* sel) const = 0;
+
+            /**
+             * Keeps the matching records of the n candidates in sel, in place.
+             * Returns the number of matches.
+             */
+            virtual size_t  refine(const char* base, size_t stride, uint32_t* sel, size_t n) const = 0;
+        };
+
+        /**
+         * Writes the indexes of the set flags among match[0..n) to sel, without branching.
+         */
+        inline size_t  compact(const uint8_t* match, size_t n, uint32_t* sel) {
+            size_t  count = 0;
+            for (size_t k = 0; k < n; ++k) {
+                sel[count] = (uint32_t)k;
+                count += match[k];
+            }
+            return count;
+        }
+
+        /**
+         * Lower and upper bounds on a numeric field. The values of a block are extracted
+         * with the field's ColumnKernel, and compared in a loop the compiler can vectorize.
+         */
+        template<typename Type, typename C>
+        class RangePredicate : public RecordPredicate {
+            unsigned    offset, size;
+            Type        lo, hi;
+            bool        loInclusive, hiInclusive;
+
+            bool  matches(Type v) const {
+                return ((v > lo) | ((v == lo) & loInclusive)) & ((v < hi) | ((v == hi) & hiInclusive));
+            }
+
+        public:
+            RangePredicate(unsigned offset, unsigned size, Type lo, bool loInclusive, Type hi, bool hiInclusive)
+                : offset(offset), size(size), lo(lo), hi(hi), loInclusive(loInclusive), hiInclusive(hiInclusive) {}
+
+            size_t  selectAll(const char* base, size_t stride, size_t n, uint32_t* sel) const override {
+                Type     values[FILTER_BLOCK];
+                uint8_t  match[FILTER_BLOCK];
+                ColumnKernel<C>::extract(base + offset, size, stride, n, values);
+                for (size_t k = 0; k < n; ++k) match[k] = matches(values[k]);
+                return compact(match, n, sel);
+            }
+
+            size_t  refine(const char* base, size_t stride, uint32_t* sel, size_t n) const override {
+                size_t  count = 0;
+                for (size_t k = 0; k < n; ++k) {
+                    Type  v;
+                    ColumnKernel<C>::extract(base + sel[k] * stride + offset, size, stride, 1, &v);
+                    sel[count] = sel[k];
+                    count += matches(v);
+                }
+                return count;
+            }
+        };
+
+        /**
+         * Equality with, or prefix of, a text field, compared on the stored bytes.
+         * As with TextConverter::fromStorage(), trailing NUL characters count as padding.
+         * Fields of at most 16 bytes are compared with one SSE2 load per record, where available.
+         */
+        template<char PAD>
+        class TextPredicate : public RecordPredicate {
+            unsigned        offset, size;
+            std::string     value;
+            bool            prefix;
+            bool            impossible;
+#if defined(__SSE2__)
+            char            pattern[16];    //value, then PAD
+            unsigned        checkMask;      //bytes to compare
+            unsigned        padMask;        //bytes that may also be NUL
+#endif
+
+            bool  matches(const char* p) const {
+                const size_t  n = value.size();
+                if (std::memcmp(p, value.data(), n) != 0) return false;
+                if (prefix) return true;
+                for (size_t k = n; k < size; ++k) if (p[k] != PAD && p[k] != '\0') return false;
+                return true;
+            }
+
+        public:
+            TextPredicate(unsigned offset, unsigned size, const TextView& v, bool prefix)
+                : offset(offset), size(size), value(prefix ? v.str() : v.trimmed(PAD).str()),
+                  prefix(prefix), impossible(value.size() > size) {
+#if defined(__SSE2__)
+                std::memset(pattern, PAD, sizeof(pattern));
+                std::memcpy(pattern, value.data(), std::min<size_t>(value.size(), sizeof(pattern)));
+                const unsigned  valueMask = (1U << std::min<size_t>(value.size(), 16)) - 1;
+                checkMask = prefix ? valueMask : (1U << std::min(size, 16U)) - 1;
+                padMask   = checkMask & ~valueMask;
+#endif
+            }
+
+            size_t  selectAll(const char* base, size_t stride, size_t n, uint32_t* sel) const override {
+                if (impossible) return 0;
+                const char*  p = base + offset;
+                size_t  count = 0;
+                size_t  k = 0;
+#if defined(__SSE2__)
+                if (size <= 16) {
+                    const __m128i  expected = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pattern));
+                    const __m128i  zero     = _mm_setzero_si128();
+                    const char*    end      = base + n * stride;
+                    for (; k < n && p + 16 <= end; ++k, p += stride) {
+                        const __m128i   x     = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+                        const unsigned  equal = _mm_movemask_epi8(_mm_cmpeq_epi8(x, expected));
+                        const unsigned  nul   = _mm_movemask_epi8(_mm_cmpeq_epi8(x, zero));
+                        sel[count] = (uint32_t)k;
+                        count += ((equal | (nul & padMask)) & checkMask) == checkMask;
+                    }
+                }
+#endif
+                for (; k < n; ++k, p += stride) {
+                    sel[count] = (uint32_t)k;
+                    count += matches(p);
+                }
+                return count;
+            }
+
+            size_t  refine(const char* base, size_t stride, uint32_t* sel, size_t n) const override {
+                if (impossible) return 0;
+                size_t  count = 0;
+                for (size_t k = 0; k < n; ++k) {
+                    sel[count] = sel[k];
+                    count += matches(base + sel[k] * stride + offset);
+                }
+                return count;
+            }
+        };
+    }
+
+
+    // -----------------------------------------------------
+    // --- class RecordFilter
+    // -----------------------------------------------------
+    /**
+     * Selects the records of RecordType that satisfy all of a set of field conditions,
+     * evaluated directly on the field bytes at their known offsets, without overlays
+     * and without converting the rejected records.
+     *
+     * Records are evaluated in blocks. The first condition is applied to every record of
+     * a block, and each further condition only to the records still selected, so conditions
+     * are best added in order of selectivity.
+     *
+     * <pre>
+     *   R  proto;
+     *   RecordFilter<R>  filter;
+     *   filter.equals(proto.status, "OK").greater(proto.amount, 1000);
+     *   std::vector<size_t>  rows = filter.select(file.records());
+     * </pre>
+     */
+    template<typename RecordType>
+    class RecordFilter {
+        std::vector<std::unique_ptr<detail::RecordPredicate>>   predicates;
+        unsigned    stride = Record::layout<RecordType>().size;
+
+        template<typename Field>
+        unsigned  offsetOf(const Field& field) const {
+            const unsigned  offset = field.outerOffset();
+            if (offset + field.size() > stride) throw IndexOutOfBounds(offset + field.size(), stride);
+            return offset;
+        }
+
+        template<typename Type, unsigned N, typename C>
+        RecordFilter&  bounds(const Record::Field<Type, N, C>& field, Type lo, bool loInclusive, Type hi, bool hiInclusive) {
+            static_assert(std::is_arithmetic<Type>::value, "Requires a numeric field");
+            predicates.emplace_back(new detail::RangePredicate<Type, C>(offsetOf(field), N, lo, loInclusive, hi, hiInclusive));
+            return *this;
+        }
+
+        template<typename Type>
+        static Type  lowest()  { return std::numeric_limits<Type>::lowest(); }
+
+        template<typename Type>
+        static Type  highest() { return std::numeric_limits<Type>::max(); }
+
+        /**
+         * Invokes sink(base index, selection, count) for each block with matches.
+         */
+        template<typename Sink>
+        void  scan(const char* base, size_t n, Sink sink) const {
+            uint32_t  sel[detail::FILTER_BLOCK];
+            for (size_t first = 0; first < n; first += detail::FILTER_BLOCK) {
+                const size_t  m     = std::min(detail::FILTER_BLOCK, n - first);
+                const char*   block = base + first * stride;
+
+                size_t  count = m;
+                if (predicates.empty()) {
+                    for (size_t k = 0; k < m; ++k) sel[k] = (uint32_t)k;
+                } else {
+                    count = predicates[0]->selectAll(block, stride, m, sel);
+                    for (size_t p = 1; p < predicates.size() && count > 0; ++p) {
+                        count = predicates[p]->refine(block, stride, sel, count);
+                    }
+                }
+                if (count > 0) sink(first, sel, count);
+            }
+        }
+
+    public:
+        /**
+         * Requires a text field to equal value, ignoring trailing padding.
+         */
+        template<unsigned N, char PAD>
+        RecordFilter&  equals(const Record::Field<std::string, N, Record::TextConverter<PAD>>& field, const TextView& value) {
+            predicates.emplace_back(new detail::TextPredicate<PAD>(offsetOf(field), N, value, false));
+            return *this;
+        }
+
+        /**
+         * Requires a text field to start with prefix.
+         */
+        template<unsigned N, char PAD>
+        RecordFilter&  startsWith(const Record::Field<std::string, N, Record::TextConverter<PAD>>& field, const TextView& prefix) {
+            predicates.emplace_back(new detail::TextPredicate<PAD>(offsetOf(field), N, prefix, true));
+            return *this;
+        }
+
+        /**
+         * Requires a numeric field to equal value.
+         */
+        template<typename Type, unsigned N, typename C>
+        RecordFilter&  equals(const Record::Field<Type, N, C>& field, detail::NumericBound<Type> value) {
+            return bounds(field, value, true, value, true);
+        }
+
+        /**
+         * Requires lo <= field <= hi, for a numeric field.
+         */
+        template<typename Type, unsigned N, typename C>
+        RecordFilter&  between(const Record::Field<Type, N, C>& field,
+                                detail::NumericBound<Type> lo, detail::NumericBound<Type> hi) {
+            return bounds(field, lo, true, hi, true);
+        }
+
+        template<typename Type, unsigned N, typename C>
+        RecordFilter&  greater(const Record::Field<Type, N, C>& field, detail::NumericBound<Type> lo) {
+            return bounds(field, lo, false, highest<Type>(), true);
+        }
+
+        template<typename Type, unsigned N, typename C>
+        RecordFilter&  atLeast(const Record::Field<Type, N, C>& field, detail::NumericBound<Type> lo) {
+            return bounds(field, lo, true, highest<Type>(), true);
+        }
+
+        template<typename Type, unsigned N, typename C>
+        RecordFilter&  less(const Record::Field<Type, N, C>& field, detail::NumericBound<Type> hi) {
+            return bounds(field, lowest<Type>(), true, hi, false);
+        }
+
+        template<typename Type, unsigned N, typename C>
+        RecordFilter&  atMost(const Record::Field<Type, N, C>& field, detail::NumericBound<Type> hi) {
+            return bounds(field, lowest<Type>(), true, hi, true);
+        }
+
+        size_t  numConditions() const { return predicates.size(); }
+
+        /**
+         * Returns the indexes of the matching records, among the n consecutive records at base.
+         */
+        std::vector<size_t>  select(const char* base, size_t n) const {
+            std::vector<size_t>  result;
+            scan(base, n, [&](size_t first, const uint32_t* sel, size_t count) {
+                for (size_t k = 0; k < count; ++k) result.push_back(first + sel[k]);
+            });
+            return result;
+        }
+
+        template<typename R>
+        std::vector<size_t>  select(const RecordView<R>& view) const {
+            return select(view.data(), view.size());
+        }
+
+        /**
+         * Returns one bit per record, set for the matching records. Bit k is in word k / 64.
+         */
+        std::vector<uint64_t>  bitmap(const char* base, size_t n) const {
+            std::vector<uint64_t>  result((n + 63) / 64, 0);
+            scan(base, n, [&](size_t first, const uint32_t* sel, size_t count) {
+                for (size_t k = 0; k < count; ++k) {
+                    const size_t  ix = first + sel[k];
+                    result[ix / 64] |= uint64_t(1) << (ix % 64);
+                }
+            });
+            return result;
+        }
+
+        template<typename R>
+        std::vector<uint64_t>  bitmap(const RecordView<R>& view) const {
+            return bitmap(view.data(), view.size());
+        }
+
+        /**
+         * Returns the number of matching records.
+         */
+        size_t  count(const char* base, size_t n) const {
+            size_t  result = 0;
+            scan(base, n, [&](size_t, const uint32_t*, size_t count) { result += count; });
+            return result;
+        }
+
+        template<typename R>
+        size_t  count(const RecordView<R>& view) const {
+            return count(view.data(), view.size());
+        }
+    };
+
+}
+
+#endif /* RECORD_FILTER_HPP_ */
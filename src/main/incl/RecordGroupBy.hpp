@@ -0,0 +1,372 @@
+/*
+ * RecordGroupBy.hpp
+ *
+ *  Aggregation of numeric fields, grouped by a key field.
+ */
+
+#ifndef RECORD_GROUP_BY_HPP_
+#define RECORD_GROUP_BY_HPP_
+
+#include <limits>
+#include "Column.hpp"
+#include "RecordIndex.hpp"
+
+namespace overlay_record {
+
+    /**
+     * Kind of aggregate of a RecordGroupBy.
+     */
+    enum class Aggregate { SUM, COUNT, MIN, MAX };
+
+    /**
+     * The value of an aggregate; integral fields are aggregated as integers, others as doubles.
+     */
+    union AggregateValue {
+        int64_t     i;
+        double      d;
+    };
+
+    namespace detail {
+        /**
+         * Number of records handled per step, with their keys and values in small arrays.
+         */
+        const size_t  GROUP_BATCH = 256;
+
+        /**
+         * One aggregate: the field it reads, and how it combines.
+         */
+        struct AggregateSpec {
+            typedef void (*Load)(const char* p, unsigned size, size_t stride, size_t n, AggregateValue* out);
+
+            unsigned    offset;
+            unsigned    size;
+            Aggregate   kind;
+            bool        integral;
+            Load        load;
+
+            AggregateValue  identity() const {
+                AggregateValue  v;
+                if (integral) {
+                    v.i = kind == Aggregate::MIN ? std::numeric_limits<int64_t>::max()
+                        : kind == Aggregate::MAX ? std::numeric_limits<int64_t>::min() : 0;
+                } else if (kind == Aggregate::COUNT) {
+                    v.i = 0;
+                } else {
+                    v.d = kind == Aggregate::MIN ? std::numeric_limits<double>::infinity()
+                        : kind == Aggregate::MAX ? -std::numeric_limits<double>::infinity() : 0;
+                }
+                return v;
+            }
+
+            void  combine(AggregateValue& acc, const AggregateValue& v) const {
+                if (integral || kind == Aggregate::COUNT) {
+                    switch (kind) {
+                        case Aggregate::SUM:
+                        case Aggregate::COUNT: acc.i += v.i; break;
+                        case Aggregate::MIN:   acc.i = std::min(acc.i, v.i); break;
+                        case Aggregate::MAX:   acc.i = std::max(acc.i, v.i); break;
+                    }
+                } else {
+                    switch (kind) {
+                        case Aggregate::SUM:   acc.d += v.d; break;
+                        case Aggregate::MIN:   acc.d = std::min(acc.d, v.d); break;
+                        case Aggregate::MAX:   acc.d = std::max(acc.d, v.d); break;
+                        case Aggregate::COUNT: break;
+                    }
+                }
+            }
+        };
+
+        template<typename Type, typename C>
+        struct AggregateKernel {
+            static void load(const char* p, unsigned size, size_t stride, size_t n, AggregateValue* out) {
+                Type  values[GROUP_BATCH];
+                ColumnKernel<C>::extract(p, size, stride, n, values);
+                if (std::is_integral<Type>::value) {
+                    for (size_t k = 0; k < n; ++k) out[k].i = static_cast<int64_t>(values[k]);
+                } else {
+                    for (size_t k = 0; k < n; ++k) out[k].d = static_cast<double>(values[k]);
+                }
+            }
+        };
+
+        /**
+         * Groups of one hash partition: an open-addressing table over the groups,
+         * which keep their hash, key bytes, first record ordinal and aggregate values.
+         */
+        template<typename Kernel, unsigned KEY_SIZE>
+        class GroupTable {
+            unsigned                numValues;
+            std::vector<uint64_t>   slots;          //group + 1, or 0
+            uint64_t                mask = 0;
+
+            void  grow() {
+                const size_t  numSlots = slots.empty() ? 16 : 2 * slots.size();
+                slots.assign(numSlots, 0);
+                mask = numSlots - 1;
+                for (size_t g = 0; g < hashes.size(); ++g) {
+                    uint64_t  pos = hashes[g] & mask;
+                    while (slots[pos] != 0) pos = (pos + 1) & mask;
+                    slots[pos] = g + 1;
+                }
+            }
+
+        public:
+            std::vector<uint64_t>           hashes;
+            std::vector<uint64_t>           firsts;
+            std::vector<char>               keys;
+            std::vector<AggregateValue>     values;
+
+            GroupTable(unsigned numValues) : numValues(numValues) {}
+
+            size_t  size() const { return hashes.size(); }
+
+            /**
+             * Returns the group of key, adding it with identity values if new.
+             */
+            size_t  findOrInsert(uint64_t hash, const char* key, uint64_t ordinal, const std::vector<AggregateSpec>& specs) {
+                if (2 * (hashes.size() + 1) > slots.size()) grow();
+                uint64_t  pos = hash & mask;
+                for (; slots[pos] != 0; pos = (pos + 1) & mask) {
+                    const size_t  g = slots[pos] - 1;
+                    if (hashes[g] == hash && equalKeys<Kernel, KEY_SIZE>(&keys[g * KEY_SIZE], key)) {
+                        if (ordinal < firsts[g]) firsts[g] = ordinal;
+                        return g;
+                    }
+                }
+                const size_t  g = hashes.size();
+                slots[pos] = g + 1;
+                hashes.push_back(hash);
+                firsts.push_back(ordinal);
+                keys.insert(keys.end(), key, key + KEY_SIZE);
+                for (const AggregateSpec& spec : specs) values.push_back(spec.identity());
+                return g;
+            }
+
+            AggregateValue*  valuesOf(size_t g) { return &values[g * numValues]; }
+        };
+    }
+
+
+    // -----------------------------------------------------
+    // --- class GroupedValues
+    // -----------------------------------------------------
+    /**
+     * The result of a RecordGroupBy: one row per distinct key, in order of first appearance,
+     * with the aggregates in the order they were added.
+     */
+    template<typename FieldType>
+    class GroupedValues {
+        typedef typename detail::FieldConverter<FieldType>::type  Converter;
+
+        unsigned                        keySize = FieldType::SIZE;
+        std::vector<bool>               integral;
+        std::vector<char>               keys;
+        std::vector<AggregateValue>     values;
+
+        template<typename, typename> friend class RecordGroupBy;
+
+    public:
+        typedef typename FieldType::TYPE    KeyType;
+
+        size_t      size()          const { return keys.size() / keySize; }
+        bool        empty()         const { return keys.empty(); }
+        unsigned    numAggregates() const { return integral.size(); }
+
+        /**
+         * Returns the key bytes of group g.
+         */
+        const char*  keyBytes(size_t g) const { return &keys[g * keySize]; }
+
+        /**
+         * Returns the key of group g, as the field would.
+         */
+        KeyType  key(size_t g) const { return Converter::fromStorage(keyBytes(g), keySize); }
+
+        /**
+         * Returns aggregate a of group g, as an integer or as a double.
+         */
+        int64_t  asInteger(size_t g, unsigned a) const {
+            const AggregateValue&  v = values[g * integral.size() + a];
+            return integral[a] ? v.i : static_cast<int64_t>(v.d);
+        }
+
+        double  asDouble(size_t g, unsigned a) const {
+            const AggregateValue&  v = values[g * integral.size() + a];
+            return integral[a] ? static_cast<double>(v.i) : v.d;
+        }
+    };
+
+
+    // -----------------------------------------------------
+    // --- class RecordGroupBy
+    // -----------------------------------------------------
+    /**
+     * Groups records of RecordType by a key field, and aggregates numeric fields per group,
+     * reading raw field bytes at their offsets (text keys with NUL as padding).
+     * Records are processed in batches: the keys of a batch are hashed and looked up first,
+     * and then each aggregate extracts its column of the batch and folds it into the groups.
+     * Each worker aggregates its chunks into tables of its own, split into partitions by hash,
+     * and the partitions are merged in parallel.
+     * Integral fields are aggregated as 64-bit integers, others as doubles.
+     *
+     * <pre>
+     *   RecordGroupBy<Sale, Sale::Text<4>>  byRegion(proto.region);
+     *   byRegion.count().sum(proto.amount).max(proto.amount);
+     *   GroupedValues<Sale::Text<4>>  totals = byRegion.aggregate(sales);
+     *   for (size_t g = 0; g < totals.size(); ++g)
+     *       std::cout << totals.key(g) << ": " << totals.asInteger(g, 1) << std::endl;
+     * </pre>
+     */
+    template<typename RecordType, typename FieldType>
+    class RecordGroupBy {
+        typedef detail::IndexKeyKernel<typename detail::FieldConverter<FieldType>::type>  Kernel;
+        static const unsigned   KEY_SIZE = FieldType::SIZE;
+        typedef detail::GroupTable<Kernel, KEY_SIZE>  Table;
+
+        unsigned                            stride = Record::layout<RecordType>().size;
+        unsigned                            keyOffset;
+        std::vector<detail::AggregateSpec>  specs;
+
+        template<typename Field>
+        unsigned  offsetOf(const Field& field) const {
+            const unsigned  offset = field.outerOffset();
+            if (offset + field.size() > stride) throw IndexOutOfBounds(offset + field.size(), stride);
+            return offset;
+        }
+
+        template<typename Type, unsigned N, typename C>
+        RecordGroupBy&  add(Aggregate kind, const Record::Field<Type, N, C>& field) {
+            static_assert(std::is_arithmetic<Type>::value, "Aggregates require a numeric field");
+            detail::AggregateSpec  spec;
+            spec.offset   = offsetOf(field);
+            spec.size     = N;
+            spec.kind     = kind;
+            spec.integral = std::is_integral<Type>::value;
+            spec.load     = &detail::AggregateKernel<Type, C>::load;
+            specs.push_back(spec);
+            return *this;
+        }
+
+        /**
+         * Aggregates records [first, last) into the tables of one worker, a batch at a time.
+         */
+        void  aggregateRange(const char* data, size_t first, size_t last, unsigned bits, std::vector<Table>& tables) const {
+            const unsigned  numValues = specs.size();
+            size_t          parts[detail::GROUP_BATCH];
+            size_t          groups[detail::GROUP_BATCH];
+            AggregateValue  values[detail::GROUP_BATCH];
+
+            for (size_t begin = first; begin < last; begin += detail::GROUP_BATCH) {
+                const size_t  n    = std::min(detail::GROUP_BATCH, last - begin);
+                const char*   base = data + begin * stride;
+                for (size_t k = 0; k < n; ++k) {
+                    const char*     key = base + k * stride + keyOffset;
+                    const uint64_t  h   = detail::hashKey<Kernel, KEY_SIZE>(key);
+                    parts[k]  = detail::partitionOf(h, bits);
+                    groups[k] = tables[parts[k]].findOrInsert(h, key, begin + k, specs);
+                }
+
+                for (unsigned a = 0; a < numValues; ++a) {
+                    const detail::AggregateSpec&  spec = specs[a];
+                    if (spec.kind == Aggregate::COUNT) {
+                        for (size_t k = 0; k < n; ++k) ++tables[parts[k]].valuesOf(groups[k])[a].i;
+                        continue;
+                    }
+                    spec.load(base + spec.offset, spec.size, stride, n, values);
+                    for (size_t k = 0; k < n; ++k) spec.combine(tables[parts[k]].valuesOf(groups[k])[a], values[k]);
+                }
+            }
+        }
+
+    public:
+        /**
+         * Groups by a key field of a prototype record.
+         */
+        RecordGroupBy(const FieldType& key) : keyOffset(offsetOf(key)) {}
+
+        /**
+         * Adds an aggregate of a numeric field of the prototype. Aggregates are numbered in the order added.
+         */
+        template<typename Type, unsigned N, typename C>
+        RecordGroupBy&  sum(const Record::Field<Type, N, C>& field) { return add(Aggregate::SUM, field); }
+
+        template<typename Type, unsigned N, typename C>
+        RecordGroupBy&  min(const Record::Field<Type, N, C>& field) { return add(Aggregate::MIN, field); }
+
+        template<typename Type, unsigned N, typename C>
+        RecordGroupBy&  max(const Record::Field<Type, N, C>& field) { return add(Aggregate::MAX, field); }
+
+        /**
+         * Adds the number of records of each group.
+         */
+        RecordGroupBy&  count() {
+            detail::AggregateSpec  spec;
+            spec.offset   = 0;
+            spec.size     = 0;
+            spec.kind     = Aggregate::COUNT;
+            spec.integral = true;
+            spec.load     = nullptr;
+            specs.push_back(spec);
+            return *this;
+        }
+
+        size_t  numAggregates() const { return specs.size(); }
+
+        /**
+         * Aggregates n records at data, in parallel.
+         */
+        GroupedValues<FieldType>  aggregate(const char* data, size_t n, const ParallelOptions& options = ParallelOptions()) const {
+            const detail::ChunkPlan  plan(n, stride, options);
+            const unsigned  numWorkers = plan.numWorkers;
+            unsigned  bits = 0;
+            while (numWorkers > 1 && (1U << bits) < 4 * numWorkers) ++bits;
+            const size_t  numParts  = size_t(1) << bits;
+            const unsigned  numValues = specs.size();
+
+            std::vector< std::vector<Table> >  tables(numWorkers, std::vector<Table>(numParts, Table(numValues)));
+            detail::runTasks(plan.numChunks, numWorkers, [&](unsigned w, size_t chunk) {
+                const size_t  first = chunk * plan.chunkRecords;
+                aggregateRange(data, first, std::min(n, first + plan.chunkRecords), bits, tables[w]);
+            });
+
+            detail::runTasks(numParts, numWorkers, [&](unsigned, size_t p) {
+                Table&  target = tables[0][p];
+                for (unsigned w = 1; w < numWorkers; ++w) {
+                    Table&  source = tables[w][p];
+                    for (size_t g = 0; g < source.size(); ++g) {
+                        const size_t  t = target.findOrInsert(source.hashes[g], &source.keys[g * KEY_SIZE], source.firsts[g], specs);
+                        for (unsigned a = 0; a < numValues; ++a)
+                            specs[a].combine(target.valuesOf(t)[a], source.valuesOf(g)[a]);
+                    }
+                }
+            });
+
+            std::vector< std::pair<uint64_t, std::pair<size_t, size_t>> >  order;     //first ordinal, partition, group
+            for (size_t p = 0; p < numParts; ++p) {
+                const Table&  table = tables[0][p];
+                for (size_t g = 0; g < table.size(); ++g) order.push_back(std::make_pair(table.firsts[g], std::make_pair(p, g)));
+            }
+            std::sort(order.begin(), order.end());
+
+            GroupedValues<FieldType>  result;
+            for (const detail::AggregateSpec& spec : specs) result.integral.push_back(spec.integral || spec.kind == Aggregate::COUNT);
+            result.keys.reserve(order.size() * KEY_SIZE);
+            result.values.reserve(order.size() * numValues);
+            for (const auto& o : order) {
+                Table&  table = tables[0][o.second.first];
+                const size_t  g = o.second.second;
+                result.keys.insert(result.keys.end(), &table.keys[g * KEY_SIZE], &table.keys[g * KEY_SIZE] + KEY_SIZE);
+                result.values.insert(result.values.end(), table.valuesOf(g), table.valuesOf(g) + numValues);
+            }
+            return result;
+        }
+
+        GroupedValues<FieldType>  aggregate(const RecordView<const RecordType>& view, const ParallelOptions& options = ParallelOptions()) const {
+            return aggregate(view.data(), view.size(), options);
+        }
+    };
+
+}
+
+#endif /* RECORD_GROUP_BY_HPP_ */
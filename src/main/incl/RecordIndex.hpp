@@ -0,0 +1,568 @@
+/*
+ * RecordIndex.hpp
+ *
+ *  Hash index of records, keyed by the bytes of a field.
+ */
+
+#ifndef RECORD_INDEX_HPP_
+#define RECORD_INDEX_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <system_error>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "Parallel.hpp"
+
+namespace overlay_record {
+
+    namespace detail {
+        /**
+         * Number of keys hashed ahead of probing, in RecordIndex::lookup().
+         */
+        const size_t  INDEX_BATCH = 32;
+
+        /**
+         * The converter of a field type.
+         */
+        template<typename FieldType>
+        struct FieldConverter;
+
+        template<typename Type, unsigned N, typename C>
+        struct FieldConverter< Record::Field<Type, N, C> > {
+            typedef C   type;
+        };
+
+        /**
+         * Loading of key bytes, eight at a time, and encoding of key values.
+         * Keys compare by their raw bytes.
+         */
+        template<typename C>
+        struct IndexKeyKernel {
+            static uint64_t  normalize(uint64_t word) { return word; }
+
+            template<typename Value>
+            static bool  encode(const Value& v, char* key, unsigned size) {
+                C::toStorage(v, key, size);
+                return true;
+            }
+        };
+
+        /**
+         * Text keys compare with NUL as padding. The NUL bytes of a word are found
+         * without branches, and replaced by PAD.
+         */
+        template<char PAD>
+        struct IndexKeyKernel< Record::TextConverter<PAD> > {
+            static uint64_t  normalize(uint64_t word) {
+                const uint64_t  LOW7  = 0x7F7F7F7F7F7F7F7FULL;
+                const uint64_t  ONES  = 0x0101010101010101ULL;
+                const uint64_t  zeros = ~(((word & LOW7) + LOW7) | word | LOW7);     //0x80 for each NUL byte
+                const uint64_t  mask  = (zeros >> 7) * 0xFF;
+                return (word & ~mask) | (ONES * static_cast<unsigned char>(PAD) & mask);
+            }
+
+            static bool  encode(const std::string& v, char* key, unsigned size) {
+                if (v.size() > size) return false;      //cannot match
+                Record::TextConverter<PAD>::toStorage(v, key, size);
+                return true;
+            }
+        };
+
+        template<typename Kernel, unsigned N>
+        inline uint64_t  loadKeyWord(const char* p) {
+            uint64_t  word = 0;
+            std::memcpy(&word, p, N);
+            return Kernel::normalize(word);
+        }
+
+        /**
+         * Hashes the SIZE key bytes a word at a time, and mixes the result (MurmurHash3 finalizer).
+         * As SIZE is a constant, the loads are inlined and the loop unrolled.
+         */
+        template<typename Kernel, unsigned SIZE>
+        inline uint64_t  hashKey(const char* p) {
+            uint64_t  h = SIZE * 0x9E3779B97F4A7C15ULL;
+            for (unsigned k = 0; k < SIZE; k += 8) {
+                uint64_t  w = (SIZE - k < 8 ? loadKeyWord<Kernel, SIZE % 8>(p + k) : loadKeyWord<Kernel, 8>(p + k))
+                              * 0x87C37B91114253D5ULL;
+                h ^= (w << 31) | (w >> 33);
+                h  = ((h << 27) | (h >> 37)) * 5 + 0x52DCE729;
+            }
+            h ^= h >> 33;  h *= 0xFF51AFD7ED558CCDULL;
+            h ^= h >> 33;  h *= 0xC4CEB9FE1A85EC53ULL;
+            h ^= h >> 33;
+            return h;
+        }
+
+        template<typename Kernel, unsigned SIZE>
+        inline bool  equalKeys(const char* a, const char* b) {
+            for (unsigned k = 0; k < SIZE; k += 8) {
+                if (SIZE - k < 8) return loadKeyWord<Kernel, SIZE % 8>(a + k) == loadKeyWord<Kernel, SIZE % 8>(b + k);
+                if (loadKeyWord<Kernel, 8>(a + k) != loadKeyWord<Kernel, 8>(b + k)) return false;
+            }
+            return true;
+        }
+
+        /**
+         * Returns the partition of a hash, among 2^bits partitions, by its top bits.
+         */
+        inline unsigned  partitionOf(uint64_t hash, unsigned bits) {
+            return bits == 0 ? 0 : static_cast<unsigned>(hash >> (64 - bits));
+        }
+
+        /**
+         * Layout of an index file: this header, followed by the slots and then the chain of duplicates.
+         */
+        struct IndexFileHeader {
+            static const uint32_t  VERSION = 2;
+
+            char        magic[8];
+            uint32_t    version;
+            uint32_t    keyOffset;
+            uint32_t    keySize;
+            uint32_t    recordSize;
+            uint64_t    numRecords;
+            uint64_t    numSlots;
+            uint64_t    numKeys;
+
+            static const char*  MAGIC() { return "OVLINDEX"; }
+        };
+
+        /**
+         * An index file, mapped read-only.
+         */
+        class MappedIndexFile {
+            int         fd      = -1;
+            char*       storage = nullptr;
+            size_t      length  = 0;
+
+            static std::system_error  failure(const std::string& what, const std::string& path) {
+                return std::system_error(errno, std::generic_category(), what + " " + path);
+            }
+
+            void release() {
+                if (storage != nullptr) ::munmap(storage, length);
+                if (fd >= 0) ::close(fd);
+                fd      = -1;
+                storage = nullptr;
+            }
+
+        public:
+            MappedIndexFile(const std::string& path) {
+                fd = ::open(path.c_str(), O_RDONLY);
+                if (fd < 0) throw failure("open", path);
+
+                struct stat  st;
+                if (::fstat(fd, &st) < 0) {
+                    std::system_error  err = failure("fstat", path);
+                    ::close(fd);
+                    throw err;
+                }
+                length = st.st_size;
+                if (length < sizeof(IndexFileHeader)) {
+                    ::close(fd);
+                    throw std::runtime_error("Not an index file: " + path);
+                }
+
+                void*  addr = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+                if (addr == MAP_FAILED) {
+                    std::system_error  err = failure("mmap", path);
+                    ::close(fd);
+                    throw err;
+                }
+                storage = static_cast<char*>(addr);
+                ::madvise(storage, length, MADV_RANDOM);
+
+                const IndexFileHeader&  h = header();
+                const bool  valid = std::memcmp(h.magic, IndexFileHeader::MAGIC(), sizeof(h.magic)) == 0
+                                    && h.version == IndexFileHeader::VERSION
+                                    && h.numSlots > 0 && (h.numSlots & (h.numSlots - 1)) == 0
+                                    && length == sizeof(IndexFileHeader) + (h.numSlots + h.numRecords) * sizeof(uint64_t);
+                if (!valid) {
+                    release();
+                    throw std::runtime_error("Not an index file: " + path);
+                }
+            }
+
+            MappedIndexFile(const MappedIndexFile&) = delete;
+            MappedIndexFile&  operator =(const MappedIndexFile&) = delete;
+
+            ~MappedIndexFile() {
+                release();
+            }
+
+            const IndexFileHeader&  header() const {
+                return *reinterpret_cast<const IndexFileHeader*>(storage);
+            }
+
+            const uint64_t*  slots() const {
+                return reinterpret_cast<const uint64_t*>(storage + sizeof(IndexFileHeader));
+            }
+
+            const uint64_t*  chain() const {
+                return slots() + header().numSlots;
+            }
+        };
+    }
+
+
+    // -----------------------------------------------------
+    // --- class RecordIndex
+    // -----------------------------------------------------
+    /**
+     * A hash index of records of RecordType, keyed by one field, mapping keys to record ordinals.
+     * The index hashes the raw field bytes, and lives in an open-addressing table
+     * with linear probing, where each slot holds one distinct key, as the ordinal of its
+     * first record and some bits of its hash. The further records with that key are chained,
+     * in ascending order, so duplicate keys never lengthen the probe sequences.
+     * Keys are compared in the records themselves, so the records must stay in place
+     * while the index is used. Text keys compare with NUL as padding.
+     * Records with equal keys are all indexed; find() returns the first of them.
+     *
+     * An index can be saved to a sidecar file, and later mapped into memory
+     * instead of being built again.
+     *
+     * <pre>
+     *   MappedRecordFile<const Customer>  customers("customers.dat");
+     *   Customer  proto;
+     *   RecordIndex<Customer, Customer::Text<10>>  index(proto.id);
+     *   index.build(customers.records());
+     *   const Customer  c = customers[index.find("C000042")];
+     * </pre>
+     */
+    template<typename RecordType, typename FieldType>
+    class RecordIndex {
+    public:
+        typedef uint64_t    Ordinal;
+        typedef typename FieldType::TYPE    KeyType;
+
+        static const Ordinal    NOT_FOUND = ~Ordinal(0);
+        static const unsigned   ORDINAL_BITS = 40;      //the remaining bits of a slot hold hash bits
+        static const unsigned   KEY_SIZE = FieldType::SIZE;
+
+    private:
+        typedef detail::IndexKeyKernel<typename detail::FieldConverter<FieldType>::type>  Kernel;
+
+        static const uint64_t   ORDINAL_MASK = (uint64_t(1) << ORDINAL_BITS) - 1;
+        static const uint64_t   MIN_SLOTS = 16;
+
+        unsigned                stride = Record::layout<RecordType>().size;
+        unsigned                offset;
+        const char*             records    = nullptr;
+        size_t                  numRecords = 0;
+        uint64_t                distinct   = 0;
+        std::vector<uint64_t>   table;
+        std::vector<uint64_t>   links;      //per record, the next ordinal + 1 with the same key, or 0
+        std::shared_ptr<detail::MappedIndexFile>    mapping;
+        const uint64_t*         slots = nullptr;
+        const uint64_t*         chain = nullptr;
+        uint64_t                mask  = 0;
+
+        template<typename Field>
+        static unsigned  offsetOf(const Field& field, unsigned stride) {
+            const unsigned  offset = field.outerOffset();
+            if (offset + field.size() > stride) throw IndexOutOfBounds(offset + field.size(), stride);
+            return offset;
+        }
+
+        static uint64_t  hash(const char* key) {
+            return detail::hashKey<Kernel, KEY_SIZE>(key);
+        }
+
+        static uint64_t  entry(uint64_t hash, Ordinal ordinal) {
+            return (hash & ~ORDINAL_MASK) | (ordinal + 1);
+        }
+
+        const char*  keyOf(uint64_t slot) const {
+            return records + ((slot & ORDINAL_MASK) - 1) * stride + offset;
+        }
+
+        Ordinal  probe(const char* key, uint64_t h) const {
+            const uint64_t  tag = h & ~ORDINAL_MASK;
+            for (uint64_t pos = h & mask;; pos = (pos + 1) & mask) {
+                const uint64_t  slot = slots[pos];
+                if (slot == 0) return NOT_FOUND;
+                if ((slot & ~ORDINAL_MASK) == tag && detail::equalKeys<Kernel, KEY_SIZE>(keyOf(slot), key))
+                    return (slot & ORDINAL_MASK) - 1;
+            }
+        }
+
+        /**
+         * Returns true if slot pos is free, or holds the key of ordinal; in which case
+         * ordinal becomes the first record of the key, ahead of its chain.
+         * Ordinals must be inserted in descending order, to chain them in ascending order.
+         */
+        bool  claim(uint64_t pos, uint64_t h, Ordinal ordinal, const char* key, uint64_t& numKeys) {
+            const uint64_t  slot = table[pos];
+            if (slot != 0 && ((slot & ~ORDINAL_MASK) != (h & ~ORDINAL_MASK)
+                              || !detail::equalKeys<Kernel, KEY_SIZE>(keyOf(slot), key))) return false;
+            if (slot == 0) ++numKeys;
+            links[ordinal] = slot & ORDINAL_MASK;
+            table[pos] = entry(h, ordinal);
+            return true;
+        }
+
+        /**
+         * Inserts into the slots [begin, end) only.
+         * Returns false if the probe sequence runs past end.
+         */
+        bool  insert(uint64_t h, Ordinal ordinal, uint64_t end, uint64_t& numKeys) {
+            const char*  key = records + ordinal * stride + offset;
+            uint64_t  pos = h & mask;
+            while (pos < end && !claim(pos, h, ordinal, key, numKeys)) ++pos;
+            return pos < end;
+        }
+
+        void  insertWrapped(uint64_t h, Ordinal ordinal, uint64_t& numKeys) {
+            const char*  key = records + ordinal * stride + offset;
+            uint64_t  pos = h & mask;
+            while (!claim(pos, h, ordinal, key, numKeys)) pos = (pos + 1) & mask;
+        }
+
+        void  requireBuilt() const {
+            if (slots == nullptr) throw UnInitialized("Index is not built");
+        }
+
+    public:
+        /**
+         * Creates an empty index, for a key field of a prototype record.
+         */
+        RecordIndex(const FieldType& key)
+                : offset(offsetOf(key, stride)) {}
+
+        /**
+         * Indexes n records at data, in parallel. Replaces any previous content.
+         * The table has at least twice as many slots as records, and is split into one region
+         * per worker. The keys are hashed in chunks, counting the keys of each region, and the
+         * ordinals are then scattered by region, so that each worker only visits the keys that hash
+         * into its region. Probe sequences that run past the end of a region are inserted last.
+         * Each region is inserted backwards, so that equal keys are chained in record order.
+         */
+        RecordIndex&  build(const char* data, size_t n, const ParallelOptions& options = ParallelOptions()) {
+            if (n > ORDINAL_MASK) throw std::length_error("Too many records to index: " + std::to_string(n));
+
+            uint64_t  numSlots = MIN_SLOTS;
+            while (numSlots < 2 * n) numSlots *= 2;
+            mapping.reset();
+            table.assign(numSlots, 0);
+            links.resize(n);
+            slots      = table.data();
+            chain      = links.data();
+            mask       = numSlots - 1;
+            records    = data;
+            numRecords = n;
+
+            const detail::ChunkPlan  plan(n, stride, options);
+            const unsigned  numRegions = plan.numWorkers;
+            unsigned  slotBits = 0;
+            while ((uint64_t(1) << slotBits) < numSlots) ++slotBits;
+            auto  regionOf = [&](uint64_t h) {
+                return static_cast<size_t>(((h & mask) * numRegions) >> slotBits);
+            };
+
+            //the hashes are kept in links, where inserting a record replaces its hash by its link
+            std::vector<uint64_t>& hashes = links;
+            std::vector<size_t>    counts(numRegions > 1 ? plan.numChunks * numRegions : 0, 0);
+            detail::runTasks(plan.numChunks, plan.numWorkers, [&](unsigned, size_t chunk) {
+                const size_t  first = chunk * plan.chunkRecords;
+                const size_t  last  = std::min(n, first + plan.chunkRecords);
+                const char*   key   = data + first * stride + offset;
+                for (size_t k = first; k < last; ++k, key += stride) hashes[k] = hash(key);
+                if (numRegions > 1) {
+                    size_t*  count = &counts[chunk * numRegions];
+                    for (size_t k = first; k < last; ++k) ++count[regionOf(hashes[k])];
+                }
+            });
+
+            //the ordinals of region r are byRegion[bounds[r] .. bounds[r+1]-1], in ascending order
+            std::vector<size_t>   bounds(numRegions + 1, n);
+            std::vector<Ordinal>  byRegion;
+            bounds[0] = 0;
+            if (numRegions > 1) {
+                size_t  position = 0;
+                for (size_t r = 0; r < numRegions; ++r) {
+                    bounds[r] = position;
+                    for (size_t c = 0; c < plan.numChunks; ++c) {
+                        const size_t  count = counts[c * numRegions + r];
+                        counts[c * numRegions + r] = position;
+                        position += count;
+                    }
+                }
+                byRegion.resize(n);
+                detail::runTasks(plan.numChunks, plan.numWorkers, [&](unsigned, size_t chunk) {
+                    const size_t  first = chunk * plan.chunkRecords;
+                    const size_t  last  = std::min(n, first + plan.chunkRecords);
+                    size_t*       next  = &counts[chunk * numRegions];
+                    for (size_t k = first; k < last; ++k) byRegion[next[regionOf(hashes[k])]++] = k;
+                });
+            }
+
+            std::vector< std::vector<Ordinal> >  overflow(numRegions);
+            std::vector<uint64_t>                numKeys(numRegions, 0);
+            detail::runTasks(numRegions, plan.numWorkers, [&](unsigned, size_t region) {
+                const uint64_t  end  = (numSlots * (region + 1) + numRegions - 1) / numRegions;
+                uint64_t        keys = 0;
+                for (size_t j = bounds[region + 1]; j-- > bounds[region];) {
+                    const Ordinal  k = numRegions > 1 ? byRegion[j] : j;
+                    if (!insert(hashes[k], k, end, keys)) overflow[region].push_back(k);
+                }
+                numKeys[region] = keys;
+            });
+            distinct = 0;
+            for (size_t r = 0; r < numRegions; ++r) {
+                for (Ordinal k : overflow[r]) insertWrapped(hashes[k], k, distinct);
+                distinct += numKeys[r];
+            }
+            return *this;
+        }
+
+        /**
+         * Indexes the records of a view, such as the records of a MappedRecordFile.
+         */
+        RecordIndex&  build(const RecordView<const RecordType>& view, const ParallelOptions& options = ParallelOptions()) {
+            return build(view.data(), view.size(), options);
+        }
+
+        /**
+         * Writes the index to a file, in the byte order of this machine.
+         */
+        void  save(const std::string& path) const {
+            requireBuilt();
+            detail::IndexFileHeader  header;
+            std::memcpy(header.magic, detail::IndexFileHeader::MAGIC(), sizeof(header.magic));
+            header.version    = detail::IndexFileHeader::VERSION;
+            header.keyOffset  = offset;
+            header.keySize    = KEY_SIZE;
+            header.recordSize = stride;
+            header.numRecords = numRecords;
+            header.numSlots   = numSlots();
+            header.numKeys    = distinct;
+
+            std::ofstream  out(path, std::ios::binary | std::ios::trunc);
+            if (!out) throw std::system_error(errno, std::generic_category(), "open " + path);
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(reinterpret_cast<const char*>(slots), numSlots() * sizeof(uint64_t));
+            out.write(reinterpret_cast<const char*>(chain), numRecords * sizeof(uint64_t));
+            out.flush();
+            if (!out) throw std::system_error(errno, std::generic_category(), "write " + path);
+        }
+
+        /**
+         * Maps an index file written by save(), for the same n records at data.
+         * The slots are paged in on demand, so the index is usable at once.
+         * Throws std::runtime_error if the file was written for another key field or number of records.
+         */
+        RecordIndex&  load(const std::string& path, const char* data, size_t n) {
+            std::shared_ptr<detail::MappedIndexFile>  file = std::make_shared<detail::MappedIndexFile>(path);
+            const detail::IndexFileHeader&  h = file->header();
+            if (h.keyOffset != offset || h.keySize != KEY_SIZE || h.recordSize != stride)
+                throw std::runtime_error("Index file " + path + " has another key field");
+            if (h.numRecords != n)
+                throw std::runtime_error("Index file " + path + " has " + std::to_string(h.numRecords) + " records, not " + std::to_string(n));
+
+            table.clear();
+            table.shrink_to_fit();
+            links.clear();
+            links.shrink_to_fit();
+            mapping    = file;
+            slots      = file->slots();
+            chain      = file->chain();
+            mask       = h.numSlots - 1;
+            records    = data;
+            numRecords = n;
+            distinct   = h.numKeys;
+            return *this;
+        }
+
+        RecordIndex&  load(const std::string& path, const RecordView<const RecordType>& view) {
+            return load(path, view.data(), view.size());
+        }
+
+        /**
+         * Returns the ordinal of the first record with the given key bytes, or NOT_FOUND.
+         */
+        Ordinal  findBytes(const char* key) const {
+            if (slots == nullptr) return NOT_FOUND;
+            return probe(key, hash(key));
+        }
+
+        /**
+         * Returns the ordinal of the first record with the given key, or NOT_FOUND.
+         * The key is encoded as the field would store it.
+         */
+        Ordinal  find(const KeyType& value) const {
+            char  key[KEY_SIZE];
+            if (!Kernel::encode(value, key, KEY_SIZE)) return NOT_FOUND;
+            return findBytes(key);
+        }
+
+        /**
+         * Returns the ordinals of all records with the given key bytes, in ascending order.
+         */
+        std::vector<Ordinal>  findAllBytes(const char* key) const {
+            std::vector<Ordinal>  result;
+            for (Ordinal k = findBytes(key); k != NOT_FOUND; k = chain[k] - 1) result.push_back(k);    //0 - 1 ends the chain
+            return result;
+        }
+
+        std::vector<Ordinal>  findAll(const KeyType& value) const {
+            char  key[KEY_SIZE];
+            if (!Kernel::encode(value, key, KEY_SIZE)) return std::vector<Ordinal>();
+            return findAllBytes(key);
+        }
+
+        /**
+         * Looks up the key field of n records of another type, such as the customer id of orders,
+         * and stores the ordinal of the matching record, or NOT_FOUND, in out[0..n-1].
+         * The keys are hashed in small batches, with their slots prefetched, to overlap the cache misses.
+         */
+        template<typename OtherType>
+        void  lookup(const char* others, size_t n, const FieldType& otherKey, Ordinal* out) const {
+            typedef typename std::remove_const<OtherType>::type  Other;
+            const unsigned  otherStride = Record::layout<Other>().size;
+            const unsigned  otherOffset = offsetOf(otherKey, otherStride);
+            if (slots == nullptr) {
+                std::fill(out, out + n, NOT_FOUND);
+                return;
+            }
+
+            uint64_t  hashes[detail::INDEX_BATCH];
+            for (size_t first = 0; first < n; first += detail::INDEX_BATCH) {
+                const size_t  count = std::min(detail::INDEX_BATCH, n - first);
+                const char*   keys  = others + first * otherStride + otherOffset;
+                for (size_t k = 0; k < count; ++k) {
+                    hashes[k] = hash(keys + k * otherStride);
+#if defined(__GNUC__)
+                    __builtin_prefetch(slots + (hashes[k] & mask));
+#endif
+                }
+                for (size_t k = 0; k < count; ++k) out[first + k] = probe(keys + k * otherStride, hashes[k]);
+            }
+        }
+
+        template<typename OtherType>
+        std::vector<Ordinal>  lookup(const RecordView<OtherType>& others, const FieldType& otherKey) const {
+            std::vector<Ordinal>  result(others.size());
+            lookup<OtherType>(others.data(), others.size(), otherKey, result.data());
+            return result;
+        }
+
+        size_t      size()       const { return numRecords; }
+        uint64_t    numSlots()   const { return slots != nullptr ? mask + 1 : 0; }
+        uint64_t    numKeys()    const { return distinct; }
+        bool        isMapped()   const { return mapping != nullptr; }
+        unsigned    keyOffset()  const { return offset; }
+    };
+
+    template<typename RecordType, typename FieldType>
+    const typename RecordIndex<RecordType, FieldType>::Ordinal  RecordIndex<RecordType, FieldType>::NOT_FOUND;
+
+}
+
+#endif /* RECORD_INDEX_HPP_ */
@@ -0,0 +1,241 @@
+/*
+ * RecordJoin.hpp
+ *
+ *  Equi-join of two record ranges on a key field, by a partitioned hash join.
+ */
+
+#ifndef RECORD_JOIN_HPP_
+#define RECORD_JOIN_HPP_
+
+#include "RecordIndex.hpp"
+
+namespace overlay_record {
+
+    /**
+     * A pair of joined records, by their ordinals.
+     */
+    struct JoinMatch {
+        uint64_t    left;
+        uint64_t    right;
+
+        bool operator ==(const JoinMatch& that) const { return left == that.left && right == that.right; }
+        bool operator <(const JoinMatch& that) const {
+            return left != that.left ? left < that.left : right < that.right;
+        }
+    };
+
+    namespace detail {
+        /**
+         * Approximate size of the smaller side of a partition, to stay in the L2 cache.
+         */
+        const size_t    JOIN_PARTITION_BYTES = 256 * 1024;
+        const unsigned  JOIN_MAX_RADIX_BITS  = 12;
+
+        struct JoinEntry {
+            uint64_t    hash;
+            uint64_t    ordinal;
+        };
+
+        /**
+         * The keys of one side of a join, partitioned by the top bits of their hashes.
+         * Partition p holds entries[bounds[p] .. bounds[p+1]-1], in record order,
+         * with a copy of their key bytes in keys, so that joining a partition stays in its memory.
+         */
+        struct JoinPartitions {
+            std::vector<JoinEntry>  entries;
+            std::vector<char>       keys;
+            std::vector<size_t>     bounds;
+        };
+
+        /**
+         * Radix partitions n keys in one pass. Each worker hashes a contiguous range of records
+         * and counts its partition sizes; after a prefix sum, each worker hashes its range again and
+         * scatters the entries and keys into place.
+         */
+        template<typename Kernel, unsigned KEY_SIZE>
+        void  partitionKeys(const char* keys, size_t n, unsigned stride, unsigned bits, unsigned numWorkers, JoinPartitions& result) {
+            const size_t  numParts  = size_t(1) << bits;
+            const size_t  numRanges = numWorkers;
+            std::vector<size_t>  counts(numRanges * numParts, 0);
+            auto  rangeOf = [&](size_t r, size_t& first, size_t& last) {
+                first = n * r / numRanges;
+                last  = n * (r + 1) / numRanges;
+            };
+
+            runTasks(numRanges, numWorkers, [&](unsigned, size_t r) {
+                size_t  first, last;
+                rangeOf(r, first, last);
+                size_t*  count = &counts[r * numParts];
+                for (size_t k = first; k < last; ++k)
+                    ++count[partitionOf(hashKey<Kernel, KEY_SIZE>(keys + k * stride), bits)];
+            });
+
+            result.bounds.assign(numParts + 1, 0);
+            size_t  position = 0;
+            for (size_t p = 0; p < numParts; ++p) {
+                result.bounds[p] = position;
+                for (size_t r = 0; r < numRanges; ++r) {
+                    const size_t  c = counts[r * numParts + p];
+                    counts[r * numParts + p] = position;
+                    position += c;
+                }
+            }
+            result.bounds[numParts] = position;
+            result.entries.resize(n);
+            result.keys.resize(n * KEY_SIZE);
+
+            runTasks(numRanges, numWorkers, [&](unsigned, size_t r) {
+                size_t  first, last;
+                rangeOf(r, first, last);
+                size_t*  next = &counts[r * numParts];
+                for (size_t k = first; k < last; ++k) {
+                    const char*     key = keys + k * stride;
+                    const uint64_t  h   = hashKey<Kernel, KEY_SIZE>(key);
+                    const size_t    at  = next[partitionOf(h, bits)]++;
+                    result.entries[at].hash    = h;
+                    result.entries[at].ordinal = k;
+                    std::memcpy(&result.keys[at * KEY_SIZE], key, KEY_SIZE);
+                }
+            });
+        }
+    }
+
+
+    // -----------------------------------------------------
+    // --- class RecordJoin
+    // -----------------------------------------------------
+    /**
+     * Inner equi-join of records of LeftType with records of RightType, on key fields
+     * of the same field type, comparing raw field bytes (text with NUL as padding).
+     * The join is a radix-partitioned hash join: the keys of both sides are hashed and split
+     * into partitions small enough for the hash table of a partition to stay in cache,
+     * and the partitions are joined in parallel, building a table of the smaller side of each.
+     * The result lists the ordinals of each joined pair, grouped by partition.
+     *
+     * <pre>
+     *   Order  order;  Customer  customer;
+     *   RecordJoin<Order, Customer, Order::Text<10>>  join(order.customer, customer.id);
+     *   for (const JoinMatch& m : join.join(orders, customers))
+     *       process(orders[m.left], customers[m.right]);
+     * </pre>
+     */
+    template<typename LeftType, typename RightType, typename FieldType>
+    class RecordJoin {
+        typedef detail::IndexKeyKernel<typename detail::FieldConverter<FieldType>::type>  Kernel;
+        static const unsigned   KEY_SIZE = FieldType::SIZE;
+
+        unsigned    leftStride  = Record::layout<LeftType>().size;
+        unsigned    rightStride = Record::layout<RightType>().size;
+        unsigned    leftOffset;
+        unsigned    rightOffset;
+
+        static unsigned  offsetOf(const FieldType& field, unsigned stride) {
+            const unsigned  offset = field.outerOffset();
+            if (offset + field.size() > stride) throw IndexOutOfBounds(offset + field.size(), stride);
+            return offset;
+        }
+
+        /**
+         * Joins one partition: builds a table of the distinct keys of build, with the entries
+         * of equal keys chained in links, and probes it with the entries of probe.
+         */
+        static void  joinPartition(const detail::JoinPartitions& build, size_t buildFirst, size_t buildLast,
+                                   const detail::JoinPartitions& probe, size_t probeFirst, size_t probeLast,
+                                   bool buildIsLeft, std::vector<uint64_t>& table, std::vector<uint64_t>& links,
+                                   std::vector<JoinMatch>& out) {
+            const size_t  n = buildLast - buildFirst;
+            if (n == 0 || probeFirst == probeLast) return;
+
+            size_t  numSlots = 16;
+            while (numSlots < 2 * n) numSlots *= 2;
+            const uint64_t  mask = numSlots - 1;
+            table.assign(numSlots, 0);
+            links.assign(n, 0);
+            const detail::JoinEntry*  entries = &build.entries[buildFirst];
+            const char*               keys    = &build.keys[buildFirst * KEY_SIZE];
+            auto  matches = [&](size_t i, uint64_t hash, const char* key) {
+                return entries[i].hash == hash && detail::equalKeys<Kernel, KEY_SIZE>(keys + i * KEY_SIZE, key);
+            };
+            for (size_t k = n; k-- > 0;) {      //backwards, to chain equal keys in record order
+                uint64_t  pos = entries[k].hash & mask;
+                while (table[pos] != 0 && !matches(table[pos] - 1, entries[k].hash, keys + k * KEY_SIZE))
+                    pos = (pos + 1) & mask;
+                links[k]   = table[pos];
+                table[pos] = k + 1;
+            }
+
+            for (size_t j = probeFirst; j < probeLast; ++j) {
+                const detail::JoinEntry&  e   = probe.entries[j];
+                const char*               key = &probe.keys[j * KEY_SIZE];
+                for (uint64_t pos = e.hash & mask; table[pos] != 0; pos = (pos + 1) & mask) {
+                    if (!matches(table[pos] - 1, e.hash, key)) continue;
+                    for (uint64_t link = table[pos]; link != 0; link = links[link - 1]) {
+                        const detail::JoinEntry&  b = entries[link - 1];
+                        JoinMatch  m;
+                        m.left  = buildIsLeft ? b.ordinal : e.ordinal;
+                        m.right = buildIsLeft ? e.ordinal : b.ordinal;
+                        out.push_back(m);
+                    }
+                    break;
+                }
+            }
+        }
+
+    public:
+        /**
+         * Joins on a key field of a LeftType prototype and one of a RightType prototype.
+         */
+        RecordJoin(const FieldType& leftKey, const FieldType& rightKey)
+                : leftOffset(offsetOf(leftKey, leftStride)), rightOffset(offsetOf(rightKey, rightStride)) {}
+
+        /**
+         * Returns the ordinals of all pairs of records with equal keys,
+         * among nLeft records at left and nRight records at right.
+         */
+        std::vector<JoinMatch>  join(const char* left, size_t nLeft, const char* right, size_t nRight,
+                                     const ParallelOptions& options = ParallelOptions()) const {
+            std::vector<JoinMatch>  result;
+            if (nLeft == 0 || nRight == 0) return result;
+
+            const detail::ChunkPlan  plan(std::max(nLeft, nRight), std::max(leftStride, rightStride), options);
+            const unsigned  numWorkers = plan.numWorkers;
+            const size_t    smaller    = std::min(nLeft, nRight);
+            unsigned  bits = 0;
+            while (bits < detail::JOIN_MAX_RADIX_BITS
+                   && ((smaller * (3 * sizeof(detail::JoinEntry) + KEY_SIZE)) >> bits > detail::JOIN_PARTITION_BYTES
+                       || (numWorkers > 1 && (size_t(1) << bits) < 4 * numWorkers && (smaller >> bits) > 1024))) ++bits;
+
+            detail::JoinPartitions  lefts, rights;
+            detail::partitionKeys<Kernel, KEY_SIZE>(left + leftOffset, nLeft, leftStride, bits, numWorkers, lefts);
+            detail::partitionKeys<Kernel, KEY_SIZE>(right + rightOffset, nRight, rightStride, bits, numWorkers, rights);
+
+            const size_t  numParts = size_t(1) << bits;
+            std::vector< std::vector<JoinMatch> >  matches(numParts);
+            std::vector< std::vector<uint64_t> >   tables(numWorkers), links(numWorkers);
+            detail::runTasks(numParts, numWorkers, [&](unsigned w, size_t p) {
+                const size_t  nl = lefts.bounds[p + 1] - lefts.bounds[p];
+                const size_t  nr = rights.bounds[p + 1] - rights.bounds[p];
+                if (nl <= nr)
+                    joinPartition(lefts, lefts.bounds[p], lefts.bounds[p + 1],
+                                  rights, rights.bounds[p], rights.bounds[p + 1], true, tables[w], links[w], matches[p]);
+                else
+                    joinPartition(rights, rights.bounds[p], rights.bounds[p + 1],
+                                  lefts, lefts.bounds[p], lefts.bounds[p + 1], false, tables[w], links[w], matches[p]);
+            });
+
+            size_t  total = 0;
+            for (const std::vector<JoinMatch>& m : matches) total += m.size();
+            result.reserve(total);
+            for (const std::vector<JoinMatch>& m : matches) result.insert(result.end(), m.begin(), m.end());
+            return result;
+        }
+
+        std::vector<JoinMatch>  join(const RecordView<const LeftType>& left, const RecordView<const RightType>& right,
+                                     const ParallelOptions& options = ParallelOptions()) const {
+            return join(left.data(), left.size(), right.data(), right.size(), options);
+        }
+    };
+
+}
+
+#endif /* RECORD_JOIN_HPP_ */
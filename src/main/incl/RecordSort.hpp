@@ -0,0 +1,422 @@
+/*
+ * RecordSort.hpp
+ *
+ *  Sorting of records by field keys, in memory and external.
+ */
+
+#ifndef RECORD_SORT_HPP_
+#define RECORD_SORT_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <queue>
+#include <system_error>
+#include <thread>
+#include <unistd.h>
+#include "Column.hpp"
+#include "Parallel.hpp"
+#include "RecordStream.hpp"
+
+namespace overlay_record {
+
+    /**
+     * Direction of a sort key.
+     */
+    enum class SortOrder { ASCENDING, DESCENDING };
+
+    /**
+     * Tuning of RecordSort::sortStream().
+     */
+    struct ExternalSortOptions {
+        size_t          memoryBytes = 256 * 1024 * 1024;    //for records being sorted, split over the threads
+        unsigned        threads     = 0;                    //0 means std::thread::hardware_concurrency()
+        std::string     tempDirectory;                      //empty means $TMPDIR, or /tmp
+
+        ExternalSortOptions() = default;
+        ExternalSortOptions(size_t memoryBytes, unsigned threads = 0, const std::string& tempDirectory = "")
+                : memoryBytes(memoryBytes), threads(threads), tempDirectory(tempDirectory) {}
+    };
+
+    namespace detail {
+        /**
+         * Writes v as a big-endian unsigned number, that compares with memcmp() as v compares.
+         */
+        template<typename Type>
+        typename std::enable_if<std::is_integral<Type>::value>::type
+        encodeSortKey(Type v, unsigned char* key) {
+            typedef typename std::make_unsigned<Type>::type  U;
+            U  u = static_cast<U>(v);
+            if (std::is_signed<Type>::value) u ^= U(1) << (8 * sizeof(Type) - 1);
+            for (size_t k = sizeof(Type); k-- > 0;) {
+                key[k] = static_cast<unsigned char>(u & 0xFF);
+                u = static_cast<U>(u >> 8);
+            }
+        }
+
+        template<typename Type>
+        typename std::enable_if<std::is_floating_point<Type>::value>::type
+        encodeSortKey(Type v, unsigned char* key) {
+            typedef typename std::conditional<sizeof(Type) == 4, uint32_t, uint64_t>::type  U;
+            static_assert(sizeof(Type) == sizeof(U), "Requires a 4 or 8 byte floating-point type");
+            U  u;
+            std::memcpy(&u, &v, sizeof(U));
+            const U  sign = U(1) << (8 * sizeof(U) - 1);
+            u = (u & sign) ? ~u : (u | sign);
+            encodeSortKey<U>(u, key);
+        }
+
+        /**
+         * Part of a normalized sort key: the key bytes of one field.
+         */
+        struct SortKeyPart {
+            typedef void (*Encode)(const char* field, unsigned size, unsigned char* key);
+
+            unsigned    offset;
+            unsigned    size;
+            unsigned    width;      //of the key bytes
+            bool        descending;
+            Encode      encode;
+        };
+
+        template<typename Type, typename C>
+        struct SortKeyKernel {
+            static const unsigned  WIDTH = sizeof(Type);
+
+            static void encode(const char* p, unsigned size, unsigned char* key) {
+                Type  v;
+                ColumnKernel<C>::extract(p, size, 0, 1, &v);
+                encodeSortKey(v, key);
+            }
+        };
+
+        /**
+         * Text orders by its bytes, with NUL as padding.
+         */
+        template<char PAD>
+        struct SortKeyKernel<std::string, Record::TextConverter<PAD>> {
+            static void encode(const char* p, unsigned size, unsigned char* key) {
+                for (unsigned k = 0; k < size; ++k) key[k] = static_cast<unsigned char>(p[k] == '\0' ? PAD : p[k]);
+            }
+        };
+
+        template<>
+        struct SortKeyKernel<std::string, Record::HEXConverter> {
+            static void encode(const char* p, unsigned size, unsigned char* key) {
+                std::memcpy(key, p, size);
+            }
+        };
+
+        /**
+         * Creates a unique name for a temporary file.
+         */
+        inline std::string  tempFileName(const std::string& directory) {
+            static std::atomic<unsigned>  counter(0);
+            std::string  dir = directory;
+            if (dir.empty()) {
+                const char*  tmp = std::getenv("TMPDIR");
+                dir = (tmp != nullptr && *tmp != '\0') ? tmp : "/tmp";
+            }
+            return dir + "/overlay-sort-" + std::to_string(::getpid()) + "-" + std::to_string(counter++) + ".run";
+        }
+
+        /**
+         * Removes the files of its names when destroyed.
+         */
+        struct TempFiles {
+            std::vector<std::string>    names;
+
+            TempFiles() = default;
+            TempFiles(const TempFiles&) = delete;
+            TempFiles&  operator =(const TempFiles&) = delete;
+
+            ~TempFiles() {
+                for (const std::string& name : names) std::remove(name.c_str());
+            }
+        };
+
+        inline std::system_error  ioFailure(const std::string& op, const std::string& path) {
+            return std::system_error(errno, std::generic_category(), op + " " + path);
+        }
+    }
+
+
+    // -----------------------------------------------------
+    // --- class RecordSort
+    // -----------------------------------------------------
+    /**
+     * Sorts records of RecordType by one or more key fields.
+     * Each record gets a normalized key, the concatenation of its key fields encoded so that
+     * keys compare with memcmp() as the records should be ordered: text by its bytes,
+     * numbers (binary in either byte order, text, packed or zoned) by their value.
+     * Short keys are sorted with an LSD radix sort, longer keys with a merge sort.
+     * Sorting is stable.
+     *
+     * <pre>
+     *   R  proto;
+     *   RecordSort<R>  sorter;
+     *   sorter.by(proto.name).by(proto.amount, SortOrder::DESCENDING);
+     *   sorter.sort(view);                         //in memory
+     *   sorter.sortStream(in, out);                //external, for files larger than memory
+     * </pre>
+     */
+    template<typename RecordType>
+    class RecordSort {
+        std::vector<detail::SortKeyPart>    parts;
+        unsigned                            stride = Record::layout<RecordType>().size;
+        unsigned                            keyWidth = 0;
+
+        typedef uint64_t    Ordinal;
+
+        template<typename Field>
+        unsigned  offsetOf(const Field& field) const {
+            const unsigned  offset = field.outerOffset();
+            if (offset + field.size() > stride) throw IndexOutOfBounds(offset + field.size(), stride);
+            return offset;
+        }
+
+        template<typename Kernel>
+        static unsigned  widthOf(unsigned, std::true_type)       { return Kernel::WIDTH; }
+
+        template<typename Kernel>
+        static unsigned  widthOf(unsigned size, std::false_type) { return size; }
+
+        /**
+         * Entries of a key followed by the ordinal of its record.
+         */
+        unsigned  entryWidth() const { return keyWidth + sizeof(Ordinal); }
+
+        void  radixSort(std::vector<unsigned char>& entries, size_t n) const {
+            const unsigned  W = entryWidth();
+            std::vector<size_t>  counts(keyWidth * 256, 0);
+            for (size_t k = 0; k < n; ++k) {
+                const unsigned char*  e = &entries[k * W];
+                for (unsigned b = 0; b < keyWidth; ++b) ++counts[b * 256 + e[b]];
+            }
+
+            std::vector<unsigned char>  other(entries.size());
+            for (unsigned b = keyWidth; b-- > 0;) {
+                size_t*  count = &counts[b * 256];
+                if (*std::max_element(count, count + 256) == n) continue;   //all equal
+
+                size_t  sum = 0;
+                for (unsigned v = 0; v < 256; ++v) {
+                    const size_t  c = count[v];
+                    count[v] = sum;
+                    sum += c;
+                }
+                for (size_t k = 0; k < n; ++k) {
+                    const unsigned char*  e = &entries[k * W];
+                    std::memcpy(&other[count[e[b]]++ * W], e, W);
+                }
+                entries.swap(other);
+            }
+        }
+
+        void  mergeSort(std::vector<unsigned char>& entries, size_t n) const {
+            const unsigned  W = entryWidth();
+            const unsigned  K = keyWidth;
+            const unsigned char*  data = entries.data();
+            std::vector<Ordinal>  order(n);
+            for (size_t k = 0; k < n; ++k) order[k] = k;
+            std::stable_sort(order.begin(), order.end(), [&](Ordinal a, Ordinal b) {
+                return std::memcmp(data + a * W, data + b * W, K) < 0;
+            });
+
+            std::vector<unsigned char>  sorted(entries.size());
+            for (size_t k = 0; k < n; ++k) std::memcpy(&sorted[k * W], data + order[k] * W, W);
+            entries.swap(sorted);
+        }
+
+    public:
+        /**
+         * Keys up to this width are sorted by radix sort.
+         */
+        static const unsigned  RADIX_KEY_WIDTH = 16;
+
+        /**
+         * Adds <em>field</em> as the next key. The field is taken from any instance of RecordType.
+         */
+        template<typename Type, unsigned N, typename C>
+        RecordSort&  by(const Record::Field<Type, N, C>& field, SortOrder order = SortOrder::ASCENDING) {
+            typedef detail::SortKeyKernel<Type, C>  Kernel;
+            const unsigned  width = widthOf<Kernel>(N, std::is_arithmetic<Type>());
+            parts.push_back({offsetOf(field), N, width, order == SortOrder::DESCENDING, &Kernel::encode});
+            keyWidth += width;
+            return *this;
+        }
+
+        size_t      numKeys()   const { return parts.size(); }
+        unsigned    keySize()   const { return keyWidth; }
+
+        /**
+         * Writes the normalized key of the record at p, of keySize() bytes.
+         */
+        void  key(const char* p, unsigned char* key) const {
+            for (const detail::SortKeyPart& part : parts) {
+                part.encode(p + part.offset, part.size, key);
+                if (part.descending) for (unsigned k = 0; k < part.width; ++k) key[k] = ~key[k];
+                key += part.width;
+            }
+        }
+
+        /**
+         * Returns the ordinals of the n consecutive records at base, in sorted order.
+         */
+        std::vector<size_t>  order(const char* base, size_t n) const {
+            const unsigned  W = entryWidth();
+            std::vector<unsigned char>  entries(n * W);
+            for (size_t k = 0; k < n; ++k) {
+                unsigned char*  e = &entries[k * W];
+                key(base + k * stride, e);
+                const Ordinal  ordinal = k;
+                std::memcpy(e + keyWidth, &ordinal, sizeof(Ordinal));
+            }
+
+            if (keyWidth <= RADIX_KEY_WIDTH) radixSort(entries, n);
+            else                             mergeSort(entries, n);
+
+            std::vector<size_t>  result(n);
+            for (size_t k = 0; k < n; ++k) {
+                Ordinal  ordinal;
+                std::memcpy(&ordinal, &entries[k * W + keyWidth], sizeof(Ordinal));
+                result[k] = ordinal;
+            }
+            return result;
+        }
+
+        template<typename R>
+        std::vector<size_t>  order(const RecordView<R>& view) const {
+            return order(view.data(), view.size());
+        }
+
+        /**
+         * Sorts the n consecutive records at base, in place.
+         */
+        void  sort(char* base, size_t n) const {
+            const std::vector<size_t>  sorted = order(base, n);
+            std::vector<char>  copy(n * stride);
+            for (size_t k = 0; k < n; ++k) std::memcpy(&copy[k * stride], base + sorted[k] * stride, stride);
+            if (n > 0) std::memcpy(base, copy.data(), copy.size());
+        }
+
+        void  sort(const RecordView<RecordType>& view) const {
+            sort(view.data(), view.size());
+        }
+
+        /**
+         * Sorts all records of is into os, for inputs larger than memory.
+         * The input is read in chunks, which are sorted in parallel and written as runs
+         * to temporary files, and the runs are then merged. An input that fits in one chunk
+         * is sorted without temporary files. Trailing bytes that do not form a complete record are ignored.
+         * Throws std::system_error if a run cannot be written or read back,
+         * and std::ios_base::failure if os fails.
+         * Returns the number of records.
+         */
+        size_t  sortStream(std::istream& is, std::ostream& os, const ExternalSortOptions& options = ExternalSortOptions()) const {
+            unsigned  numWorkers = options.threads != 0 ? options.threads : std::thread::hardware_concurrency();
+            if (numWorkers == 0) numWorkers = 1;
+            size_t  chunkRecords = options.memoryBytes / numWorkers / stride;
+            if (chunkRecords == 0) chunkRecords = 1;
+
+            std::vector<std::vector<char>>  chunks(numWorkers);
+            std::vector<size_t>             counts(numWorkers);
+            auto  readChunk = [&](unsigned w) {
+                chunks[w].resize(chunkRecords * stride);
+                is.read(chunks[w].data(), chunks[w].size());
+                counts[w] = is.gcount() / stride;
+                return counts[w] > 0;
+            };
+
+            //a single chunk is sorted directly
+            if (!readChunk(0)) return 0;
+            if (!is) {
+                sort(chunks[0].data(), counts[0]);
+                os.write(chunks[0].data(), counts[0] * stride);
+                os.flush();
+                if (!os) throw std::ios_base::failure("Cannot write records");
+                return counts[0];
+            }
+
+            detail::TempFiles  runs;
+            size_t  total = 0;
+            bool    pending = true;     //chunk 0 is read
+            while (pending) {
+                unsigned  filled = 1;
+                while (filled < numWorkers && is && readChunk(filled)) ++filled;
+
+                const size_t  first = runs.names.size();
+                for (unsigned w = 0; w < filled; ++w) runs.names.push_back(detail::tempFileName(options.tempDirectory));
+
+                detail::runTasks(filled, filled, [&](unsigned, size_t w) {
+                    sort(chunks[w].data(), counts[w]);
+                    const std::string&  name = runs.names[first + w];
+                    std::ofstream  run(name.c_str(), std::ios::binary);
+                    if (!run) throw detail::ioFailure("open", name);
+                    run.write(chunks[w].data(), counts[w] * stride);
+                    if (!run) throw detail::ioFailure("write", name);
+                    run.close();
+                    if (!run) throw detail::ioFailure("close", name);
+                });
+
+                for (unsigned w = 0; w < filled; ++w) total += counts[w];
+                pending = is && readChunk(0);
+            }
+
+            for (auto& chunk : chunks) std::vector<char>().swap(chunk);
+            merge(runs.names, os, options.memoryBytes);
+            return total;
+        }
+
+    private:
+        /**
+         * Merges the sorted runs into os, with a heap of the current record of each run.
+         * Ties are taken from the earlier run, which keeps the sort stable.
+         */
+        void  merge(const std::vector<std::string>& names, std::ostream& os, size_t memoryBytes) const {
+            const size_t  numRuns   = names.size();
+            size_t        blockSize = memoryBytes / (numRuns + 1);
+            if (blockSize < stride) blockSize = stride;
+
+            std::vector<std::unique_ptr<std::ifstream>>             files;
+            std::vector<std::unique_ptr<RecordReader<RecordType>>>  readers;
+            std::vector<RecordType*>                                current(numRuns);
+            std::vector<unsigned char>                              keys(numRuns * keyWidth);
+            for (size_t r = 0; r < numRuns; ++r) {
+                files.emplace_back(new std::ifstream(names[r].c_str(), std::ios::binary));
+                if (!*files[r]) throw detail::ioFailure("open", names[r]);
+                readers.emplace_back(new RecordReader<RecordType>(*files[r], blockSize));
+            }
+
+            auto  later = [&](size_t a, size_t b) {
+                const int  cmp = std::memcmp(&keys[a * keyWidth], &keys[b * keyWidth], keyWidth);
+                return cmp > 0 || (cmp == 0 && a > b);
+            };
+            std::priority_queue<size_t, std::vector<size_t>, decltype(later)>  heap(later);
+            auto  advance = [&](size_t r) {
+                current[r] = readers[r]->next();
+                if (current[r] != nullptr) {
+                    key(current[r]->begin(), &keys[r * keyWidth]);
+                    heap.push(r);
+                } else if (files[r]->bad() || readers[r]->remainder() > 0) {
+                    throw detail::ioFailure("read", names[r]);
+                }
+            };
+            for (size_t r = 0; r < numRuns; ++r) advance(r);
+
+            RecordWriter<RecordType>  out(os, blockSize);
+            while (!heap.empty()) {
+                const size_t  r = heap.top();
+                heap.pop();
+                out.write(*current[r]);
+                advance(r);
+            }
+            out.flush();
+        }
+    };
+
+}
+
+#endif /* RECORD_SORT_HPP_ */
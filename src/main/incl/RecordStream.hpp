@@ -0,0 +1,208 @@
+/*
+ * RecordStream.hpp
+ *
+ *  Block-buffered record stream I/O.
+ */
+
+#ifndef RECORD_STREAM_HPP_
+#define RECORD_STREAM_HPP_
+
+#include <iostream>
+#include <memory>
+#include <cstring>
+#include "RecordView.hpp"
+
+namespace overlay_record {
+
+    /**
+     * Default block size of RecordReader and RecordWriter.
+     */
+    const size_t    DEFAULT_BLOCK_SIZE = 4 * 1024 * 1024;
+
+    namespace detail {
+        /**
+         * Cache-line aligned block, of a whole number of records.
+         */
+        class RecordBlock {
+            static const size_t  ALIGNMENT = 64;
+
+            std::unique_ptr<char[]>  memory;
+            char*                    storage  = nullptr;
+            size_t                   capacity = 0;
+
+        public:
+            RecordBlock() = default;
+
+            RecordBlock(size_t blockSize, unsigned recordSize) {
+                size_t  numRecords = blockSize / recordSize;
+                if (numRecords == 0) numRecords = 1;
+                capacity = numRecords * recordSize;
+
+                memory.reset(new char[capacity + ALIGNMENT]);
+                size_t  misalignment = reinterpret_cast<size_t>(memory.get()) % ALIGNMENT;
+                storage = memory.get() + (misalignment == 0 ? 0 : ALIGNMENT - misalignment);
+            }
+
+            char*   data() const { return storage; }
+            size_t  size() const { return capacity; }
+        };
+    }
+
+    // -----------------------------------------------------
+    // --- class RecordReader
+    // -----------------------------------------------------
+    /**
+     * Reads records from a stream in large blocks, and hands out
+     * overlays directly into the block.
+     * A record which straddles two reads, is moved to the start of the block before the next read.
+     *
+     * <pre>
+     *   RecordReader<R>  in(std::cin);
+     *   while (R* r = in.next()) total += r->amount;
+     * </pre>
+     */
+    template<typename RecordType>
+    class RecordReader {
+        std::istream&       is;
+        unsigned            stride = Record::layout<RecordType>().size;
+        detail::RecordBlock block;
+        size_t              first  = 0;   //start of first unconsumed record
+        size_t              last   = 0;   //end of buffered bytes
+        detail::SlidingOverlay<RecordType>  overlay;
+
+        /**
+         * Refills the block, keeping any unconsumed bytes.
+         * Returns false at end of stream.
+         */
+        bool fill() {
+            const size_t  pending = last - first;
+            if (pending > 0 && first > 0) std::memmove(block.data(), block.data() + first, pending);
+            first = 0;
+            last  = pending;
+
+            while (last < stride && is) {
+                is.read(block.data() + last, block.size() - last);
+                last += is.gcount();
+            }
+            return last >= stride;
+        }
+
+    public:
+        RecordReader(std::istream& is, size_t blockSize = DEFAULT_BLOCK_SIZE)
+                : is(is), block(blockSize, Record::layout<RecordType>().size) {}
+
+        RecordReader(const RecordReader&) = delete;
+        RecordReader&  operator =(const RecordReader&) = delete;
+
+        /**
+         * Returns the next record, or nullptr at end of stream.
+         * The record is valid until the next call.
+         */
+        RecordType*     next() {
+            if (last - first < stride && !fill()) return nullptr;
+            RecordType&  rec = overlay.slideTo(block.data() + first);
+            first += stride;
+            return &rec;
+        }
+
+        /**
+         * Returns all complete records that are buffered, reading a new block if none.
+         * An empty view signals end of stream.
+         * The view is valid until the next call.
+         */
+        RecordView<RecordType>  nextBlock() {
+            if (last - first < stride && !fill()) return RecordView<RecordType>();
+            const size_t  n = (last - first) / stride;
+            char*  from = block.data() + first;
+            first += n * stride;
+            return RecordView<RecordType>(from, from + n * stride);
+        }
+
+        /**
+         * Returns the number of trailing bytes, at end of stream, that do not form a complete record.
+         */
+        size_t  remainder() const {
+            return last - first;
+        }
+    };
+
+
+    // -----------------------------------------------------
+    // --- class RecordWriter
+    // -----------------------------------------------------
+    /**
+     * Writes records to a stream in large blocks.
+     * New records are filled in directly in the block, which is kept
+     * zero-filled beyond the last record, so appending is just a move of the overlay.
+     *
+     * <pre>
+     *   RecordWriter<R>  out(std::cout);
+     *   R& r = out.append();
+     *   r.txt = "abc";
+     * </pre>
+     */
+    template<typename RecordType>
+    class RecordWriter {
+        std::ostream&       os;
+        unsigned            stride = Record::layout<RecordType>().size;
+        detail::RecordBlock block;
+        size_t              last   = 0;
+        detail::SlidingOverlay<RecordType>  overlay;
+
+    public:
+        RecordWriter(std::ostream& os, size_t blockSize = DEFAULT_BLOCK_SIZE)
+                : os(os), block(blockSize, Record::layout<RecordType>().size) {
+            std::memset(block.data(), 0x0, block.size());
+        }
+
+        RecordWriter(const RecordWriter&) = delete;
+        RecordWriter&  operator =(const RecordWriter&) = delete;
+
+        /**
+         * Writes any buffered records, ignoring failure.
+         * Call flush() first, to learn whether all records were written.
+         */
+        ~RecordWriter() {
+            try { flush(); } catch (const std::exception&) {}
+        }
+
+        /**
+         * Appends a zero-filled record and returns it.
+         * The record is valid until the next call.
+         */
+        RecordType&     append() {
+            if (last + stride > block.size()) flush();
+            char*  slot = block.data() + last;
+            last += stride;
+            return overlay.slideTo(slot);
+        }
+
+        /**
+         * Appends a copy of rec, which must be of the record size.
+         */
+        RecordWriter&   write(const Record& rec) {
+            if (rec.size() != stride) throw StorageOverflow();
+            if (last + stride > block.size()) flush();
+            std::memcpy(block.data() + last, rec.begin(), stride);
+            last += stride;
+            return *this;
+        }
+
+        /**
+         * Writes all buffered records to the stream.
+         * Throws std::ios_base::failure if the stream has failed.
+         */
+        void flush() {
+            if (last > 0) {
+                os.write(block.data(), last);
+                std::memset(block.data(), 0x0, last);
+            }
+            last = 0;
+            os.flush();
+            if (!os) throw std::ios_base::failure("Cannot write records");
+        }
+    };
+
+}
+
+#endif /* RECORD_STREAM_HPP_ */
@@ -0,0 +1,250 @@
+/*
+ * RecordView.hpp
+ *
+ *  Range of records over a contiguous buffer.
+ */
+
+#ifndef RECORD_VIEW_HPP_
+#define RECORD_VIEW_HPP_
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include "Record.hpp"
+
+namespace overlay_record {
+
+    namespace detail {
+        /**
+         * Overlay that slides over a range of records. It never owns any storage,
+         * which lets it move to another record by a plain Record::slideTo().
+         * A READ_ONLY overlay refuses writes, as for Record::assignReadOnlyBuffer().
+         */
+        template<typename OverlayType, bool READ_ONLY = false>
+        struct SlidingOverlay {
+            OverlayType     record;
+
+            SlidingOverlay() {
+                if (READ_ONLY) record.assignReadOnlyBuffer(nullptr, record.size());
+                else if (record.ownsBuffer()) record.assignStaticBuffer(nullptr, record.size());
+            }
+
+            OverlayType&    slideTo(const char* pos) {
+                record.slideTo(const_cast<char*>(pos));
+                return record;
+            }
+        };
+
+        /**
+         * Returns a new overlay of OverlayType bound to pos. It's copied from a
+         * non-owning prototype, hence it shares the storage rather than owning a copy of it.
+         */
+        template<typename OverlayType, bool READ_ONLY>
+        OverlayType  overlayAt(const char* pos) {
+            static const SlidingOverlay<OverlayType, READ_ONLY>  prototype;
+            OverlayType  overlay(prototype.record);
+            overlay.slideTo(const_cast<char*>(pos));
+            return overlay;
+        }
+
+        /**
+         * Overlay and storage types of a record range.
+         * A const RecordType gives a read-only range, over const storage.
+         */
+        template<typename RecordType>
+        struct RangeTraits {
+            typedef typename std::remove_const<RecordType>::type    Overlay;
+            typedef SlidingOverlay<Overlay, std::is_const<RecordType>::value>  Sliding;
+            typedef typename std::conditional<std::is_const<RecordType>::value,
+                                              const char*, char*>::type  Pointer;
+
+            static unsigned  stride() { return Record::layout<Overlay>().size; }
+
+            static RecordType  at(const char* pos) {
+                return overlayAt<Overlay, std::is_const<RecordType>::value>(pos);
+            }
+        };
+
+        /**
+         * Result of RecordIterator::operator->(), which holds the overlay it points to.
+         */
+        template<typename RecordType>
+        class OverlayPointer {
+            RecordType      record;
+        public:
+            explicit OverlayPointer(const char* pos) : record(RangeTraits<RecordType>::at(pos)) {}
+            RecordType*     operator ->() { return &record; }
+        };
+    }
+
+    // -----------------------------------------------------
+    // --- class RecordIterator
+    // -----------------------------------------------------
+    /**
+     * Random-access iterator over fixed-size records in a contiguous buffer.
+     * Dereferencing returns a new overlay of RecordType by value, bound to the
+     * current position, so any number of records obtained from it stay valid side by side.
+     * The overlay refers to the storage, hence writing to it writes to the buffer.
+     * RecordType must be default-constructible, as for Embed.
+     * Use a const RecordType for read-only storage.
+     */
+    template<typename RecordType>
+    class RecordIterator {
+        typedef detail::RangeTraits<RecordType>     Traits;
+        typedef typename Traits::Pointer            Pointer;
+
+        Pointer                                 pos    = nullptr;
+        unsigned                                stride = 0;
+
+    public:
+        typedef std::random_access_iterator_tag     iterator_category;
+        typedef typename Traits::Overlay            value_type;
+        typedef std::ptrdiff_t                      difference_type;
+        typedef detail::OverlayPointer<RecordType>  pointer;
+        typedef RecordType                          reference;
+
+        RecordIterator() = default;
+
+        RecordIterator(Pointer pos, unsigned stride) : pos(pos), stride(stride) {}
+
+        /**
+         * Returns the start address of the current record.
+         */
+        Pointer position() const { return pos; }
+
+        reference   operator *() const { return Traits::at(pos); }
+        pointer     operator ->() const { return pointer(pos); }
+        reference   operator [](difference_type n) const { return Traits::at(pos + n * stride); }
+
+        RecordIterator&  operator ++()    { pos += stride; return *this; }
+        RecordIterator   operator ++(int) { RecordIterator  it(*this); pos += stride; return it; }
+        RecordIterator&  operator --()    { pos -= stride; return *this; }
+        RecordIterator   operator --(int) { RecordIterator  it(*this); pos -= stride; return it; }
+
+        RecordIterator&  operator +=(difference_type n) { pos += n * stride; return *this; }
+        RecordIterator&  operator -=(difference_type n) { pos -= n * stride; return *this; }
+        RecordIterator   operator +(difference_type n) const { return RecordIterator(pos + n * stride, stride); }
+        RecordIterator   operator -(difference_type n) const { return RecordIterator(pos - n * stride, stride); }
+        friend RecordIterator  operator +(difference_type n, const RecordIterator& it) { return it + n; }
+
+        difference_type  operator -(const RecordIterator& that) const {
+            return (pos - that.pos) / (difference_type)stride;
+        }
+
+        bool  operator ==(const RecordIterator& that) const { return pos == that.pos; }
+        bool  operator !=(const RecordIterator& that) const { return pos != that.pos; }
+        bool  operator < (const RecordIterator& that) const { return pos <  that.pos; }
+        bool  operator > (const RecordIterator& that) const { return pos >  that.pos; }
+        bool  operator <=(const RecordIterator& that) const { return pos <= that.pos; }
+        bool  operator >=(const RecordIterator& that) const { return pos >= that.pos; }
+    };
+
+
+    // -----------------------------------------------------
+    // --- class RecordView
+    // -----------------------------------------------------
+    /**
+     * Non-owning range of fixed-size records over a contiguous buffer.
+     * The record size is taken from Record::layout<RecordType>().
+     * A RecordView<const R> is a read-only view over const storage, and
+     * a RecordView<R> converts to it. Indexing returns a new overlay by value, bound to
+     * the record, so a view holds no overlay, is cheap to copy, and any number of threads
+     * can index the same view concurrently.
+     *
+     * <pre>
+     *   RecordView<R>  view(buf, bufsiz);
+     *   for (const R& r : view) std::cout << r.name.value() << std::endl;
+     *   auto  it = std::find_if(view.begin(), view.end(), [](const R& r){ return r.id == 42; });
+     *   view[0].num = view[1].num;
+     * </pre>
+     */
+    template<typename RecordType>
+    class RecordView {
+        typedef detail::RangeTraits<RecordType>     Traits;
+        typedef typename Traits::Pointer            Pointer;
+
+        Pointer                                 first  = nullptr;
+        size_t                                  count  = 0;
+        unsigned                                stride = Traits::stride();
+
+    public:
+        typedef RecordIterator<RecordType>      iterator;
+        typedef RecordType                      value_type;
+        typedef RecordType                      reference;
+        typedef size_t                          size_type;
+
+        RecordView() = default;
+
+        /**
+         * Creates a view of all complete records within buf.
+         */
+        RecordView(Pointer buf, size_t bufsiz) : first(buf) {
+            count = bufsiz / stride;
+        }
+
+        /**
+         * Creates a view of the records within [from, to).
+         */
+        RecordView(Pointer from, Pointer to) : first(from) {
+            count = (to - from) / stride;
+        }
+
+        /**
+         * Converts a view of R into a read-only view of const R.
+         */
+        template<typename OtherType, typename = typename std::enable_if<
+                std::is_same<const OtherType, RecordType>::value && !std::is_same<OtherType, RecordType>::value>::type>
+        RecordView(const RecordView<OtherType>& that)
+                : first(that.data()), count(that.size()), stride(that.recordSize()) {}
+
+        /**
+         * Returns the number of records.
+         */
+        size_t      size()   const { return count; }
+        bool        empty()  const { return count == 0; }
+
+        /**
+         * Returns the record size in number of bytes.
+         */
+        unsigned    recordSize() const { return stride; }
+
+        /**
+         * Returns the start address of the first record.
+         */
+        Pointer     data() const { return first; }
+
+        iterator    begin() const { return iterator(first, stride); }
+        iterator    end()   const { return iterator(first + count * stride, stride); }
+
+        /**
+         * Returns an overlay of record ix, without bounds check.
+         */
+        reference   operator [](size_t ix) const {
+            return Traits::at(first + ix * stride);
+        }
+
+        /**
+         * Returns record ix, with bounds check.
+         */
+        reference   at(size_t ix) const {
+            if (ix >= count) throw IndexOutOfBounds(ix, count);
+            return (*this)[ix];
+        }
+
+        reference   front() const { return (*this)[0]; }
+        reference   back()  const { return (*this)[count - 1]; }
+
+        /**
+         * Returns a view of <em>n</em> records starting at record <em>offset</em>.
+         */
+        RecordView  subview(size_t offset, size_t n) const {
+            if (offset > count) throw IndexOutOfBounds(offset, count);
+            if (n > count - offset) n = count - offset;
+            Pointer  from = first + offset * stride;
+            return RecordView(from, from + n * stride);
+        }
+    };
+
+}
+
+#endif /* RECORD_VIEW_HPP_ */
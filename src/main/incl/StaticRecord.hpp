@@ -0,0 +1,441 @@
+/*
+ * StaticRecord.hpp
+ *
+ *  Compile-time layout variant of class Record.
+ */
+
+#ifndef STATIC_RECORD_HPP_
+#define STATIC_RECORD_HPP_
+
+#include "Record.hpp"
+
+namespace overlay_record {
+
+    // -----------------------------------------------------
+    // --- Placement of static entries
+    // -----------------------------------------------------
+    /**
+     * Places FieldType at the start of entry number K.
+     * Static counterpart of <code>{this, alignField}</code>.
+     */
+    template<unsigned K, typename FieldType>
+    struct At {};
+
+    /**
+     * Places FieldType right after the end of entry number K.
+     * Static counterpart of <code>{this, alignField, false}</code>.
+     */
+    template<unsigned K, typename FieldType>
+    struct After {};
+
+    template<typename... Entries> class StaticRecord; //forward decl
+
+
+    // -----------------------------------------------------
+    // --- class StaticField
+    // -----------------------------------------------------
+    /**
+     * Accessor of a single field in a StaticRecord.
+     * Holds just the address of the field, which is computed at compile-time
+     * relative to the start of the record.
+     */
+    template<typename FieldType, unsigned field_size, typename converter>
+    class StaticField {
+        char*   storage;
+
+    public:
+        typedef FieldType       TYPE;
+        static const unsigned   SIZE = field_size;
+
+        explicit StaticField(char* storage) : storage(storage) {}
+
+        /**
+         * Returns its start address.
+         */
+        char*   begin() const { return storage; }
+
+        /**
+         * Returns its end address.
+         */
+        char*   end() const { return storage + SIZE; }
+
+        /**
+         * Returns its size in number of bytes.
+         */
+        unsigned size() const { return SIZE; }
+
+        /**
+         * Returns its value as a string.
+         */
+        std::string chars() const {
+            return std::string(begin(), end());
+        }
+
+        /**
+         * Returns a view of its storage, without any copying.
+         */
+        TextView view() const {
+            return TextView(storage, SIZE);
+        }
+
+        /**
+         * Sets its value.
+         * Uses its converter::toStorage() function.
+         */
+        void value(FieldType v) {
+            converter::toStorage(v, storage, SIZE);
+        }
+
+        /**
+         * Sets its value from characters. Only for text and HEX fields.
+         */
+        template<typename C = converter, typename = IfCharacterConverter<C>>
+        void value(const char* v) {
+            converter::toStorage(v, storage, SIZE);
+        }
+
+        /**
+         * Returns its value.
+         * Uses its converter::fromStorage() function.
+         */
+        FieldType value() const {
+            return converter::fromStorage(storage, SIZE);
+        }
+
+        operator FieldType() const {
+            return value();
+        }
+
+        StaticField&  operator =(FieldType v) {
+            value(v);
+            return *this;
+        }
+
+        template<typename C = converter, typename = IfCharacterConverter<C>>
+        StaticField&  operator =(const char* v) {
+            value(v);
+            return *this;
+        }
+    };
+
+
+    namespace detail {
+        template<typename Entry> struct EntryTraits; //only supported entry types are specialized
+    }
+
+    // -----------------------------------------------------
+    // --- class StaticArray
+    // -----------------------------------------------------
+    /**
+     * Accessor of an array field in a StaticRecord.
+     */
+    template<typename ItemType, unsigned numItems>
+    class StaticArray {
+        char*   storage;
+
+    public:
+        typedef typename detail::EntryTraits<ItemType>::Ref  ITEM;
+        typedef typename ItemType::TYPE                      TYPE;
+        static const unsigned   COUNT = numItems;
+        static const unsigned   SIZE  = numItems * ItemType::SIZE;
+
+        explicit StaticArray(char* storage) : storage(storage) {
+            static_assert(COUNT > 0, "Non-positive number of items");
+        }
+
+        ITEM operator[](int ix) const {
+            if (0 <= ix && ix < (int)numItems) {
+                return ITEM(storage + ix * ItemType::SIZE);
+            } else {
+                throw IndexOutOfBounds(ix, numItems);
+            }
+        }
+
+        unsigned size()  const { return SIZE; }
+        unsigned count() const { return COUNT; }
+
+        // --- Support of iteration and for-each loops ---
+        class iterator {
+            char*   item;
+
+        public:
+            iterator(char* item) : item(item) {}
+            ITEM        operator *() const { return ITEM(item); }
+            iterator&   operator ++() { item += ItemType::SIZE; return *this; }
+            bool        operator !=(const iterator& that) const { return this->item != that.item; }
+        };
+        iterator  begin() const { return iterator(storage); }
+        iterator  end()   const { return iterator(storage + SIZE); }
+
+        // --- Support for array assignment ---
+        void  assign(std::initializer_list<TYPE> values) {
+            if (COUNT == values.size()) {
+                auto v = values.begin();
+                for (unsigned k=0; k<COUNT; ++k, ++v) (*this)[k].value( *v );
+            } else {
+                throw IndexOutOfBounds(values.size(), numItems);
+            }
+        }
+
+        void  operator =(std::initializer_list<TYPE> values) {
+            assign(values);
+        }
+    };
+
+
+    namespace detail {
+        // -----------------------------------------------------
+        // --- Entry traits: size and accessor type of an entry
+        // -----------------------------------------------------
+        template<typename T, unsigned N, typename C>
+        struct EntryTraits< Record::Field<T, N, C> > {
+            typedef StaticField<T, N, C>     Ref;
+            static constexpr unsigned size() { return N; }
+        };
+
+        template<typename ItemType, unsigned N>
+        struct EntryTraits< Record::Array<ItemType, N> > {
+            typedef StaticArray<ItemType, N>   Ref;
+            static constexpr unsigned size() { return N * EntryTraits<ItemType>::size(); }
+        };
+
+        template<typename... Es>
+        struct EntryTraits< StaticRecord<Es...> > {
+            typedef StaticRecord<Es...>      Ref;
+            static constexpr unsigned size() { return StaticRecord<Es...>::size(); }
+        };
+
+        template<typename... Es>
+        struct EntryTraits< Record::Embed< StaticRecord<Es...> > > : EntryTraits< StaticRecord<Es...> > {};
+
+
+        // -----------------------------------------------------
+        // --- Compile-time offset computation
+        // -----------------------------------------------------
+        template<unsigned I, typename... Es> struct NthEntry;
+
+        template<typename E, typename... Es>
+        struct NthEntry<0, E, Es...> {
+            typedef E   type;
+        };
+
+        template<unsigned I, typename E, typename... Es>
+        struct NthEntry<I, E, Es...> : NthEntry<I - 1, Es...> {};
+
+        template<unsigned I, typename... Es> struct EntryLayout;
+
+        /**
+         * End offset of the entry preceding entry I.
+         * Same semantics as Record::getLastOffset().
+         */
+        template<unsigned I, typename... Es>
+        struct PreviousEnd {
+            static constexpr unsigned value() { return EntryLayout<I - 1, Es...>::end(); }
+        };
+
+        template<typename... Es>
+        struct PreviousEnd<0, Es...> {
+            static constexpr unsigned value() { return 0; }
+        };
+
+        template<unsigned I, typename Entry, typename... Es>
+        struct Placement {
+            typedef Entry   type;
+            static constexpr unsigned offset() { return PreviousEnd<I, Es...>::value(); }
+        };
+
+        template<unsigned I, unsigned K, typename F, typename... Es>
+        struct Placement<I, At<K, F>, Es...> {
+            static_assert(K < I, "At<K, ...> must refer to a preceding entry");
+            typedef F       type;
+            static constexpr unsigned offset() { return EntryLayout<K, Es...>::offset(); }
+        };
+
+        template<unsigned I, unsigned K, typename F, typename... Es>
+        struct Placement<I, After<K, F>, Es...> {
+            static_assert(K < I, "After<K, ...> must refer to a preceding entry");
+            typedef F       type;
+            static constexpr unsigned offset() { return EntryLayout<K, Es...>::end(); }
+        };
+
+        template<unsigned I, typename... Es>
+        struct EntryLayout {
+            typedef Placement<I, typename NthEntry<I, Es...>::type, Es...>  P;
+            typedef typename P::type                                        type;
+            typedef typename EntryTraits<type>::Ref                         Ref;
+
+            static constexpr unsigned offset() { return P::offset(); }
+            static constexpr unsigned size()   { return EntryTraits<type>::size(); }
+            static constexpr unsigned end()    { return offset() + size(); }
+        };
+
+        /**
+         * Largest end offset of the entries [0, I).
+         */
+        template<unsigned I, typename... Es>
+        struct MaxEnd {
+            static constexpr unsigned value() {
+                return MaxEnd<I - 1, Es...>::value() > EntryLayout<I - 1, Es...>::end()
+                     ? MaxEnd<I - 1, Es...>::value()
+                     : EntryLayout<I - 1, Es...>::end();
+            }
+        };
+
+        template<typename... Es>
+        struct MaxEnd<0, Es...> {
+            static constexpr unsigned value() { return 0; }
+        };
+    }
+
+
+    // -----------------------------------------------------
+    // --- class StaticRecord
+    // -----------------------------------------------------
+    /**
+     * Overlay record with a layout computed at compile-time.
+     * The entries are the usual field types (Record::Text<N>, Record::Integer, ...),
+     * Record::Array<F, N>, nested StaticRecord (optionally wrapped in Record::Embed<>)
+     * and the overlay placements At<K, F> and After<K, F>.
+     *
+     * An instance is just a pointer to the storage, and field access compiles
+     * down to the buffer address plus a constant.
+     *
+     * <pre>
+     *   typedef StaticRecord<Record::Text<4>, Record::Integer, At<0, Record::Blob<4>>>  R;
+     *   R  r(buf, sizeof(buf));
+     *   r.get<0>() = "abcd";
+     * </pre>
+     */
+    template<typename... Entries>
+    class StaticRecord {
+        static_assert(sizeof...(Entries) > 0, "No fields defined");
+
+        char*   buffer = nullptr;
+
+    public:
+        template<unsigned I>
+        using Entry = detail::EntryLayout<I, Entries...>;
+
+        /**
+         * Returns its size in number of bytes.
+         */
+        static constexpr unsigned size() {
+            return detail::MaxEnd<sizeof...(Entries), Entries...>::value();
+        }
+
+        /**
+         * Returns the number of entries.
+         */
+        static constexpr unsigned count() {
+            return sizeof...(Entries);
+        }
+
+        /**
+         * Returns the start offset of entry I.
+         */
+        template<unsigned I>
+        static constexpr unsigned offset() {
+            return Entry<I>::offset();
+        }
+
+        StaticRecord() = default;
+
+        explicit StaticRecord(char* buf) : buffer(buf) {}
+
+        StaticRecord(char* buf, unsigned bufsiz) {
+            assignStaticBuffer(buf, bufsiz);
+        }
+
+        StaticRecord&   assignStaticBuffer(char* buf, unsigned bufsiz) {
+            if (bufsiz < size()) throw StorageOverflow();
+            buffer = buf;
+            return *this;
+        }
+
+        /**
+         * Returns the accessor of entry I.
+         */
+        template<unsigned I>
+        typename Entry<I>::Ref  get() const {
+            return typename Entry<I>::Ref(buffer + Entry<I>::offset());
+        }
+
+        /**
+         * Support for the same syntax as Record::Embed, when used as embedded record.
+         */
+        StaticRecord*   operator ->() {
+            return this;
+        }
+
+        /**
+         * Returns the start address of a record.
+         */
+        char* begin() const {
+            if (buffer == nullptr) throw UnInitialized("Buffer is null");
+            return buffer;
+        }
+
+        /**
+         * Returns the end address of a record.
+         */
+        char* end() const {
+            return begin() + size();
+        }
+
+        /**
+         * Copies buf into storage.
+         * It's assumed that sizeof(buf) is sufficient.
+         */
+        StaticRecord&   operator <<(const char* buf) {
+            std::memcpy(begin(), buf, size());
+            return *this;
+        }
+
+        /**
+         * Replaces storage with buf.
+         * It's assumed that sizeof(buf) is sufficient.
+         */
+        StaticRecord&   operator =(char* buf) {
+            buffer = buf;
+            return *this;
+        }
+
+        /**
+         * Moves <em>n</em> record positions over the underlying buffer.
+         * Returns the new start position.
+         */
+        char* operator +=(int n) {
+            buffer += n * (int)size();
+            return buffer;
+        }
+
+        char* operator ++() {
+            return *this += +1;
+        }
+
+        char* operator --() {
+            return *this += -1;
+        }
+    };
+
+    /**
+     * Writes a static record binary, to a stream.
+     */
+    template<typename... Entries>
+    inline std::ostream&  operator <<(std::ostream& os, const StaticRecord<Entries...>& rec) {
+        os.write(rec.begin(), rec.size());
+        return os;
+    }
+
+    /**
+     * Reads a static record binary from a stream, directly into its storage.
+     */
+    template<typename... Entries>
+    inline std::istream&  operator >>(std::istream& is, StaticRecord<Entries...>& rec) {
+        is.read(rec.begin(), rec.size());
+        return is;
+    }
+
+}
+
+#endif /* STATIC_RECORD_HPP_ */
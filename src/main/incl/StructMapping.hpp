@@ -0,0 +1,232 @@
+/*
+ * StructMapping.hpp
+ *
+ *  Declarative decoding and encoding between records and plain structs.
+ */
+
+#ifndef STRUCT_MAPPING_HPP_
+#define STRUCT_MAPPING_HPP_
+
+#include "Column.hpp"
+
+namespace overlay_record {
+
+    namespace detail {
+        /**
+         * Converts the storage of a field with converter C into a member of type Member, and back.
+         * Text fields are assigned in place to strings, and viewed by TextView, without temporaries.
+         * Numeric text is parsed and formatted in place, by the column kernel of its converter.
+         */
+        template<typename FieldType, unsigned SIZE, typename C, typename Member>
+        struct MemberConverter {
+            static void decode(const char* p, Member& m) {
+                m = static_cast<Member>(C::fromStorage(p, SIZE));
+            }
+            static void encode(const Member& m, char* p) {
+                C::toStorage(static_cast<FieldType>(m), p, SIZE);
+            }
+        };
+
+        template<typename FieldType, unsigned SIZE, typename Type, typename str2num, char PAD, typename Member>
+        struct MemberConverter<FieldType, SIZE, Record::NumericConverter<Type, str2num, PAD>, Member> {
+            typedef NumericTextKernel<Type, str2num, PAD>  Kernel;
+            static void decode(const char* p, Member& m) {
+                Type  v;
+                Kernel::extract(p, SIZE, 0, 1, &v);
+                m = static_cast<Member>(v);
+            }
+            static void encode(const Member& m, char* p) {
+                const Type  v = static_cast<Type>(m);
+                Kernel::scatter(p, SIZE, 0, 1, &v);
+            }
+        };
+
+        template<unsigned SIZE, char PAD>
+        struct MemberConverter<std::string, SIZE, Record::TextConverter<PAD>, std::string> {
+            typedef Record::TextConverter<PAD>  C;
+            static void decode(const char* p, std::string& m) { C::fromStorage(p, SIZE, m); }
+            static void encode(const std::string& m, char* p) { C::toStorage(m, p, SIZE); }
+        };
+
+        template<unsigned SIZE, char PAD>
+        struct MemberConverter<std::string, SIZE, Record::TextConverter<PAD>, TextView> {
+            typedef Record::TextConverter<PAD>  C;
+            static void decode(const char* p, TextView& m) { m = TextView(p, SIZE); }
+            static void encode(const TextView& m, char* p) {
+                if (m.data() != p) C::toStorage(m.data(), m.size(), p, SIZE);
+            }
+        };
+
+        template<unsigned SIZE>
+        struct MemberConverter<std::string, SIZE, Record::HEXConverter, std::string> {
+            static void decode(const char* p, std::string& m) {
+                m.resize(2 * SIZE);
+                Record::HEXConverter::encode(p, SIZE, &m[0]);
+            }
+            static void encode(const std::string& m, char* p) { Record::HEXConverter::toStorage(m, p, SIZE); }
+        };
+    }
+
+
+    // -----------------------------------------------------
+    // --- class MemberBinding
+    // -----------------------------------------------------
+    /**
+     * One field of RecordType, bound to one member of Struct.
+     * Created by bindMember().
+     */
+    template<typename RecordType, typename Struct, typename FieldType, unsigned SIZE, typename C, typename Member>
+    class MemberBinding {
+        typedef Record::Field<FieldType, SIZE, C>               FieldT;
+        typedef detail::MemberConverter<FieldType, SIZE, C, Member> Converter;
+
+        unsigned            offset;
+        Member Struct::*    member;
+
+    public:
+        MemberBinding(FieldT RecordType::* field, Member Struct::* member)
+            : offset(fieldOffset(field)), member(member) {}
+
+        void    decode(const char* record, Struct& s) const {
+            Converter::decode(record + offset, s.*member);
+        }
+
+        void    encode(const Struct& s, char* record) const {
+            Converter::encode(s.*member, record + offset);
+        }
+
+    private:
+        static unsigned  fieldOffset(FieldT RecordType::* field) {
+            static_assert(std::is_base_of<Record, RecordType>::value, "Requires a Record subclass");
+            RecordType  prototype;
+            return (prototype.*field).startOffset();
+        }
+    };
+
+    /**
+     * Binds a field of a Record subclass to a member of a struct.
+     *
+     * <pre>
+     *   bindMember(&R::amount, &Row::amount)
+     * </pre>
+     */
+    template<typename RecordType, typename Struct, typename FieldType, unsigned SIZE, typename C, typename Member>
+    MemberBinding<RecordType, Struct, FieldType, SIZE, C, Member>
+    bindMember(Record::Field<FieldType, SIZE, C> RecordType::* field, Member Struct::* member) {
+        return {field, member};
+    }
+
+
+    // -----------------------------------------------------
+    // --- class StructMapping
+    // -----------------------------------------------------
+    /**
+     * Decodes a whole RecordType into a Struct, and encodes it back, in one call.
+     * The bindings are types, with the converter of each field known at compile time,
+     * so the compiler can inline the complete decode of a record.
+     * Fields not bound are left as is, when encoding.
+     *
+     * <pre>
+     *   struct Row { std::string id; long long amount; double price; };
+     *
+     *   auto  mapping = mapStruct<R, Row>(bindMember(&R::id,     &Row::id),
+     *                                     bindMember(&R::amount, &Row::amount),
+     *                                     bindMember(&R::price,  &Row::price));
+     *   Row  row;
+     *   mapping.decode(rec, row);
+     *   mapping.decode(buf, n, rows);      //n consecutive records
+     * </pre>
+     */
+    template<typename RecordType, typename Struct, typename... Bindings>
+    class StructMapping;
+
+    template<typename RecordType, typename Struct>
+    class StructMapping<RecordType, Struct> {
+    public:
+        void    decodeFields(const char*, Struct&) const {}
+        void    encodeFields(const Struct&, char*) const {}
+    };
+
+    template<typename RecordType, typename Struct, typename First, typename... Rest>
+    class StructMapping<RecordType, Struct, First, Rest...> : private StructMapping<RecordType, Struct, Rest...> {
+        typedef StructMapping<RecordType, Struct, Rest...>  Tail;
+
+        First   binding;
+
+    public:
+        StructMapping(const First& first, const Rest&... rest)
+            : Tail(rest...), binding(first) {}
+
+        void    decodeFields(const char* record, Struct& s) const {
+            binding.decode(record, s);
+            Tail::decodeFields(record, s);
+        }
+
+        void    encodeFields(const Struct& s, char* record) const {
+            binding.encode(s, record);
+            Tail::encodeFields(s, record);
+        }
+
+        /**
+         * Returns the size of one record.
+         */
+        static unsigned  recordSize() {
+            return Record::layout<RecordType>().size;
+        }
+
+        /**
+         * Decodes the bound fields of one record.
+         */
+        void    decode(const char* record, Struct& s) const {
+            decodeFields(record, s);
+        }
+
+        void    decode(const RecordType& record, Struct& s) const {
+            decodeFields(record.begin(), s);
+        }
+
+        Struct  decode(const RecordType& record) const {
+            Struct  s = Struct();
+            decode(record, s);
+            return s;
+        }
+
+        /**
+         * Decodes <em>n</em> consecutive records into out[0..n).
+         */
+        void    decode(const char* records, size_t n, Struct* out) const {
+            const unsigned  stride = recordSize();
+            for (size_t k = 0; k < n; ++k, records += stride) decodeFields(records, out[k]);
+        }
+
+        /**
+         * Encodes the bound members into one record.
+         */
+        void    encode(const Struct& s, char* record) const {
+            encodeFields(s, record);
+        }
+
+        void    encode(const Struct& s, RecordType& record) const {
+            encodeFields(s, record.begin());
+        }
+
+        /**
+         * Encodes in[0..n) into <em>n</em> consecutive records.
+         */
+        void    encode(const Struct* in, size_t n, char* records) const {
+            const unsigned  stride = recordSize();
+            for (size_t k = 0; k < n; ++k, records += stride) encodeFields(in[k], records);
+        }
+    };
+
+    /**
+     * Creates the mapping between RecordType and Struct, of the given member bindings.
+     */
+    template<typename RecordType, typename Struct, typename... Bindings>
+    StructMapping<RecordType, Struct, Bindings...>  mapStruct(const Bindings&... bindings) {
+        return {bindings...};
+    }
+
+}
+
+#endif /* STRUCT_MAPPING_HPP_ */
@@ -0,0 +1,112 @@
+/*
+ * ColumnExport_Test.cpp
+ *
+ *  Transposing records into columns.
+ */
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <sstream>
+#include <vector>
+#include "ColumnExport.hpp"
+using namespace overlay_record;
+using namespace std;
+
+struct ColumnExport_Test : public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE( ColumnExport_Test );
+		CPPUNIT_TEST( numeric_fields_should_become_typed_arrays );
+		CPPUNIT_TEST( text_fields_should_become_offsets_and_data );
+		CPPUNIT_TEST( parallel_export_should_keep_record_order );
+		CPPUNIT_TEST( streams_should_be_exported_by_block );
+    CPPUNIT_TEST_SUITE_END();
+
+	struct R : public Record {
+		Text<6>					name = {this};
+		Integer					val  = {this};
+		TextInteger<6>			num  = {this};
+		BigEndian<int32_t>		key  = {this};
+		Blob<2>					raw  = {this};
+	};
+
+	static const size_t  N = 1001;
+	vector<char>  buf;
+	R  proto;
+
+	void setUp() {
+		buf.assign(N * Record::layout<R>().size, '\0');
+		RecordView<R>  view(buf.data(), buf.size());
+		for (size_t k = 0; k < N; ++k) {
+			R  r = view[k];
+			r.name = string(1 + k % 6, 'a' + k % 26);
+			r.val  = k * 1000;
+			r.num  = -(int)k;
+			r.key  = k * 7;
+			r.raw  = "0A0B";
+		}
+	}
+
+	static string  name(size_t k) { return string(1 + k % 6, 'a' + k % 26); }
+
+    void numeric_fields_should_become_typed_arrays() {
+    	vector<int>      vals, nums;
+    	vector<int32_t>  keys;
+    	ColumnExport<R>  columns(1000);     //several blocks
+    	columns.add(proto.val, vals).add(proto.num, nums).add(proto.key, keys);
+    	CPPUNIT_ASSERT_EQUAL((size_t)3, columns.numColumns());
+
+    	columns.exportFrom(buf.data(), N);
+    	CPPUNIT_ASSERT_EQUAL(N, vals.size());
+    	for (size_t k = 0; k < N; ++k) {
+    		CPPUNIT_ASSERT_EQUAL((int)k * 1000, vals[k]);
+    		CPPUNIT_ASSERT_EQUAL(-(int)k, nums[k]);
+    		CPPUNIT_ASSERT_EQUAL((int32_t)k * 7, keys[k]);
+    	}
+    }
+
+    void text_fields_should_become_offsets_and_data() {
+    	TextColumn  names, raws;
+    	ColumnExport<R>  columns;
+    	columns.add(proto.name, names).add(proto.raw, raws);
+    	columns.exportFrom(RecordView<R>(buf.data(), buf.size()).subview(0, 10));
+    	columns.exportFrom(RecordView<R>(buf.data(), buf.size()).subview(10, N - 10));
+
+    	CPPUNIT_ASSERT_EQUAL(N, names.size());
+    	CPPUNIT_ASSERT_EQUAL(N + 1, names.offsets().size());
+    	CPPUNIT_ASSERT_EQUAL(names.offsets().back(), names.data().size());
+    	for (size_t k = 0; k < N; ++k) CPPUNIT_ASSERT_EQUAL(name(k), names[k].str());
+
+    	CPPUNIT_ASSERT_EQUAL(string("\x0A\x0B"), raws[N - 1].str());
+    }
+
+    void parallel_export_should_keep_record_order() {
+    	vector<int>  vals;
+    	TextColumn   names;
+    	vals.push_back(-1);                 //exports append
+    	ColumnExport<R>  columns(256);
+    	columns.add(proto.val, vals).add(proto.name, names);
+    	columns.exportFrom(RecordView<const R>(buf.data(), buf.size()), ParallelOptions(4, 512));
+
+    	CPPUNIT_ASSERT_EQUAL(N + 1, vals.size());
+    	CPPUNIT_ASSERT_EQUAL(N, names.size());
+    	for (size_t k = 0; k < N; ++k) {
+    		CPPUNIT_ASSERT_EQUAL((int)k * 1000, vals[k + 1]);
+    		CPPUNIT_ASSERT_EQUAL(name(k), names[k].str());
+    	}
+    }
+
+    void streams_should_be_exported_by_block() {
+    	istringstream  in(string(buf.data(), buf.size()));
+    	vector<int>  nums;
+    	TextColumn   names;
+    	ColumnExport<R>  columns;
+    	columns.add(proto.num, nums).add(proto.name, names);
+
+    	CPPUNIT_ASSERT_EQUAL(N, columns.exportFrom(in, 10 * Record::layout<R>().size + 3));
+    	CPPUNIT_ASSERT_EQUAL(N, nums.size());
+    	CPPUNIT_ASSERT_EQUAL(-(int)(N - 1), nums.back());
+    	CPPUNIT_ASSERT_EQUAL(name(N - 1), names[N - 1].str());
+    }
+
+};
+const size_t  ColumnExport_Test::N;
+CPPUNIT_TEST_SUITE_REGISTRATION( ColumnExport_Test );
@@ -0,0 +1,211 @@
+/*
+ * Column_Test.cpp
+ *
+ *  Bulk access of one field across many records.
+ */
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cmath>
+#include <cstring>
+#include <typeinfo>
+#include <vector>
+#include "Column.hpp"
+#include "RecordView.hpp"
+using namespace overlay_record;
+using namespace std;
+
+struct Column_Test : public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE( Column_Test );
+		CPPUNIT_TEST( extracting_binary_columns_should_work );
+		CPPUNIT_TEST( extracting_text_numeric_columns_should_work );
+		CPPUNIT_TEST( extracting_other_columns_should_use_the_converter );
+		CPPUNIT_TEST( numeric_text_columns_should_equal_the_field_value );
+		CPPUNIT_TEST( scattering_columns_should_round_trip );
+		CPPUNIT_TEST( scattering_text_and_blob_columns_should_pad );
+		CPPUNIT_TEST( embedded_fields_should_use_the_outermost_record );
+    CPPUNIT_TEST_SUITE_END();
+
+	struct R : public Record {
+		Text<4>					txt = {this};
+		Integer					val = {this};
+		TextInteger<6>			num = {this};
+		DecimalDouble<8>		amt = {this};
+		BigEndian<int32_t>		key = {this};
+	};
+
+	static const size_t  N = 37;
+	vector<char>  buf;
+	R  proto;
+
+	void setUp() {
+		buf.assign(N * Record::layout<R>().size, '\0');
+		RecordView<R>  view(buf.data(), buf.size());
+		for (size_t k = 0; k < N; ++k) {
+			R  r = view[k];
+			r.txt = string(4, 'a' + k % 26);
+			r.val = k * 1000;
+			r.num = -(int)k;
+			r.amt = k + 0.25;
+			r.key = k * 7;
+		}
+	}
+
+    void extracting_binary_columns_should_work() {
+    	vector<int>  vals(N);
+    	extractColumn(proto.val, buf.data(), N, vals.data());
+
+    	vector<int32_t>  keys(N);
+    	extractColumn(proto.key, buf.data(), N, keys.data());
+
+    	for (size_t k = 0; k < N; ++k) {
+    		CPPUNIT_ASSERT_EQUAL((int)k * 1000, vals[k]);
+    		CPPUNIT_ASSERT_EQUAL((int32_t)k * 7, keys[k]);
+    	}
+    }
+
+    void extracting_text_numeric_columns_should_work() {
+    	vector<int>  nums(N);
+    	extractColumn(proto.num, buf.data(), N, nums.data());
+
+    	vector<double>  amts(N);
+    	extractColumn(proto.amt, buf.data(), N, amts.data());
+
+    	for (size_t k = 0; k < N; ++k) {
+    		CPPUNIT_ASSERT_EQUAL(-(int)k, nums[k]);
+    		CPPUNIT_ASSERT_DOUBLES_EQUAL(k + 0.25, amts[k], 1e-9);
+    	}
+    }
+
+    void extracting_other_columns_should_use_the_converter() {
+    	vector<string>  txts(N);
+    	extractColumn(proto.txt, buf.data(), N, txts.data());
+		CPPUNIT_ASSERT_EQUAL(string("aaaa"), txts[0]);
+		CPPUNIT_ASSERT_EQUAL(string("kkkk"), txts[36]);
+
+		vector<int>  some(2);
+		const unsigned  stride = 2 * proto.size();
+		extractColumn(proto.val, buf.data(), 2, stride, some.data());
+		CPPUNIT_ASSERT_EQUAL(2000, some[1]);
+    }
+
+	struct TO_HALF {
+		int operator()(const std::string& s) { return std::stoi(s) / 2; }
+	};
+
+	struct T : public Record {
+		Field<int, 12, NumericConverter<int, TO_INT>>				i32 = {this};
+		Field<int, 12, NumericConverter<int, TO_SHORT>>				i16 = {this};
+		Field<unsigned long, 12, NumericConverter<unsigned long, TO_UNSIGNED_LONG>>  u64 = {this};
+		Field<float, 12, NumericConverter<float, TO_FLOAT>>			f32 = {this};
+		Field<double, 12, NumericConverter<double, TO_DOUBLE>>		f64 = {this};
+		Field<int, 12, NumericConverter<int, TO_HALF>>				half = {this};
+	};
+
+	/**
+	 * Asserts that the column kernel gives what value() gives for the text, or throws the same.
+	 */
+	template<typename FieldType>
+	static void assertSameAsValue(T& t, FieldType& field, const char* text) {
+		typedef typename FieldType::TYPE  Type;
+		std::memset(t.begin(), '\0', t.size());
+		std::memcpy(field.begin(), text, std::min<size_t>(std::strlen(text), field.size()));
+
+		Type  expected = Type(), actual = Type();
+		string  expectedError, actualError;
+		try { expected = field.value(); } catch (std::exception& e) { expectedError = typeid(e).name(); }
+		try { extractColumn(field, t.begin(), 1, &actual); } catch (std::exception& e) { actualError = typeid(e).name(); }
+
+		const string  message = string("text '") + text + "'";
+		CPPUNIT_ASSERT_MESSAGE(message, expectedError == actualError);
+		if (expected != expected) CPPUNIT_ASSERT_MESSAGE(message, actual != actual);
+		else CPPUNIT_ASSERT_MESSAGE(message, expected == actual && std::signbit(expected) == std::signbit(actual));
+	}
+
+    void numeric_text_columns_should_equal_the_field_value() {
+    	const char*  texts[] = {
+    		"42", "  -17   ", "+8", "0", "-0", "70000", "2147483647", "2147483648", "99999999999",
+    		"000000000042", "12abc", "  12 34", "\t5", "- 5", "", "   ", "abc", "0x1A",
+    		"0.1", "3.25", "-2.5e3", ".5", "5.", ".", "1e39", "inf", "-nan", "123456789.5", "1.000000001",
+    	};
+    	T  t;
+    	t.allocateDynamicBuffer();
+    	for (const char* text : texts) {
+    		assertSameAsValue(t, t.i32, text);
+    		assertSameAsValue(t, t.i16, text);
+    		assertSameAsValue(t, t.u64, text);
+    		assertSameAsValue(t, t.f32, text);
+    		assertSameAsValue(t, t.f64, text);
+    		assertSameAsValue(t, t.half, text);
+    	}
+    }
+
+    void scattering_columns_should_round_trip() {
+    	vector<int>  vals(N), nums(N), back(N);
+    	vector<double>  amts(N);
+    	vector<int32_t>  keys(N);
+    	for (size_t k = 0; k < N; ++k) {
+    		vals[k] = k * 3;
+    		nums[k] = 100000 + k;
+    		amts[k] = k / 8.0;
+    		keys[k] = -(int32_t)k;
+    	}
+
+    	scatterColumn(proto.val, buf.data(), N, vals.data());
+    	scatterColumn(proto.num, buf.data(), N, nums.data());
+    	scatterColumn(proto.amt, buf.data(), N, amts.data());
+    	scatterColumn(proto.key, buf.data(), N, keys.data());
+
+		RecordView<R>  view(buf.data(), buf.size());
+		for (size_t k = 0; k < N; ++k) {
+			CPPUNIT_ASSERT_EQUAL((int)k * 3, view[k].val.value());
+			CPPUNIT_ASSERT_EQUAL(100000 + (int)k, view[k].num.value());
+			CPPUNIT_ASSERT_DOUBLES_EQUAL(k / 8.0, view[k].amt.value(), 1e-9);
+			CPPUNIT_ASSERT_EQUAL(-(int32_t)k, view[k].key.value());
+			CPPUNIT_ASSERT_EQUAL(string(4, 'a' + k % 26), view[k].txt.value());
+		}
+
+		nums[0] = 1234567;
+		scatterColumn(proto.num, buf.data(), 1, nums.data());
+		CPPUNIT_ASSERT_EQUAL(123456, view[0].num.value());
+    }
+
+    void scattering_text_and_blob_columns_should_pad() {
+    	struct B : public Record {
+    		Text<4>		txt  = {this};
+    		Blob<2>		blob = {this};
+    	};
+
+    	B  b;
+    	char  data[12];
+    	const string  txts[]  = {"ab", "cdefgh"};
+    	const string  blobs[] = {"0A0B", "FF"};
+    	scatterColumn(b.txt,  data, 2, txts);
+    	scatterColumn(b.blob, data, 2, blobs);
+		CPPUNIT_ASSERT_EQUAL(string("ab  \x0A\x0B" "cdef\xFF\0", 12), string(data, 12));
+
+		string  hex[2];
+		extractColumn(b.blob, data, 2, hex);
+		CPPUNIT_ASSERT_EQUAL(string("FF00"), hex[1]);
+    }
+
+    void embedded_fields_should_use_the_outermost_record() {
+    	struct Outer : public Record {
+    		Text<3>		tag = {this};
+    		Embed<R>	rec = {this};
+    	};
+
+    	Outer  outer;
+    	vector<char>  records(N * outer.size());
+    	vector<int>   vals(N), back(N);
+    	for (size_t k = 0; k < N; ++k) vals[k] = k * 3;
+    	scatterColumn(outer.rec->val, records.data(), N, vals.data());
+    	extractColumn(outer.rec->val, records.data(), N, back.data());
+    	CPPUNIT_ASSERT(vals == back);
+
+    	RecordView<Outer>  view(records.data(), records.size());
+    	CPPUNIT_ASSERT_EQUAL(6, view[2].rec->val.value());
+    }
+
+};
+CPPUNIT_TEST_SUITE_REGISTRATION( Column_Test );
@@ -0,0 +1,81 @@
+/*
+ * Construction_Test.cpp
+ *
+ *  The shared per-type layout of records.
+ */
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <stdexcept>
+#include "Record.hpp"
+using namespace overlay_record;
+using namespace std;
+
+struct Construction_Test : public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE( Construction_Test );
+		CPPUNIT_TEST( layout_should_describe_all_fields );
+		CPPUNIT_TEST( layout_should_be_computed_once_per_type );
+		CPPUNIT_TEST( failed_layout_should_not_leave_a_capture );
+    CPPUNIT_TEST_SUITE_END();
+
+	struct E : public Record {
+		Text<4>				txt = {this};
+		TextInteger<4>		num = {this};
+	};
+
+	struct R : public Record {
+		Text<8>				txt  = {this};
+		TextInteger<5>		num  = {this};
+		Integer				val  = {this};
+		Array<Double, 3>	vec  = {this};
+		Embed<E>			e    = {this};
+		Blob<4>				blob = {this, txt};
+
+		R() = default;
+		R(char* buf, unsigned bufsiz) { assignStaticBuffer(buf, bufsiz); }
+	};
+
+	struct Failing : public Record {
+		Text<4>				txt = {this};
+
+		Failing() { throw runtime_error("no prototype"); }
+	};
+
+    void layout_should_describe_all_fields() {
+    	const RecordLayout&  layout = Record::layout<R>();
+
+    	const unsigned  expectedSize = 8 + 5 + sizeof(int) + 3*sizeof(double) + 8;
+		CPPUNIT_ASSERT_EQUAL(expectedSize, layout.size);
+		CPPUNIT_ASSERT_EQUAL(8UL, (unsigned long)layout.fields.size());
+
+		CPPUNIT_ASSERT(FieldKind::TEXT == layout.fields[0].kind);
+		CPPUNIT_ASSERT(FieldKind::NUMERIC == layout.fields[1].kind);
+		CPPUNIT_ASSERT(FieldKind::BINARY == layout.fields[2].kind);
+		CPPUNIT_ASSERT(FieldKind::EMBED == layout.fields[6].kind);
+		CPPUNIT_ASSERT(FieldKind::HEX == layout.fields[7].kind);
+
+		CPPUNIT_ASSERT_EQUAL(13U, layout.fields[2].offset);
+		CPPUNIT_ASSERT_EQUAL(17U + (unsigned)sizeof(double), layout.fields[4].offset);
+		CPPUNIT_ASSERT_EQUAL(8U, layout.fields[6].size);
+		CPPUNIT_ASSERT_EQUAL(0U, layout.fields[7].offset);
+    }
+
+    void layout_should_be_computed_once_per_type() {
+		CPPUNIT_ASSERT(&Record::layout<R>() == &Record::layout<R>());
+		CPPUNIT_ASSERT(&Record::layout<R>() != &Record::layout<E>());
+		CPPUNIT_ASSERT_EQUAL(8U, Record::layout<E>().size);
+		CPPUNIT_ASSERT_EQUAL(2UL, (unsigned long)Record::layout<E>().fields.size());
+    }
+
+    void failed_layout_should_not_leave_a_capture() {
+    	CPPUNIT_ASSERT_THROW(Record::layout<Failing>(), runtime_error);
+
+    	char  buf[64];
+    	R  r(buf, sizeof(buf));
+    	r.num = 42;
+    	CPPUNIT_ASSERT_EQUAL(42, r.num.value());
+    	CPPUNIT_ASSERT_EQUAL(8UL, (unsigned long)Record::layout<R>().fields.size());
+    }
+
+};
+CPPUNIT_TEST_SUITE_REGISTRATION( Construction_Test );
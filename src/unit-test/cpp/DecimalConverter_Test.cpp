@@ -0,0 +1,125 @@
+/*
+ * DecimalConverter_Test.cpp
+ *
+ *  Allocation-free numeric text fields.
+ */
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "Record.hpp"
+using namespace std;
+using namespace overlay_record;
+
+struct DecimalConverter_Test : public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE( DecimalConverter_Test );
+	CPPUNIT_TEST( parsing_integers_should_handle_pad_and_sign );
+	CPPUNIT_TEST( parsing_long_digit_runs_should_work );
+	CPPUNIT_TEST( parsing_out_of_range_integers_should_saturate );
+	CPPUNIT_TEST( formatting_integers_should_align );
+	CPPUNIT_TEST( formatting_too_wide_integers_should_apply_policy );
+	CPPUNIT_TEST( floats_should_round_trip );
+	CPPUNIT_TEST( decimal_fields_should_work );
+    CPPUNIT_TEST_SUITE_END();
+
+	typedef Record::DecimalConverter<int>			IntConverter;
+	typedef Record::DecimalConverter<long long>		LongConverter;
+
+	template<typename C, typename T>
+	static string format(T v, size_t size) {
+		char  buf[32] = {};
+		C::toStorage(v, buf, size);
+		return string(buf, size);
+	}
+
+	template<typename C>
+	static auto parse(const string& s) -> decltype(C::fromStorage(nullptr, 0)) {
+		return C::fromStorage(s.data(), s.size());
+	}
+
+    void parsing_integers_should_handle_pad_and_sign() {
+		CPPUNIT_ASSERT_EQUAL(42, parse<IntConverter>("42    "));
+		CPPUNIT_ASSERT_EQUAL(42, parse<IntConverter>("  0042"));
+		CPPUNIT_ASSERT_EQUAL(-17, parse<IntConverter>(" -17  "));
+		CPPUNIT_ASSERT_EQUAL(17, parse<IntConverter>("+17"));
+		CPPUNIT_ASSERT_EQUAL(0, parse<IntConverter>("      "));
+		CPPUNIT_ASSERT_EQUAL(0, parse<IntConverter>(string(4, '\0')));
+		CPPUNIT_ASSERT_EQUAL(12, parse<IntConverter>("12ab"));
+		CPPUNIT_ASSERT_EQUAL(-7, (parse<Record::DecimalConverter<int, '*'>>("**-7**")));
+    }
+
+    void parsing_long_digit_runs_should_work() {
+		CPPUNIT_ASSERT_EQUAL(12345678, parse<IntConverter>("12345678"));
+		CPPUNIT_ASSERT_EQUAL(1234567890123456LL, parse<LongConverter>("1234567890123456"));
+		CPPUNIT_ASSERT_EQUAL(-123456789012345678LL, parse<LongConverter>("-123456789012345678 "));
+		CPPUNIT_ASSERT_EQUAL(9223372036854775807LL, parse<LongConverter>("9223372036854775807"));
+		CPPUNIT_ASSERT_EQUAL(123456789LL, parse<LongConverter>("00000000123456789"));
+    }
+
+    void parsing_out_of_range_integers_should_saturate() {
+		CPPUNIT_ASSERT_EQUAL(2147483647, parse<IntConverter>("99999999999"));
+		CPPUNIT_ASSERT_EQUAL(-2147483647 - 1, parse<IntConverter>("-2147483648"));
+		CPPUNIT_ASSERT_EQUAL(-2147483647 - 1, parse<IntConverter>("-2147483649"));
+		CPPUNIT_ASSERT_EQUAL(9223372036854775807LL, parse<LongConverter>("99999999999999999999999"));
+		CPPUNIT_ASSERT_EQUAL(0U, parse<Record::DecimalConverter<unsigned>>("-5"));
+
+		typedef Record::DecimalConverter<int, ' ', NumberAlign::LEFT, OverflowPolicy::THROW>	Strict;
+		CPPUNIT_ASSERT_THROW(parse<Strict>("99999999999"), std::overflow_error);
+    }
+
+    void formatting_integers_should_align() {
+		CPPUNIT_ASSERT_EQUAL(string("42    "), format<IntConverter>(42, 6));
+		CPPUNIT_ASSERT_EQUAL(string("-42   "), format<IntConverter>(-42, 6));
+		CPPUNIT_ASSERT_EQUAL(string("   -42"), (format<Record::DecimalConverter<int, ' ', NumberAlign::RIGHT>>(-42, 6)));
+		CPPUNIT_ASSERT_EQUAL(string("-00042"), (format<Record::DecimalConverter<int, ' ', NumberAlign::ZERO_FILL>>(-42, 6)));
+		CPPUNIT_ASSERT_EQUAL(string("0"), format<IntConverter>(0, 1));
+		CPPUNIT_ASSERT_EQUAL(string("-9223372036854775808"), format<LongConverter>(-9223372036854775807LL - 1, 20));
+    }
+
+    void formatting_too_wide_integers_should_apply_policy() {
+		CPPUNIT_ASSERT_EQUAL(string("9999"), format<IntConverter>(123456, 4));
+		CPPUNIT_ASSERT_EQUAL(string("-999"), format<IntConverter>(-123456, 4));
+
+		typedef Record::DecimalConverter<int, ' ', NumberAlign::LEFT, OverflowPolicy::THROW>	Strict;
+		CPPUNIT_ASSERT_THROW(format<Strict>(123456, 4), std::overflow_error);
+    }
+
+    void floats_should_round_trip() {
+    	typedef Record::DecimalConverter<double>	DoubleConverter;
+
+		CPPUNIT_ASSERT_EQUAL(string("3.1416"), format<DoubleConverter>(3.141592654, 6));
+		CPPUNIT_ASSERT_EQUAL(string("-2.50"), format<DoubleConverter>(-2.5, 5));
+		CPPUNIT_ASSERT_EQUAL(string("10.0"), format<DoubleConverter>(9.999, 4));
+		CPPUNIT_ASSERT_EQUAL(string("1234.4"), format<DoubleConverter>(1234.4, 6));
+		CPPUNIT_ASSERT_EQUAL(string("9999"), format<DoubleConverter>(123456.0, 4));
+
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(3.1416, parse<DoubleConverter>("3.1416"), 1e-12);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(-0.125, parse<DoubleConverter>("  -.125  "), 1e-12);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(1.5e10, parse<DoubleConverter>("1.5e10"), 1e-3);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(42.0, parse<DoubleConverter>("42"), 1e-12);
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, parse<DoubleConverter>("    "), 1e-12);
+    }
+
+    void decimal_fields_should_work() {
+    	struct R : public Record {
+    		TextInteger<8, DecimalConverter<int>>	num = {this};
+    		DecimalLong<16>							big = {this};
+    		DecimalFloat<6>							val = {this};
+
+    		R() { allocateDynamicBuffer(); }
+    	};
+
+    	R  r;
+		CPPUNIT_ASSERT_EQUAL(0, r.num.value());
+
+		r.num = 20140830;
+		r.big = 1234567890123456LL;
+		r.val = 3.141592654F;
+		CPPUNIT_ASSERT_EQUAL(string("201408301234567890123456"), string(r.begin(), r.begin() + 24));
+		CPPUNIT_ASSERT_EQUAL(20140830, r.num.value());
+		CPPUNIT_ASSERT_EQUAL(1234567890123456LL, r.big.value());
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(3.1416, r.val.value(), 0.00001);
+		CPPUNIT_ASSERT(FieldKind::NUMERIC == Record::layout<R>().fields[1].kind);
+    }
+
+};
+CPPUNIT_TEST_SUITE_REGISTRATION( DecimalConverter_Test );
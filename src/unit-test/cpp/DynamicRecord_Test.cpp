@@ -0,0 +1,176 @@
+/*
+ * DynamicRecord_Test.cpp
+ *
+ *  Records with a layout loaded at runtime, from a schema.
+ */
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "DynamicRecord.hpp"
+using namespace overlay_record;
+using namespace std;
+
+struct DynamicRecord_Test : public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE( DynamicRecord_Test );
+		CPPUNIT_TEST( schema_should_place_fields_as_record_does );
+		CPPUNIT_TEST( fields_should_be_accessed_by_index );
+		CPPUNIT_TEST( binary_and_decimal_fields_should_use_the_converters );
+		CPPUNIT_TEST( large_uint64_values_should_not_wrap );
+		CPPUNIT_TEST( groups_and_arrays_should_be_flattened );
+		CPPUNIT_TEST( records_should_slide_over_a_buffer );
+		CPPUNIT_TEST( invalid_schemas_should_be_rejected );
+    CPPUNIT_TEST_SUITE_END();
+
+	struct X : public Record {
+		Text<3>				street = {this};
+		TextInteger<5>		zip    = {this};
+	};
+
+	struct R : public Record {
+		Text<4>				id     = {this};
+		TextInteger<6>		amount = {this};
+		Array<Text<2>, 3>	codes  = {this};
+		Embed<X>			addr   = {this};
+		Text<8>				all    = {this, id};
+		Integer				bin    = {this};
+	};
+
+	const string  SCHEMA =
+			"# customer record\n"
+			"id        text(4)\n"
+			"amount    integer(6)\n"
+			"codes     text(2)      occurs 3\n"
+			"addr      group\n"
+			"  street  text(3)\n"
+			"  zip     integer(5)\n"
+			"end\n"
+			"all       text(8)      at id\n"
+			"bin       int32\n";
+
+    void schema_should_place_fields_as_record_does() {
+    	RecordSchema  schema = RecordSchema::parse(SCHEMA);
+    	const RecordLayout&  expected = Record::layout<R>();
+    	RecordLayout  actual = schema.layout();
+
+    	CPPUNIT_ASSERT_EQUAL(expected.size, actual.size);
+    	CPPUNIT_ASSERT_EQUAL(expected.size, schema.size());
+    	for (const char* name : {"id", "amount", "codes[0]", "codes[2]", "addr", "addr.street", "addr.zip", "all", "bin"})
+    		CPPUNIT_ASSERT(schema.contains(name));
+
+    	CPPUNIT_ASSERT_EQUAL(16U, schema[schema.indexOf("addr")].offset);
+    	CPPUNIT_ASSERT_EQUAL(8U, schema[schema.indexOf("addr")].size);
+    	CPPUNIT_ASSERT_EQUAL(19U, schema[schema.indexOf("addr.zip")].offset);
+    	CPPUNIT_ASSERT_EQUAL(0U, schema[schema.indexOf("all")].offset);
+    	CPPUNIT_ASSERT_EQUAL(8U, schema[schema.indexOf("bin")].offset);
+    	CPPUNIT_ASSERT(FieldKind::EMBED == schema[schema.indexOf("addr")].kind());
+    }
+
+    void fields_should_be_accessed_by_index() {
+    	RecordSchema  schema = RecordSchema::parse(SCHEMA);
+    	const size_t  id = schema.indexOf("id"), amount = schema.indexOf("amount"), zip = schema.indexOf("addr.zip");
+
+    	DynamicRecord  r(schema);
+    	r.allocateDynamicBuffer();
+    	r.setText(id, "abc");
+    	r.setInteger(amount, -4711);
+    	r.setText(zip, "12345");
+
+    	CPPUNIT_ASSERT_EQUAL(string("abc "), r.text(id));
+    	CPPUNIT_ASSERT_EQUAL(-4711LL, r.integer(amount));
+    	CPPUNIT_ASSERT_DOUBLES_EQUAL(-4711.0, r.real(amount), 1e-9);
+    	CPPUNIT_ASSERT_EQUAL(12345LL, r.integer(zip));
+    	CPPUNIT_ASSERT_EQUAL(string("-4711"), r.text(amount));
+    	CPPUNIT_ASSERT(r.view(id) == TextView("abc "));
+
+    	CPPUNIT_ASSERT_THROW(r.integer(id), SchemaError);
+    	CPPUNIT_ASSERT_THROW(schema.indexOf("nope"), SchemaError);
+    }
+
+    void binary_and_decimal_fields_should_use_the_converters() {
+    	RecordSchema  schema = RecordSchema::parse(
+    			"key    int32be\n"
+    			"rate   float64le\n"
+    			"price  packed(4,2)\n"
+    			"qty    zoned(3)\n"
+    			"pct    decimal(8)\n"
+    			"raw    blob(2)\n");
+    	CPPUNIT_ASSERT_EQUAL(4U + 8 + 4 + 3 + 8 + 2, schema.size());
+
+    	DynamicRecord  r(schema);
+    	r.allocateDynamicBuffer();
+    	r.setInteger(0, 0x01020304);
+    	r.setReal(1, 2.5);
+    	r.setReal(2, -123.45);
+    	r.setInteger(3, 42);
+    	r.setText(4, "3.25");
+    	r.setText(5, "CAFE");
+
+    	CPPUNIT_ASSERT_EQUAL(string("\x01\x02\x03\x04"), string(r.begin(), 4));
+    	CPPUNIT_ASSERT_EQUAL(0x01020304LL, r.integer(0));
+    	CPPUNIT_ASSERT_DOUBLES_EQUAL(2.5, r.real(1), 1e-9);
+    	CPPUNIT_ASSERT_EQUAL(string("\x00\x12\x34\x5D", 4), string(r.begin() + 12, 4));
+    	CPPUNIT_ASSERT_DOUBLES_EQUAL(-123.45, r.real(2), 1e-9);
+    	CPPUNIT_ASSERT_EQUAL(-123LL, r.integer(2));
+    	CPPUNIT_ASSERT_EQUAL(42LL, r.integer(3));
+    	CPPUNIT_ASSERT_DOUBLES_EQUAL(3.25, r.real(4), 1e-9);
+    	CPPUNIT_ASSERT_EQUAL(string("CAFE"), r.text(5));
+    }
+
+    void large_uint64_values_should_not_wrap() {
+    	RecordSchema  schema = RecordSchema::parse("big    uint64be\nraw    blob(2)\n");
+    	DynamicRecord  r(schema);
+    	r.allocateDynamicBuffer();
+
+    	r.setInteger(0, 1LL << 62);
+    	CPPUNIT_ASSERT_EQUAL(1LL << 62, r.integer(0));
+
+    	memset(r.begin(), 0xFF, 8);
+    	CPPUNIT_ASSERT_THROW(r.integer(0), overflow_error);
+    	CPPUNIT_ASSERT_DOUBLES_EQUAL(18446744073709551615.0, r.real(0), 1e4);
+
+    	const char  hex[] = "BEEFCAFE";
+    	r.setText(1, hex, 4);
+    	CPPUNIT_ASSERT_EQUAL(string("BEEF"), r.text(1));
+    }
+
+    void groups_and_arrays_should_be_flattened() {
+    	RecordSchema  schema = RecordSchema::parse(
+    			"lines  group  occurs 2\n"
+    			"  sku  text(3)\n"
+    			"  qty  int16\n"
+    			"  sub  group\n"
+    			"    x  text(1)\n"
+    			"  end\n"
+    			"end\n"
+    			"tail   text(2)  after lines\n");
+    	CPPUNIT_ASSERT_EQUAL(14U, schema.size());
+    	CPPUNIT_ASSERT_EQUAL(6U, schema[schema.indexOf("lines[1]")].offset);
+    	CPPUNIT_ASSERT_EQUAL(9U, schema[schema.indexOf("lines[1].qty")].offset);
+    	CPPUNIT_ASSERT_EQUAL(11U, schema[schema.indexOf("lines[1].sub.x")].offset);
+    	CPPUNIT_ASSERT_EQUAL(12U, schema[schema.indexOf("tail")].offset);
+    }
+
+    void records_should_slide_over_a_buffer() {
+    	RecordSchema  schema = RecordSchema::parse("txt text(3)\nnum integer(2)\n");
+    	char  buf[] = "abc01def02ghi03";
+    	DynamicRecord  r(schema, buf, sizeof(buf));
+    	const size_t  num = schema.indexOf("num");
+
+    	long long  sum = 0;
+    	for (int k = 0; k < 3; ++k, ++r) sum += r.integer(num);
+    	CPPUNIT_ASSERT_EQUAL(6LL, sum);
+
+    	--r;
+    	DynamicRecord  copy(r);
+    	CPPUNIT_ASSERT_EQUAL(string("ghi"), copy.text(0));
+    }
+
+    void invalid_schemas_should_be_rejected() {
+    	for (const char* text : {"", "a text\n", "a text(0)\n", "a foo(2)\n", "a text(2) occurs\n",
+    			"a text(2)\na int8\n", "b text(2) at a\n", "g group\n x int8\n", "end\n", "a int8(2)\n"}) {
+    		CPPUNIT_ASSERT_THROW(RecordSchema::parse(text), SchemaError);
+    	}
+    }
+
+};
+CPPUNIT_TEST_SUITE_REGISTRATION( DynamicRecord_Test );
@@ -0,0 +1,159 @@
+/*
+ * FieldPlan_Test.cpp
+ *
+ *  Precompiled decoding and encoding of schema records, into native objects.
+ */
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "FieldPlan.hpp"
+using namespace overlay_record;
+using namespace std;
+
+struct FieldPlan_Test : public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE( FieldPlan_Test );
+		CPPUNIT_TEST( decode_should_match_the_dynamic_record );
+		CPPUNIT_TEST( encode_should_round_trip );
+		CPPUNIT_TEST( batches_should_decode_consecutive_records );
+		CPPUNIT_TEST( tuples_should_be_bound_by_index );
+		CPPUNIT_TEST( incompatible_members_should_be_rejected );
+    CPPUNIT_TEST_SUITE_END();
+
+	struct Row {
+		string		id;
+		long long	amount;
+		double		price;
+		int			count;
+		string		key;
+		TextView	code;
+	};
+
+	const string  SCHEMA =
+			"id        text(4)\n"
+			"amount    integer(6)\n"
+			"price     packed(5,2)\n"
+			"count     int32be\n"
+			"key       blob(2)\n"
+			"code      text(3)\n";
+
+	static FieldPlan<Row>  plan(const RecordSchema& schema) {
+		FieldPlan<Row>  p(schema);
+		p.bind("id", &Row::id).bind("amount", &Row::amount).bind("price", &Row::price)
+		 .bind("count", &Row::count).bind("key", &Row::key).bind("code", &Row::code);
+		return p;
+	}
+
+	static void fill(DynamicRecord& r, const char* id, long long amount, double price, int count) {
+		r.setText(r.schema().indexOf("id"), id);
+		r.setInteger(r.schema().indexOf("amount"), amount);
+		r.setReal(r.schema().indexOf("price"), price);
+		r.setInteger(r.schema().indexOf("count"), count);
+		r.setText(r.schema().indexOf("key"), "CAFE");
+		r.setText(r.schema().indexOf("code"), "xyz");
+	}
+
+    void decode_should_match_the_dynamic_record() {
+    	RecordSchema  schema = RecordSchema::parse(SCHEMA);
+    	DynamicRecord  r(schema);
+    	r.allocateDynamicBuffer();
+    	fill(r, "ab", -4711, 123.45, 42);
+
+    	FieldPlan<Row>  p = plan(schema);
+    	CPPUNIT_ASSERT_EQUAL((size_t)6, p.steps().size());
+
+    	Row  row;
+    	p.decode(r, row);
+    	CPPUNIT_ASSERT_EQUAL(string("ab  "), row.id);
+    	CPPUNIT_ASSERT_EQUAL(-4711LL, row.amount);
+    	CPPUNIT_ASSERT_DOUBLES_EQUAL(123.45, row.price, 1e-9);
+    	CPPUNIT_ASSERT_EQUAL(42, row.count);
+    	CPPUNIT_ASSERT_EQUAL(string("CAFE"), row.key);
+    	CPPUNIT_ASSERT_EQUAL(string("xyz"), row.code.str());
+    	CPPUNIT_ASSERT(row.code.data() == r.begin() + schema[schema.indexOf("code")].offset);
+    }
+
+    void encode_should_round_trip() {
+    	RecordSchema  schema = RecordSchema::parse(SCHEMA);
+    	FieldPlan<Row>  p = plan(schema);
+
+    	Row  row;
+    	row.id     = "wxyz";
+    	row.amount = 12345;
+    	row.price  = -9.99;
+    	row.count  = -7;
+    	row.key    = "0102";
+    	row.code   = TextView("q", 1);
+
+    	DynamicRecord  r(schema);
+    	r.allocateDynamicBuffer();
+    	p.encode(row, r);
+    	CPPUNIT_ASSERT_EQUAL(string("wxyz"), r.text(schema.indexOf("id")));
+    	CPPUNIT_ASSERT_EQUAL(12345LL, r.integer(schema.indexOf("amount")));
+    	CPPUNIT_ASSERT_DOUBLES_EQUAL(-9.99, r.real(schema.indexOf("price")), 1e-9);
+    	CPPUNIT_ASSERT_EQUAL(-7LL, r.integer(schema.indexOf("count")));
+    	CPPUNIT_ASSERT_EQUAL(string("0102"), r.text(schema.indexOf("key")));
+    	CPPUNIT_ASSERT_EQUAL(string("q  "), r.text(schema.indexOf("code")));
+
+    	Row  back;
+    	p.decode(r, back);
+    	CPPUNIT_ASSERT_EQUAL(row.id, back.id);
+    	CPPUNIT_ASSERT_EQUAL(row.amount, back.amount);
+    	CPPUNIT_ASSERT_DOUBLES_EQUAL(row.price, back.price, 1e-9);
+    	CPPUNIT_ASSERT_EQUAL(row.count, back.count);
+    	CPPUNIT_ASSERT_EQUAL(row.key, back.key);
+    }
+
+    void batches_should_decode_consecutive_records() {
+    	RecordSchema  schema = RecordSchema::parse(SCHEMA);
+    	FieldPlan<Row>  p = plan(schema);
+
+    	const unsigned  N = 3;
+    	vector<char>  buf(N * schema.size());
+    	DynamicRecord  r(schema, buf.data(), buf.size());
+    	for (unsigned k = 0; k < N; ++k, ++r) fill(r, "r", k * 10, k + 0.5, k);
+
+    	Row  rows[N];
+    	p.decode(buf.data(), N, rows);
+    	for (unsigned k = 0; k < N; ++k) {
+    		CPPUNIT_ASSERT_EQUAL((long long)k * 10, rows[k].amount);
+    		CPPUNIT_ASSERT_DOUBLES_EQUAL(k + 0.5, rows[k].price, 1e-9);
+    		CPPUNIT_ASSERT_EQUAL((int)k, rows[k].count);
+    	}
+
+    	rows[1].amount = 999;
+    	vector<char>  copy(buf.size());
+    	p.encode(rows, N, copy.data());
+    	DynamicRecord  c(schema, copy.data(), copy.size());
+    	++c;
+    	CPPUNIT_ASSERT_EQUAL(999LL, c.integer(schema.indexOf("amount")));
+    	CPPUNIT_ASSERT_EQUAL(1LL, c.integer(schema.indexOf("count")));
+    }
+
+    void tuples_should_be_bound_by_index() {
+    	RecordSchema  schema = RecordSchema::parse(SCHEMA);
+    	DynamicRecord  r(schema);
+    	r.allocateDynamicBuffer();
+    	fill(r, "tup", 17, 1.25, 3);
+
+    	typedef tuple<string, long long, float>  Tuple;
+    	FieldPlan<Tuple>  p(schema);
+    	p.bind<0>("id").bind<1>("amount").bind<2>("price");
+
+    	Tuple  t;
+    	p.decode(r, t);
+    	CPPUNIT_ASSERT_EQUAL(string("tup "), get<0>(t));
+    	CPPUNIT_ASSERT_EQUAL(17LL, get<1>(t));
+    	CPPUNIT_ASSERT_DOUBLES_EQUAL(1.25, get<2>(t), 1e-6);
+    }
+
+    void incompatible_members_should_be_rejected() {
+    	RecordSchema  schema = RecordSchema::parse(SCHEMA);
+    	FieldPlan<Row>  p(schema);
+    	CPPUNIT_ASSERT_THROW(p.bind("id", &Row::amount), SchemaError);
+    	CPPUNIT_ASSERT_THROW(p.bind("amount", &Row::id), SchemaError);
+    	CPPUNIT_ASSERT_THROW(p.bind("nope", &Row::id), SchemaError);
+    	CPPUNIT_ASSERT(p.steps().empty());
+    }
+
+};
+CPPUNIT_TEST_SUITE_REGISTRATION( FieldPlan_Test );
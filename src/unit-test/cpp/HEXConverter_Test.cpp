@@ -15,6 +15,9 @@ struct HEXConverter_Test : public CppUnit::TestFixture {
     CPPUNIT_TEST_SUITE( HEXConverter_Test );
 	CPPUNIT_TEST( fromStorage_should_return_twice_sized_string );
 	CPPUNIT_TEST( toStorage_should_produce_half_sized_payload );
+	CPPUNIT_TEST( long_payloads_should_round_trip );
+	CPPUNIT_TEST( lower_case_and_invalid_digits_should_be_decoded );
+	CPPUNIT_TEST( blob_should_be_readable_as_raw_bytes );
     CPPUNIT_TEST_SUITE_END();
 
     void fromStorage_should_return_twice_sized_string() {
@@ -43,5 +46,56 @@ struct HEXConverter_Test : public CppUnit::TestFixture {
     	    CPPUNIT_ASSERT_EQUAL(expected[k], actual[k]);
     }
 
+    void long_payloads_should_round_trip() {
+    	unsigned char	payload[77];
+    	for (size_t k=0; k<sizeof(payload); ++k) payload[k] = static_cast<unsigned char>(k * 37 + 11);
+
+    	string	expected;
+    	for (size_t k=0; k<sizeof(payload); ++k) {
+    		char  buf[3];
+    		snprintf(buf, sizeof(buf), "%02X", payload[k]);
+    		expected += buf;
+    	}
+
+    	string	actual = Record::HEXConverter::fromStorage(payload, sizeof(payload));
+		CPPUNIT_ASSERT_EQUAL(expected, actual);
+
+		unsigned char	decoded[sizeof(payload)];
+		Record::HEXConverter::toStorage(actual, decoded, sizeof(decoded));
+		CPPUNIT_ASSERT(memcmp(payload, decoded, sizeof(payload)) == 0);
+    }
+
+    void lower_case_and_invalid_digits_should_be_decoded() {
+    	unsigned char	actual[20];
+
+    	string	lower = "00112233445566778899aabbccddeeff0a1b2c3d";
+    	Record::HEXConverter::decode(lower.data(), lower.size(), actual);
+		CPPUNIT_ASSERT_EQUAL(static_cast<unsigned char>(0xAA), actual[10]);
+		CPPUNIT_ASSERT_EQUAL(static_cast<unsigned char>(0x3D), actual[19]);
+
+    	string	invalid = "00112233445566778899AABBCCDDEEFG";
+    	Record::HEXConverter::decode(invalid.data(), invalid.size(), actual);
+		CPPUNIT_ASSERT_EQUAL(static_cast<unsigned char>(0xEE), actual[14]);
+		CPPUNIT_ASSERT_EQUAL(static_cast<unsigned char>(0x0F), actual[15]);
+
+		Record::HEXConverter::decode("ABC", 3, actual);
+		CPPUNIT_ASSERT_EQUAL(static_cast<unsigned char>(0xAB), actual[0]);
+		CPPUNIT_ASSERT_EQUAL(static_cast<unsigned char>(0x0C), actual[1]);
+    }
+
+    void blob_should_be_readable_as_raw_bytes() {
+    	struct R : public Record {
+    		Blob<4>    data = {this};
+
+    		R() { allocateDynamicBuffer(); }
+    	};
+
+    	R  r;
+    	r.data = "0F1F2F3F";
+    	TextView  bytes = r.data.view();
+		CPPUNIT_ASSERT_EQUAL(4UL, (unsigned long)bytes.size());
+		CPPUNIT_ASSERT_EQUAL('\x2F', bytes[2]);
+    }
+
 };
 CPPUNIT_TEST_SUITE_REGISTRATION( HEXConverter_Test );
@@ -0,0 +1,118 @@
+/*
+ * LegacyFields_Test.cpp
+ *
+ *  Endian-aware binary, packed and zoned decimal fields.
+ */
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "Record.hpp"
+using namespace overlay_record;
+using namespace std;
+
+struct LegacyFields_Test : public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE( LegacyFields_Test );
+		CPPUNIT_TEST( fixed_width_integers_should_have_proper_size );
+		CPPUNIT_TEST( big_endian_fields_should_be_stored_most_significant_first );
+		CPPUNIT_TEST( little_endian_fields_should_be_stored_least_significant_first );
+		CPPUNIT_TEST( packed_decimals_should_work );
+		CPPUNIT_TEST( zoned_decimals_should_work );
+    CPPUNIT_TEST_SUITE_END();
+
+    static string bytes(const Record& r) {
+    	return string(r.begin(), r.end());
+    }
+
+    void fixed_width_integers_should_have_proper_size() {
+    	struct R : public Record {
+    		Int16	a = {this};
+    		Int32	b = {this};
+    		Int64	c = {this};
+
+    		R() { allocateDynamicBuffer(); }
+    	};
+
+    	R  r;
+		CPPUNIT_ASSERT_EQUAL(14U, r.size());
+
+		r.a = -2;
+		r.c = -3;
+		CPPUNIT_ASSERT_EQUAL(static_cast<int16_t>(-2), r.a.value());
+		CPPUNIT_ASSERT_EQUAL(static_cast<int64_t>(-3), r.c.value());
+    }
+
+    void big_endian_fields_should_be_stored_most_significant_first() {
+    	struct R : public Record {
+    		BigEndian<uint16_t>	a = {this};
+    		BigEndian<int32_t>	b = {this};
+    		BigEndian<double>	c = {this};
+
+    		R() { allocateDynamicBuffer(); }
+    	};
+
+    	R  r;
+    	r.a = 0x0102;
+    	r.b = -2;
+    	r.c = 1.0;
+		CPPUNIT_ASSERT_EQUAL(string("\x01\x02\xFF\xFF\xFF\xFE\x3F\xF0\0\0\0\0\0\0", 14), bytes(r));
+		CPPUNIT_ASSERT_EQUAL(static_cast<uint16_t>(0x0102), r.a.value());
+		CPPUNIT_ASSERT_EQUAL(-2, r.b.value());
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, r.c.value(), 0.0);
+    }
+
+    void little_endian_fields_should_be_stored_least_significant_first() {
+    	struct R : public Record {
+    		LittleEndian<uint32_t>	a = {this};
+
+    		R() { allocateDynamicBuffer(); }
+    	};
+
+    	R  r;
+    	r.a = 0x01020304;
+		CPPUNIT_ASSERT_EQUAL(string("\x04\x03\x02\x01", 4), bytes(r));
+		CPPUNIT_ASSERT_EQUAL(0x01020304U, r.a.value());
+    }
+
+    void packed_decimals_should_work() {
+    	struct R : public Record {
+    		Packed<3>					num = {this};
+    		Packed<4, double, 2>		amt = {this};
+
+    		R() { allocateDynamicBuffer(); }
+    	};
+
+    	R  r;
+    	r.num = -12345;
+    	r.amt = 1234.56;
+		CPPUNIT_ASSERT_EQUAL(string("\x12\x34\x5D\x01\x23\x45\x6C", 7), bytes(r));
+		CPPUNIT_ASSERT_EQUAL(-12345LL, r.num.value());
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(1234.56, r.amt.value(), 0.001);
+
+		r.num = 1234567;
+		CPPUNIT_ASSERT_EQUAL(99999LL, r.num.value());
+
+		char  unsignedPacked[7] = {0x00, 0x04, 0x2F};
+		r << unsignedPacked;
+		CPPUNIT_ASSERT_EQUAL(42LL, r.num.value());
+		CPPUNIT_ASSERT(FieldKind::PACKED_DECIMAL == Record::layout<R>().fields[0].kind);
+    }
+
+    void zoned_decimals_should_work() {
+    	struct R : public Record {
+    		Zoned<4, int>		num = {this};
+
+    		R() { allocateDynamicBuffer(); }
+    	};
+
+    	R  r;
+    	r.num = -123;
+		CPPUNIT_ASSERT_EQUAL(string("\xF0\xF1\xF2\xD3", 4), bytes(r));
+		CPPUNIT_ASSERT_EQUAL(-123, r.num.value());
+
+		r.num = 42;
+		CPPUNIT_ASSERT_EQUAL(string("\xF0\xF0\xF4\xC2", 4), bytes(r));
+		CPPUNIT_ASSERT_EQUAL(42, r.num.value());
+    }
+
+};
+CPPUNIT_TEST_SUITE_REGISTRATION( LegacyFields_Test );
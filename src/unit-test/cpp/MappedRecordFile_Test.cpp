@@ -0,0 +1,98 @@
+/*
+ * MappedRecordFile_Test.cpp
+ *
+ *  Memory-mapped record files.
+ */
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <fstream>
+#include <cstdlib>
+#include "MappedRecordFile.hpp"
+using namespace overlay_record;
+using namespace std;
+
+struct MappedRecordFile_Test : public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE( MappedRecordFile_Test );
+		CPPUNIT_TEST( reading_a_mapped_file_should_work );
+		CPPUNIT_TEST( writing_a_mapped_file_should_update_the_file );
+		CPPUNIT_TEST( creating_a_mapped_file_should_work );
+		CPPUNIT_TEST( mapping_a_missing_file_should_fail );
+		CPPUNIT_TEST( read_only_mapping_should_require_const_records );
+    CPPUNIT_TEST_SUITE_END();
+
+	struct R : public Record {
+		Text<3>				txt = {this};
+		TextInteger<2>		num = {this};
+	};
+
+	string  path;
+
+	void setUp() {
+		char  name[] = "/tmp/MappedRecordFile_Test-XXXXXX";
+		int   fd = mkstemp(name);
+		close(fd);
+		path = name;
+
+		ofstream  f(path.c_str(), ios::binary);
+		f << "abc01def02ghi03xy";
+	}
+
+	void tearDown() {
+		unlink(path.c_str());
+	}
+
+	string contents() {
+		ifstream  f(path.c_str(), ios::binary);
+		return string(istreambuf_iterator<char>(f), istreambuf_iterator<char>());
+	}
+
+    void reading_a_mapped_file_should_work() {
+    	MappedRecordFile<const R>  file(path);
+		CPPUNIT_ASSERT_EQUAL(3UL, (unsigned long)file.size());
+		CPPUNIT_ASSERT_EQUAL(17UL, (unsigned long)file.fileSize());
+
+		int  k = 0;
+		for (const R& r : file) CPPUNIT_ASSERT_EQUAL(++k, r.num.value());
+		CPPUNIT_ASSERT_EQUAL(string("ghi"), file[2].txt.value());
+		CPPUNIT_ASSERT_THROW(file.at(3), IndexOutOfBounds);
+    }
+
+    void writing_a_mapped_file_should_update_the_file() {
+    	{
+    		MappedRecordFile<R>  file(path, MapMode::READ_WRITE, MapAdvice::RANDOM);
+    		file[1].txt = "DEF";
+    		file[1].num = 42;
+    		file.sync();
+    	}
+		CPPUNIT_ASSERT_EQUAL(string("abc01DEF42ghi03xy"), contents());
+    }
+
+    void creating_a_mapped_file_should_work() {
+    	{
+    		MappedRecordFile<R>  file(path, 2);
+    		CPPUNIT_ASSERT_EQUAL(2UL, (unsigned long)file.size());
+    		for (R r : file) {
+    			r.txt = "xyz";
+    			r.num = 7;
+    		}
+    	}
+		CPPUNIT_ASSERT_EQUAL(string("xyz7 xyz7 "), contents());
+    }
+
+    void mapping_a_missing_file_should_fail() {
+		CPPUNIT_ASSERT_THROW(MappedRecordFile<R>("/no/such/file"), std::system_error);
+    }
+
+    void read_only_mapping_should_require_const_records() {
+		CPPUNIT_ASSERT_THROW(MappedRecordFile<R>(path, MapMode::READ_ONLY), std::invalid_argument);
+
+		MappedRecordFile<const R>  file(path);
+		static_assert(is_same<decltype(file[0]), const R>::value, "read-only file should hand out const records");
+		static_assert(is_same<decltype(file.data()), const char*>::value, "read-only file should have const storage");
+		CPPUNIT_ASSERT(file[0].isReadOnly());
+		file.sync();
+    }
+
+};
+CPPUNIT_TEST_SUITE_REGISTRATION( MappedRecordFile_Test );
@@ -0,0 +1,120 @@
+/*
+ * Parallel_Test.cpp
+ *
+ *  Parallel scanning of record ranges.
+ */
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <stdexcept>
+#include "Parallel.hpp"
+using namespace overlay_record;
+using namespace std;
+
+struct Parallel_Test : public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE( Parallel_Test );
+		CPPUNIT_TEST( for_each_should_visit_every_record_once );
+		CPPUNIT_TEST( reduce_should_match_a_serial_sum );
+		CPPUNIT_TEST( skewed_work_should_be_balanced );
+		CPPUNIT_TEST( exceptions_should_propagate_to_the_caller );
+		CPPUNIT_TEST( started_threads_should_be_joined_on_exceptions );
+		CPPUNIT_TEST( empty_and_tiny_views_should_work );
+    CPPUNIT_TEST_SUITE_END();
+
+	struct X : public Record {
+		Text<2>				tag = {this};
+	};
+
+	struct R : public Record {
+		Integer				val   = {this};
+		TextInteger<4>		hits  = {this};
+		Embed<X>			x     = {this};
+	};
+
+	static const size_t  N = 10007;
+	vector<char>  buf;
+
+	void setUp() {
+		buf.assign(N * Record::layout<R>().size, '\0');
+		RecordView<R>  view(buf.data(), buf.size());
+		for (size_t k = 0; k < N; ++k) {
+			view[k].val  = k;
+			view[k].hits = 0;
+			view[k].x->tag = "ab";
+		}
+	}
+
+    void for_each_should_visit_every_record_once() {
+		RecordView<R>  view(buf.data(), buf.size());
+		for (unsigned threads : {1U, 2U, 4U, 7U}) {
+			parallelForEach(view, [](R& r) {
+				r.hits = r.hits + 1;
+				if (r.x->tag.value() != "ab") throw logic_error("wrong embed");
+			}, ParallelOptions(threads, 100 * view.recordSize()));
+		}
+		for (const R& r : view) CPPUNIT_ASSERT_EQUAL(4, r.hits.value());
+    }
+
+    void reduce_should_match_a_serial_sum() {
+		RecordView<R>  view(buf.data(), buf.size());
+		long  expected = 0;
+		for (const R& r : view) expected += r.val;
+
+		for (unsigned threads : {0U, 1U, 3U, 8U}) {
+			long  sum = parallelReduce(view, 0L,
+					[](long s, R& r) { return s + r.val; },
+					[](long a, long b) { return a + b; },
+					ParallelOptions(threads, 1000));
+			CPPUNIT_ASSERT_EQUAL(expected, sum);
+		}
+    }
+
+    void skewed_work_should_be_balanced() {
+		RecordView<R>  view(buf.data(), buf.size());
+		atomic<long>  count(0);
+		parallelForEach(view, [&](R& r) {
+			volatile long  spin = r.val < 500 ? 20000 : 0;   //all cost at the front
+			while (spin > 0) --spin;
+			++count;
+		}, ParallelOptions(4, 10 * view.recordSize()));
+		CPPUNIT_ASSERT_EQUAL((long)N, count.load());
+    }
+
+    void exceptions_should_propagate_to_the_caller() {
+		RecordView<R>  view(buf.data(), buf.size());
+		CPPUNIT_ASSERT_THROW(parallelForEach(view, [](R& r) {
+			if (r.val == 4711) throw runtime_error("bad record");
+		}, ParallelOptions(4, 1000)), runtime_error);
+    }
+
+    void started_threads_should_be_joined_on_exceptions() {
+		atomic<int>  done(0);
+		try {
+			detail::JoiningThreads  threads;
+			for (int k = 0; k < 3; ++k) threads.start([&done]() {
+				this_thread::sleep_for(chrono::milliseconds(10));
+				++done;
+			});
+			throw runtime_error("cannot start another thread");
+		} catch (runtime_error&) {
+			CPPUNIT_ASSERT_EQUAL(3, done.load());
+		}
+    }
+
+    void empty_and_tiny_views_should_work() {
+		int  n = 0;
+		parallelForEach(RecordView<R>(), [&](R&) { ++n; });
+		CPPUNIT_ASSERT_EQUAL(0, n);
+
+		RecordView<R>  one(buf.data(), Record::layout<R>().size);
+		int  sum = parallelReduce(one, 0, [](int s, R& r) { return s + r.val + 1; }, [](int a, int b) { return a + b; },
+				ParallelOptions(16));
+		CPPUNIT_ASSERT_EQUAL(1, sum);
+    }
+
+};
+CPPUNIT_TEST_SUITE_REGISTRATION( Parallel_Test );
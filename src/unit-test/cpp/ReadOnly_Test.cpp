@@ -0,0 +1,149 @@
+/*
+ * ReadOnly_Test.cpp
+ *
+ *  Read-only overlays of const storage.
+ */
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <type_traits>
+#include <thread>
+#include <vector>
+#include "Parallel.hpp"
+#include "RecordBuffer.hpp"
+using namespace overlay_record;
+using namespace std;
+
+static const char  DATA[] = "r1abcabc01r2defdef02";
+
+struct ReadOnly_Test : public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE( ReadOnly_Test );
+		CPPUNIT_TEST( const_storage_should_be_readable );
+		CPPUNIT_TEST( read_only_views_should_hand_out_const_records );
+		CPPUNIT_TEST( embedded_records_should_be_bound_eagerly );
+		CPPUNIT_TEST( writes_should_be_refused );
+		CPPUNIT_TEST( concurrent_readers_should_share_one_overlay );
+		CPPUNIT_TEST( concurrent_indexing_should_use_an_overlay_per_thread );
+    CPPUNIT_TEST_SUITE_END();
+
+	struct X : public Record {
+		Text<3>				txt = {this};
+		TextInteger<2>		num = {this};
+	};
+
+	struct R : public Record {
+		Text<2>				id  = {this};
+		Array<Text<1>, 3>	arr = {this};
+		Embed<X>			x   = {this};
+	};
+
+	void const_storage_should_be_readable() {
+		R  rec;
+		const R&  r = static_cast<const R&>(rec.assignReadOnlyBuffer(DATA, sizeof(DATA)));
+
+		CPPUNIT_ASSERT_EQUAL(string("r1"), r.id.value());
+		CPPUNIT_ASSERT_EQUAL(string("b"), r.arr[1].value());
+		CPPUNIT_ASSERT_EQUAL(string("abc"), r.x->txt.value());
+		CPPUNIT_ASSERT_EQUAL(1, r.x->num.value());
+
+		string  all;
+		for (auto& item : r.arr) all += item.value();
+		CPPUNIT_ASSERT_EQUAL(string("abc"), all);
+	}
+
+	void read_only_views_should_hand_out_const_records() {
+		RecordView<const R>  view(DATA, sizeof(DATA) - 1);
+		static_assert(is_same<decltype(view[0]), const R>::value, "const view should hand out const records");
+		static_assert(is_same<decltype(*view.begin()), const R>::value, "const view should hand out const records");
+		static_assert(is_same<decltype(view[0].id.begin()), const char*>::value, "const records should have const storage");
+		static_assert(is_same<decltype(view[0].x->begin()), const char*>::value, "const records should have const storage");
+		static_assert(is_same<decltype(view[0].end()), const char*>::value, "const records should have const storage");
+
+		CPPUNIT_ASSERT_EQUAL(2UL, (unsigned long)view.size());
+		CPPUNIT_ASSERT_EQUAL(string("def"), view[1].x->txt.value());
+
+		char  buf[sizeof(DATA)];
+		memcpy(buf, DATA, sizeof(DATA));
+		RecordView<R>        writable(buf, sizeof(buf));
+		RecordView<const R>  readable = writable;
+		writable[1].x->num = 7;
+		CPPUNIT_ASSERT_EQUAL(7, readable.back().x->num.value());
+	}
+
+	void embedded_records_should_be_bound_eagerly() {
+		R  r;
+		r.assignReadOnlyBuffer(DATA, sizeof(DATA));
+		CPPUNIT_ASSERT(DATA + 5 == static_cast<const R&>(r).x->begin());
+
+		++r;
+		CPPUNIT_ASSERT_EQUAL(string("def"), r.x->txt.value());
+		--r;
+		CPPUNIT_ASSERT_EQUAL(string("abc"), r.x->txt.value());
+	}
+
+	void writes_should_be_refused() {
+		char  buf[sizeof(DATA)];
+		memcpy(buf, DATA, sizeof(DATA));
+		R  rec;
+		rec.assignReadOnlyBuffer(buf, sizeof(buf));
+		CPPUNIT_ASSERT(rec.isReadOnly());
+		CPPUNIT_ASSERT_EQUAL(string("r1"), rec.id.value());
+
+		CPPUNIT_ASSERT_THROW(rec.id = "xx", ReadOnlyStorage);
+		CPPUNIT_ASSERT_THROW(rec.x->num = 7, ReadOnlyStorage);
+		CPPUNIT_ASSERT_THROW(rec.arr[0] = "y", ReadOnlyStorage);
+		R  copy(rec);
+		CPPUNIT_ASSERT_THROW(copy.id = "xx", ReadOnlyStorage);
+		CPPUNIT_ASSERT(memcmp(buf, DATA, sizeof(DATA)) == 0);
+
+		rec.assignStaticBuffer(buf, sizeof(buf));
+		rec.x->num = 7;
+		CPPUNIT_ASSERT_EQUAL(7, rec.x->num.value());
+	}
+
+	void concurrent_readers_should_share_one_overlay() {
+		R  rec;
+		const R&  r = static_cast<const R&>(rec.assignReadOnlyBuffer(DATA, sizeof(DATA)));
+
+		vector<int>     sums(4);
+		vector<thread>  threads;
+		for (unsigned t = 0; t < sums.size(); ++t) {
+			threads.emplace_back([&r, &sums, t]() {
+				for (int k = 0; k < 1000; ++k) sums[t] += r.x->num.value() + (int)r.arr[2].view().size();
+			});
+		}
+		for (auto& t : threads) t.join();
+		for (int s : sums) CPPUNIT_ASSERT_EQUAL(2000, s);
+
+		RecordView<const R>  view(DATA, sizeof(DATA) - 1);
+		int  total = parallelReduce(view, 0, [](int s, const R& r) { return s + r.x->num.value(); },
+				[](int a, int b) { return a + b; }, ParallelOptions(2, 1));
+		CPPUNIT_ASSERT_EQUAL(3, total);
+	}
+
+	void concurrent_indexing_should_use_an_overlay_per_thread() {
+		RecordBuffer<R>  table;
+		table.push_back().id = "r1";
+		table.push_back().id = "r2";
+		const RecordBuffer<R>&  readable = table;
+		static_assert(is_same<decltype(readable[0]), const R>::value, "const buffer should hand out const records");
+		static_assert(is_same<decltype(readable.data()), const char*>::value, "const buffer should have const storage");
+
+		const RecordView<const R>  view(DATA, sizeof(DATA) - 1);
+		vector<int>     hits(4);
+		vector<thread>  threads;
+		for (unsigned t = 0; t < hits.size(); ++t) {
+			threads.emplace_back([&view, &readable, &hits, t]() {
+				for (int k = 0; k < 1000; ++k) {
+					const R&  r = view[(k + t) % 2];
+					if (r.id.value() == ((k + t) % 2 ? "r2" : "r1")) ++hits[t];
+					if (readable[k % 2].id.value() == (k % 2 ? "r2" : "r1")) ++hits[t];
+				}
+			});
+		}
+		for (auto& t : threads) t.join();
+		for (int h : hits) CPPUNIT_ASSERT_EQUAL(2000, h);
+	}
+
+};
+CPPUNIT_TEST_SUITE_REGISTRATION( ReadOnly_Test );
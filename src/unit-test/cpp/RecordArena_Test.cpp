@@ -0,0 +1,92 @@
+/*
+ * RecordArena_Test.cpp
+ *
+ *  Pooled storage for many records.
+ */
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <sstream>
+#include "RecordArena.hpp"
+using namespace overlay_record;
+using namespace std;
+
+struct RecordArena_Test : public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE( RecordArena_Test );
+		CPPUNIT_TEST( records_should_be_adjacent_within_a_slab );
+		CPPUNIT_TEST( slabs_should_be_cache_line_aligned );
+		CPPUNIT_TEST( full_slabs_should_be_followed_by_new_ones );
+		CPPUNIT_TEST( reset_should_reuse_the_storage );
+		CPPUNIT_TEST( records_should_be_written_in_allocation_order );
+    CPPUNIT_TEST_SUITE_END();
+
+	struct R : public Record {
+		Text<3>				txt = {this};
+		TextInteger<2>		num = {this};
+	};
+
+    void records_should_be_adjacent_within_a_slab() {
+    	RecordArena  arena;
+    	R  r1, r2;
+    	arena.allocate(r1);
+    	arena.allocate(r2);
+    	CPPUNIT_ASSERT(r1.end() == r2.begin());
+    	CPPUNIT_ASSERT_EQUAL(string(5, '\0'), string(r2.begin(), r2.end()));
+    	CPPUNIT_ASSERT_EQUAL(10UL, (unsigned long)arena.size());
+    }
+
+    void slabs_should_be_cache_line_aligned() {
+    	RecordArena  arena(100);
+    	for (int k = 0; k < 50; ++k) {
+    		char*  p = arena.allocate(30);
+    		if (k % 3 == 0) CPPUNIT_ASSERT_EQUAL(0UL, reinterpret_cast<unsigned long>(p) % 64);
+    	}
+    }
+
+    void full_slabs_should_be_followed_by_new_ones() {
+    	RecordArena  arena(12);
+    	R  r;
+    	for (int k = 0; k < 5; ++k) arena.allocate(r);
+    	CPPUNIT_ASSERT_EQUAL(25UL, (unsigned long)arena.size());
+    	CPPUNIT_ASSERT_EQUAL(36UL, (unsigned long)arena.capacity());
+    	CPPUNIT_ASSERT_EQUAL(3UL, (unsigned long)arena.blocks().size());
+
+    	arena.allocate(40);
+    	CPPUNIT_ASSERT_EQUAL(76UL, (unsigned long)arena.capacity());
+    }
+
+    void reset_should_reuse_the_storage() {
+    	RecordArena  arena(64);
+    	char*  first = arena.allocate(10);
+    	first[0] = 'x';
+    	arena.allocate(60);
+
+    	arena.reset();
+    	CPPUNIT_ASSERT_EQUAL(0UL, (unsigned long)arena.size());
+    	CPPUNIT_ASSERT(arena.blocks().empty());
+
+    	char*  again = arena.allocate(10);
+    	CPPUNIT_ASSERT(first == again);
+    	CPPUNIT_ASSERT_EQUAL('\0', again[0]);
+    	CPPUNIT_ASSERT_EQUAL(128UL, (unsigned long)arena.capacity());
+
+    	arena.release();
+    	CPPUNIT_ASSERT_EQUAL(0UL, (unsigned long)arena.capacity());
+    }
+
+    void records_should_be_written_in_allocation_order() {
+    	RecordArena  arena(10);
+    	for (int k = 1; k <= 3; ++k) {
+    		R  r;
+    		arena.allocate(r);
+    		r.txt = string(3, 'a' + k - 1);
+    		r.num = k;
+    	}
+
+    	ostringstream  os;
+    	arena.writeTo(os);
+    	CPPUNIT_ASSERT_EQUAL(string("aaa1 bbb2 ccc3 "), os.str());
+    }
+
+};
+CPPUNIT_TEST_SUITE_REGISTRATION( RecordArena_Test );
@@ -0,0 +1,156 @@
+/*
+ * RecordBuffer_Test.cpp
+ *
+ *  Owning, growable container of fixed-size records.
+ */
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <algorithm>
+#include "RecordBuffer.hpp"
+using namespace overlay_record;
+using namespace std;
+
+struct RecordBuffer_Test : public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE( RecordBuffer_Test );
+		CPPUNIT_TEST( push_back_should_append_zeroed_records );
+		CPPUNIT_TEST( growing_should_keep_the_records );
+		CPPUNIT_TEST( records_should_be_contiguous );
+		CPPUNIT_TEST( own_records_should_be_appended_while_growing );
+		CPPUNIT_TEST( copies_should_be_deep );
+		CPPUNIT_TEST( iterators_should_work_with_algorithms );
+		CPPUNIT_TEST( bounds_should_be_checked_by_at );
+		CPPUNIT_TEST( records_should_be_distinct_overlays );
+    CPPUNIT_TEST_SUITE_END();
+
+	struct R : public Record {
+		Text<3>				txt = {this};
+		TextInteger<2>		num = {this};
+	};
+
+	static void fill(RecordBuffer<R>& buf, int n) {
+		for (int k = 1; k <= n; ++k) {
+			R  r = buf.push_back();
+			r.txt = string(3, 'a' + k - 1);
+			r.num = k;
+		}
+	}
+
+    void push_back_should_append_zeroed_records() {
+    	RecordBuffer<R>  buf;
+    	CPPUNIT_ASSERT(buf.empty());
+    	CPPUNIT_ASSERT_EQUAL(0UL, (unsigned long)buf.capacity());
+
+    	R  r = buf.push_back();
+    	CPPUNIT_ASSERT_EQUAL(string(5, '\0'), string(r.begin(), r.end()));
+    	CPPUNIT_ASSERT_EQUAL(1UL, (unsigned long)buf.size());
+    	CPPUNIT_ASSERT_EQUAL(5U, buf.recordSize());
+    }
+
+    void growing_should_keep_the_records() {
+    	RecordBuffer<R>  buf;
+    	buf.reserve(2);
+    	CPPUNIT_ASSERT_EQUAL(2UL, (unsigned long)buf.capacity());
+
+    	fill(buf, 9);
+    	CPPUNIT_ASSERT_EQUAL(9UL, (unsigned long)buf.size());
+    	CPPUNIT_ASSERT(buf.capacity() >= 9);
+    	for (int k = 0; k < 9; ++k) CPPUNIT_ASSERT_EQUAL(k + 1, buf[k].num.value());
+    	CPPUNIT_ASSERT_EQUAL(0UL, reinterpret_cast<unsigned long>(buf.data()) % 64);
+
+    	buf.resize(11);
+    	CPPUNIT_ASSERT_EQUAL(string(5, '\0'), string(buf.back().begin(), buf.back().end()));
+    	buf.pop_back();
+    	CPPUNIT_ASSERT_EQUAL(10UL, (unsigned long)buf.size());
+    	buf.clear();
+    	CPPUNIT_ASSERT(buf.empty());
+    }
+
+    void records_should_be_contiguous() {
+    	RecordBuffer<R>  buf;
+    	fill(buf, 3);
+
+    	char  other[] = "xyz99";
+    	R  r;
+    	r.assignStaticBuffer(other, 5);
+    	buf.push_back(r);
+
+    	CPPUNIT_ASSERT_EQUAL(string("aaa1 bbb2 ccc3 xyz99"), string(buf.data(), buf.size() * buf.recordSize()));
+    	CPPUNIT_ASSERT_EQUAL(4UL, (unsigned long)buf.view().size());
+    }
+
+    void own_records_should_be_appended_while_growing() {
+    	RecordBuffer<R>  buf;
+    	buf.reserve(3);
+    	fill(buf, 3);
+    	CPPUNIT_ASSERT_EQUAL(buf.size(), buf.capacity());
+
+    	buf.push_back(buf[1]);
+    	buf.push_back(buf.back());
+    	CPPUNIT_ASSERT_EQUAL(string("aaa1 bbb2 ccc3 bbb2 bbb2 "), string(buf.data(), buf.size() * buf.recordSize()));
+
+    	struct Wider : public Record {
+    		Text<6>		txt = {this};
+    	} wider;
+    	CPPUNIT_ASSERT_THROW(buf.push_back(wider), StorageOverflow);
+    	CPPUNIT_ASSERT_EQUAL(5UL, (unsigned long)buf.size());
+    }
+
+    void copies_should_be_deep() {
+    	RecordBuffer<R>  buf;
+    	fill(buf, 3);
+
+    	RecordBuffer<R>  copy(buf);
+    	copy[0].txt = "zzz";
+    	CPPUNIT_ASSERT_EQUAL(string("aaa"), buf[0].txt.value());
+
+    	RecordBuffer<R>  moved(std::move(copy));
+    	CPPUNIT_ASSERT(copy.empty());
+    	CPPUNIT_ASSERT_EQUAL(string("zzz"), moved[0].txt.value());
+
+    	buf = moved;
+    	CPPUNIT_ASSERT_EQUAL(string("zzz"), buf.front().txt.value());
+
+    	const RecordBuffer<R>  empty;
+    	RecordBuffer<R>  emptyCopy(empty);
+    	CPPUNIT_ASSERT(emptyCopy.empty());
+    }
+
+    void iterators_should_work_with_algorithms() {
+    	RecordBuffer<R>  buf;
+    	fill(buf, 5);
+
+    	auto  it = find_if(buf.begin(), buf.end(), [](const R& r) { return r.num == 4; });
+    	CPPUNIT_ASSERT_EQUAL(3L, (long)(it - buf.begin()));
+
+    	int  sum = 0;
+    	for (const R& r : buf) sum += r.num;
+    	CPPUNIT_ASSERT_EQUAL(15, sum);
+    }
+
+    void bounds_should_be_checked_by_at() {
+    	RecordBuffer<R>  buf(2);
+    	CPPUNIT_ASSERT_EQUAL(0, buf.at(1).num.value());
+    	CPPUNIT_ASSERT_THROW(buf.at(2), IndexOutOfBounds);
+    }
+
+    void records_should_be_distinct_overlays() {
+    	RecordBuffer<R>  buf;
+    	buf.reserve(3);
+    	R  a = buf.push_back();
+    	R  b = buf.push_back();
+    	CPPUNIT_ASSERT(a.begin() != b.begin());
+    	a.num = 1;
+    	b.num = 2;
+
+    	buf[0].num = buf[1].num;
+    	CPPUNIT_ASSERT_EQUAL(2, buf[0].num.value());
+    	CPPUNIT_ASSERT_EQUAL(2, a.num.value());
+
+    	const RecordBuffer<R>&  readOnly = buf;
+    	CPPUNIT_ASSERT(readOnly[0].isReadOnly());
+    	CPPUNIT_ASSERT(!buf[0].isReadOnly());
+    }
+
+};
+CPPUNIT_TEST_SUITE_REGISTRATION( RecordBuffer_Test );
@@ -0,0 +1,151 @@
+/*
+ * RecordCopy_Test.cpp
+ *
+ *  Copy and move semantics of records.
+ */
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <type_traits>
+#include <vector>
+#include "Record.hpp"
+using namespace overlay_record;
+using namespace std;
+
+struct RecordCopy_Test : public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE( RecordCopy_Test );
+		CPPUNIT_TEST( copying_an_owning_record_should_copy_its_storage );
+		CPPUNIT_TEST( copying_an_overlay_should_share_its_storage );
+		CPPUNIT_TEST( moving_should_steal_the_storage );
+		CPPUNIT_TEST( records_should_work_in_standard_containers );
+		CPPUNIT_TEST( assignment_should_follow_copy_and_move );
+		CPPUNIT_TEST( deep_copy_should_detach_from_shared_storage );
+		CPPUNIT_TEST( standalone_field_copies_should_keep_their_record );
+    CPPUNIT_TEST_SUITE_END();
+
+	struct X : public Record {
+		Text<2>				txt = {this};
+		TextInteger<2>		num = {this};
+	};
+
+	struct R : public Record {
+		Text<3>				txt = {this};
+		Array<Text<1>, 2>	arr = {this};
+		Embed<X>			x   = {this};
+
+		R() { allocateDynamicBuffer(); }
+		R(char* buf, unsigned bufsiz) { assignStaticBuffer(buf, bufsiz); }
+	};
+
+	static R  make(const string& txt, int num) {
+		R  r;
+		r.txt = txt;
+		r.arr[1] = txt.substr(0, 1);
+		r.x->num = num;
+		return r;
+	}
+
+	static void assertBoundTo(const R& r, const char* storage) {
+		CPPUNIT_ASSERT(r.begin() == storage);
+		CPPUNIT_ASSERT(r.txt.begin() == storage);
+		CPPUNIT_ASSERT(r.arr[1].begin() == storage + 4);
+		CPPUNIT_ASSERT(r.x->begin() == storage + 5);
+		CPPUNIT_ASSERT(r.x->num.begin() == storage + 7);
+	}
+
+    void copying_an_owning_record_should_copy_its_storage() {
+    	R  r1 = make("abc", 42);
+    	R  r2(r1);
+    	CPPUNIT_ASSERT(r2.ownsBuffer());
+    	CPPUNIT_ASSERT(r2.begin() != r1.begin());
+    	assertBoundTo(r2, r2.begin());
+
+    	r2.txt = "xyz";
+    	r2.x->num = 7;
+    	CPPUNIT_ASSERT_EQUAL(string("abc"), r1.txt.value());
+    	CPPUNIT_ASSERT_EQUAL(42, r1.x->num.value());
+    	CPPUNIT_ASSERT_EQUAL(string("xyz"), r2.txt.value());
+    	CPPUNIT_ASSERT_EQUAL(string("a"), r2.arr[1].value());
+    	CPPUNIT_ASSERT_EQUAL(7, r2.x->num.value());
+    }
+
+    void copying_an_overlay_should_share_its_storage() {
+    	char  buf[] = "abc-bxy42";
+    	R  r1(buf, sizeof(buf));
+    	R  r2(r1);
+    	CPPUNIT_ASSERT(!r2.ownsBuffer());
+    	assertBoundTo(r2, buf);
+
+    	++r2;
+    	assertBoundTo(r1, buf);
+    	assertBoundTo(r2, buf + r1.size());
+    }
+
+    void moving_should_steal_the_storage() {
+    	R  r1 = make("abc", 42);
+    	char*  storage = r1.begin();
+
+    	static_assert(is_nothrow_move_constructible<R>::value, "moving a record should not throw");
+    	R  r2(std::move(r1));
+    	assertBoundTo(r2, storage);
+    	CPPUNIT_ASSERT(r2.ownsBuffer());
+    	CPPUNIT_ASSERT(!r1.ownsBuffer());
+    	CPPUNIT_ASSERT_THROW(r1.begin(), UnInitialized);
+    	CPPUNIT_ASSERT_EQUAL(42, r2.x->num.value());
+    }
+
+    void records_should_work_in_standard_containers() {
+    	vector<R>  records;
+    	for (int k = 0; k < 20; ++k) records.push_back(make(string(3, 'a' + k), k));
+
+    	for (int k = 0; k < 20; ++k) {
+    		assertBoundTo(records[k], records[k].begin());
+    		CPPUNIT_ASSERT_EQUAL(string(3, 'a' + k), records[k].txt.value());
+    		CPPUNIT_ASSERT_EQUAL(k, records[k].x->num.value());
+    	}
+    }
+
+    void assignment_should_follow_copy_and_move() {
+    	R  r1 = make("abc", 42);
+    	R  r2 = make("def", 17);
+    	r2 = r1;
+    	CPPUNIT_ASSERT(r2.begin() != r1.begin());
+    	assertBoundTo(r2, r2.begin());
+    	CPPUNIT_ASSERT_EQUAL(42, r2.x->num.value());
+
+    	char*  storage = r1.begin();
+    	R  r3 = make("ghi", 1);
+    	r3 = std::move(r1);
+    	assertBoundTo(r3, storage);
+    	CPPUNIT_ASSERT_EQUAL(string("abc"), r3.txt.value());
+
+    	r3.txt = r2.x->txt;
+    	r2.txt = R(make("xyz", 0)).txt;
+    	CPPUNIT_ASSERT_EQUAL(string("xyz"), r2.txt.value());
+    }
+
+    void deep_copy_should_detach_from_shared_storage() {
+    	char  buf[] = "abc-bxy42";
+    	R  overlay(buf, sizeof(buf));
+    	R  copy = deepCopy(overlay);
+
+    	CPPUNIT_ASSERT(copy.ownsBuffer());
+    	assertBoundTo(copy, copy.begin());
+    	copy.x->num = 1;
+    	CPPUNIT_ASSERT_EQUAL(42, overlay.x->num.value());
+    	CPPUNIT_ASSERT_EQUAL(1, copy.x->num.value());
+    }
+
+    void standalone_field_copies_should_keep_their_record() {
+    	R  r = make("abc", 42);
+    	Record::Text<3>  f = r.txt;
+    	CPPUNIT_ASSERT(f.begin() == r.begin());
+
+    	R  other = make("xyz", 0);
+    	other.txt = r.txt;
+    	CPPUNIT_ASSERT_EQUAL(string("abc"), other.txt.value());
+    	CPPUNIT_ASSERT(other.txt.begin() == other.begin());
+    }
+
+};
+CPPUNIT_TEST_SUITE_REGISTRATION( RecordCopy_Test );
@@ -0,0 +1,131 @@
+/*
+ * RecordFilter_Test.cpp
+ *
+ *  Selecting records by conditions on their raw field bytes.
+ */
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <vector>
+#include "RecordFilter.hpp"
+using namespace overlay_record;
+using namespace std;
+
+struct RecordFilter_Test : public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE( RecordFilter_Test );
+		CPPUNIT_TEST( text_equality_should_ignore_padding );
+		CPPUNIT_TEST( text_prefixes_should_match );
+		CPPUNIT_TEST( numeric_ranges_should_use_the_field_encoding );
+		CPPUNIT_TEST( conditions_should_be_combined );
+		CPPUNIT_TEST( bitmaps_and_counts_should_agree_with_select );
+    CPPUNIT_TEST_SUITE_END();
+
+	struct R : public Record {
+		Text<4>					status = {this};
+		TextInteger<6>			amount = {this};
+		Long					val    = {this};
+		BigEndian<int32_t>		key    = {this};
+		DecimalDouble<8>		rate   = {this};
+	};
+
+	static const size_t  N = 2500;      //several blocks
+	vector<char>  buf;
+	R  proto;
+
+	void setUp() {
+		buf.assign(N * Record::layout<R>().size, '\0');
+		RecordView<R>  view(buf.data(), buf.size());
+		for (size_t k = 0; k < N; ++k) {
+			R  r = view[k];
+			if (k % 3 != 2) r.status = (k % 3 == 0) ? "OK" : "OKAY";    //else left NUL
+			r.amount = k;
+			r.val    = -(long)k;
+			r.key    = k % 100;
+			r.rate   = k / 10.0;
+		}
+	}
+
+	template<typename Predicate>
+	vector<size_t>  expected(Predicate p) {
+		vector<size_t>  result;
+		for (size_t k = 0; k < N; ++k) if (p(k)) result.push_back(k);
+		return result;
+	}
+
+    void text_equality_should_ignore_padding() {
+    	RecordFilter<R>  filter;
+    	filter.equals(proto.status, "OK");
+    	CPPUNIT_ASSERT(expected([](size_t k){ return k % 3 == 0; }) == filter.select(buf.data(), N));
+
+    	RecordFilter<R>  empty;
+    	empty.equals(proto.status, "");
+    	CPPUNIT_ASSERT(expected([](size_t k){ return k % 3 == 2; }) == empty.select(buf.data(), N));
+
+    	RecordFilter<R>  tooLong;
+    	tooLong.equals(proto.status, "OKAYS");
+    	CPPUNIT_ASSERT_EQUAL((size_t)0, tooLong.count(buf.data(), N));
+    }
+
+    void text_prefixes_should_match() {
+    	RecordFilter<R>  filter;
+    	filter.startsWith(proto.status, "OK");
+    	CPPUNIT_ASSERT(expected([](size_t k){ return k % 3 != 2; }) == filter.select(buf.data(), N));
+
+    	RecordFilter<R>  okay;
+    	okay.startsWith(proto.status, "OKA");
+    	CPPUNIT_ASSERT(expected([](size_t k){ return k % 3 == 1; }) == okay.select(buf.data(), N));
+    }
+
+    void numeric_ranges_should_use_the_field_encoding() {
+    	RecordFilter<R>  amount;
+    	amount.greater(proto.amount, 1000);
+    	CPPUNIT_ASSERT(expected([](size_t k){ return k > 1000; }) == amount.select(buf.data(), N));
+
+    	RecordFilter<R>  val;
+    	val.between(proto.val, -20, -10);
+    	CPPUNIT_ASSERT(expected([](size_t k){ return k >= 10 && k <= 20; }) == val.select(buf.data(), N));
+
+    	RecordFilter<R>  key;
+    	key.equals(proto.key, 42);
+    	CPPUNIT_ASSERT(expected([](size_t k){ return k % 100 == 42; }) == key.select(buf.data(), N));
+
+    	RecordFilter<R>  rate;
+    	rate.less(proto.rate, 1.0);
+    	CPPUNIT_ASSERT(expected([](size_t k){ return k < 10; }) == rate.select(buf.data(), N));
+    }
+
+    void conditions_should_be_combined() {
+    	RecordFilter<R>  filter;
+    	filter.equals(proto.status, "OK").atLeast(proto.amount, 1000).atMost(proto.key, 10);
+    	CPPUNIT_ASSERT_EQUAL((size_t)3, filter.numConditions());
+
+    	vector<size_t>  rows = filter.select(RecordView<const R>(buf.data(), buf.size()));
+    	CPPUNIT_ASSERT(expected([](size_t k){ return k % 3 == 0 && k >= 1000 && k % 100 <= 10; }) == rows);
+    	CPPUNIT_ASSERT(!rows.empty());
+    }
+
+    void bitmaps_and_counts_should_agree_with_select() {
+    	RecordFilter<R>  filter;
+    	filter.startsWith(proto.status, "OKA").less(proto.amount, 2000);
+
+    	vector<size_t>    rows = filter.select(buf.data(), N);
+    	vector<uint64_t>  bits = filter.bitmap(buf.data(), N);
+    	CPPUNIT_ASSERT_EQUAL((N + 63) / 64, bits.size());
+    	CPPUNIT_ASSERT_EQUAL(rows.size(), filter.count(buf.data(), N));
+
+    	size_t  set = 0;
+    	for (size_t k = 0; k < N; ++k) {
+    		if (bits[k / 64] >> (k % 64) & 1) {
+    			CPPUNIT_ASSERT_EQUAL(rows[set], k);
+    			++set;
+    		}
+    	}
+    	CPPUNIT_ASSERT_EQUAL(rows.size(), set);
+
+    	RecordFilter<R>  all;
+    	CPPUNIT_ASSERT_EQUAL(N, all.count(buf.data(), N));
+    }
+
+};
+const size_t  RecordFilter_Test::N;
+CPPUNIT_TEST_SUITE_REGISTRATION( RecordFilter_Test );
@@ -0,0 +1,129 @@
+/*
+ * RecordGroupBy_Test.cpp
+ *
+ *  Aggregating numeric fields, grouped by a key field.
+ */
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <vector>
+#include "RecordGroupBy.hpp"
+using namespace overlay_record;
+using namespace std;
+
+struct RecordGroupBy_Test : public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE( RecordGroupBy_Test );
+		CPPUNIT_TEST( groups_should_be_in_order_of_appearance );
+		CPPUNIT_TEST( aggregates_should_use_the_field_encoding );
+		CPPUNIT_TEST( parallel_aggregation_should_give_the_same_groups );
+		CPPUNIT_TEST( many_groups_should_be_aggregated );
+    CPPUNIT_TEST_SUITE_END();
+
+	struct Sale : public Record {
+		Text<4>					region = {this};
+		TextInteger<6>			amount = {this};
+		LittleEndian<double>	price  = {this};
+		Packed<4>				units  = {this};
+		Integer					id     = {this};
+	};
+
+	static const size_t  N = 6000;
+	vector<char>  buf;
+	Sale  proto;
+
+	static const char*  regionOf(size_t k) {
+		static const char*  regions[] = {"N", "S", "E", "", "W"};
+		return regions[k * 3 % 5];
+	}
+
+	static int  amountOf(size_t k) { return (int)((k * 7919) % 2001) - 1000; }
+
+	void setUp() {
+		buf.assign(N * Record::layout<Sale>().size, '\0');
+		RecordView<Sale>  view(buf.data(), buf.size());
+		for (size_t k = 0; k < N; ++k) {
+			Sale  s = view[k];
+			if (*regionOf(k) != '\0') s.region = regionOf(k);      //else left NUL
+			s.amount = amountOf(k);
+			s.price  = amountOf(k) / 4.0;
+			s.units  = k % 17;
+			s.id     = k;
+		}
+	}
+
+    void groups_should_be_in_order_of_appearance() {
+    	RecordGroupBy<Sale, Sale::Text<4>>  byRegion(proto.region);
+    	byRegion.count();
+    	GroupedValues<Sale::Text<4>>  groups = byRegion.aggregate(buf.data(), N, ParallelOptions(1));
+
+    	CPPUNIT_ASSERT_EQUAL((size_t)5, groups.size());
+    	CPPUNIT_ASSERT_EQUAL(1U, groups.numAggregates());
+    	const char*  order[] = {"N", "", "S", "W", "E"};
+    	for (size_t g = 0; g < 5; ++g) {
+    		CPPUNIT_ASSERT_EQUAL((string(order[g]) + "    ").substr(0, 4), groups.key(g));
+    		CPPUNIT_ASSERT_EQUAL((int64_t)(N / 5), groups.asInteger(g, 0));
+    	}
+    }
+
+    void aggregates_should_use_the_field_encoding() {
+    	RecordGroupBy<Sale, Sale::Text<4>>  byRegion(proto.region);
+    	byRegion.sum(proto.amount).min(proto.amount).max(proto.amount).sum(proto.price).max(proto.units).count();
+    	CPPUNIT_ASSERT_EQUAL((size_t)6, byRegion.numAggregates());
+    	GroupedValues<Sale::Text<4>>  groups = byRegion.aggregate(RecordView<const Sale>(buf.data(), buf.size()));
+
+    	for (size_t g = 0; g < groups.size(); ++g) {
+    		int64_t  sum = 0, lo = 1 << 30, hi = -(1 << 30), count = 0, units = 0;
+    		for (size_t k = 0; k < N; ++k) {
+    			if ((string(regionOf(k)) + "    ").substr(0, 4) != groups.key(g)) continue;
+    			sum += amountOf(k);
+    			lo = min<int64_t>(lo, amountOf(k));
+    			hi = max<int64_t>(hi, amountOf(k));
+    			units = max<int64_t>(units, k % 17);
+    			++count;
+    		}
+    		CPPUNIT_ASSERT_EQUAL(sum, groups.asInteger(g, 0));
+    		CPPUNIT_ASSERT_EQUAL(lo, groups.asInteger(g, 1));
+    		CPPUNIT_ASSERT_EQUAL(hi, groups.asInteger(g, 2));
+    		CPPUNIT_ASSERT_DOUBLES_EQUAL(sum / 4.0, groups.asDouble(g, 3), 1e-9);
+    		CPPUNIT_ASSERT_EQUAL(units, groups.asInteger(g, 4));
+    		CPPUNIT_ASSERT_EQUAL(count, groups.asInteger(g, 5));
+    	}
+    }
+
+    void parallel_aggregation_should_give_the_same_groups() {
+    	RecordGroupBy<Sale, Sale::Packed<4>>  byUnits(proto.units);
+    	byUnits.count().sum(proto.amount).min(proto.price);
+    	GroupedValues<Sale::Packed<4>>  sequential = byUnits.aggregate(buf.data(), N, ParallelOptions(1));
+    	CPPUNIT_ASSERT_EQUAL((size_t)17, sequential.size());
+
+    	for (unsigned threads : {2U, 3U, 8U}) {
+    		GroupedValues<Sale::Packed<4>>  parallel = byUnits.aggregate(buf.data(), N, ParallelOptions(threads, 4096));
+    		CPPUNIT_ASSERT_EQUAL(sequential.size(), parallel.size());
+    		for (size_t g = 0; g < parallel.size(); ++g) {
+    			CPPUNIT_ASSERT_EQUAL((long long)g, sequential.key(g));
+    			CPPUNIT_ASSERT_EQUAL(sequential.key(g), parallel.key(g));
+    			for (unsigned a = 0; a < 3; ++a)
+    				CPPUNIT_ASSERT_EQUAL(sequential.asDouble(g, a), parallel.asDouble(g, a));
+    		}
+    	}
+    }
+
+    void many_groups_should_be_aggregated() {
+    	RecordGroupBy<Sale, Sale::Integer>  byId(proto.id);
+    	byId.sum(proto.amount).count();
+    	GroupedValues<Sale::Integer>  groups = byId.aggregate(buf.data(), N, ParallelOptions(4, 1024));
+
+    	CPPUNIT_ASSERT_EQUAL(N, groups.size());
+    	for (size_t g = 0; g < N; ++g) {
+    		CPPUNIT_ASSERT_EQUAL((int)g, groups.key(g));
+    		CPPUNIT_ASSERT_EQUAL((int64_t)amountOf(g), groups.asInteger(g, 0));
+    		CPPUNIT_ASSERT_EQUAL((int64_t)1, groups.asInteger(g, 1));
+    	}
+
+    	GroupedValues<Sale::Integer>  none = byId.aggregate(buf.data(), 0);
+    	CPPUNIT_ASSERT(none.empty());
+    }
+
+};
+const size_t  RecordGroupBy_Test::N;
+CPPUNIT_TEST_SUITE_REGISTRATION( RecordGroupBy_Test );
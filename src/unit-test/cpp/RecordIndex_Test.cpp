@@ -0,0 +1,216 @@
+/*
+ * RecordIndex_Test.cpp
+ *
+ *  Hash index of records, keyed by the bytes of a field.
+ */
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <cstdlib>
+#include <unistd.h>
+#include <vector>
+#include "RecordIndex.hpp"
+using namespace overlay_record;
+using namespace std;
+
+struct RecordIndex_Test : public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE( RecordIndex_Test );
+		CPPUNIT_TEST( text_keys_should_be_found );
+		CPPUNIT_TEST( numeric_keys_should_use_the_field_encoding );
+		CPPUNIT_TEST( duplicate_keys_should_be_found_in_order );
+		CPPUNIT_TEST( duplicate_keys_should_share_one_slot );
+		CPPUNIT_TEST( parallel_build_should_find_every_record );
+		CPPUNIT_TEST( lookup_should_probe_other_records );
+		CPPUNIT_TEST( saved_index_should_be_mapped );
+		CPPUNIT_TEST( embedded_keys_should_be_found );
+    CPPUNIT_TEST_SUITE_END();
+
+	struct R : public Record {
+		Text<10>			id      = {this};
+		TextInteger<12>		account = {this};
+		BigEndian<int32_t>	group   = {this};
+
+		R() = default;
+		R(char* buf, unsigned bufsiz) { assignStaticBuffer(buf, bufsiz); }
+	};
+
+	struct Order : public Record {
+		Integer				qty      = {this};
+		Text<10>			customer = {this};
+	};
+
+	typedef RecordIndex<R, R::Text<10>>  IdIndex;
+
+	static const size_t  N = 5000;
+	vector<char>  buf;
+	R  proto;
+
+	static string  idOf(size_t k) { return "C" + to_string(k * 7); }
+
+	void setUp() {
+		buf.assign(N * Record::layout<R>().size, '\0');
+		R  r(buf.data(), buf.size());
+		for (size_t k = 0; k < N; ++k, ++r) {
+			if (k > 0) r.id = idOf(k);      //else left NUL
+			r.account = 100000 + k;
+			r.group   = k % 7;
+		}
+	}
+
+    void text_keys_should_be_found() {
+    	IdIndex  index(proto.id);
+    	CPPUNIT_ASSERT_EQUAL(IdIndex::NOT_FOUND, index.find("C7"));
+
+    	index.build(buf.data(), N, ParallelOptions(1));
+    	CPPUNIT_ASSERT_EQUAL(N, index.size());
+    	CPPUNIT_ASSERT(index.numSlots() >= 2 * N);
+    	for (size_t k = 1; k < N; ++k) CPPUNIT_ASSERT_EQUAL((IdIndex::Ordinal)k, index.find(idOf(k)));
+
+    	CPPUNIT_ASSERT_EQUAL((IdIndex::Ordinal)0, index.find(""));
+    	CPPUNIT_ASSERT_EQUAL((IdIndex::Ordinal)0, index.findBytes("          "));
+    	CPPUNIT_ASSERT_EQUAL(IdIndex::NOT_FOUND, index.find("C8"));
+    	CPPUNIT_ASSERT_EQUAL(IdIndex::NOT_FOUND, index.find("C7         "));
+    }
+
+    void numeric_keys_should_use_the_field_encoding() {
+    	RecordIndex<R, R::TextInteger<12>>  accounts(proto.account);
+    	accounts.build(RecordView<const R>(buf.data(), buf.size()));
+    	CPPUNIT_ASSERT_EQUAL((uint64_t)4242, accounts.find(104242));
+    	CPPUNIT_ASSERT_EQUAL(IdIndex::NOT_FOUND, accounts.find(42));
+
+    	RecordIndex<R, R::BigEndian<int32_t>>  groups(proto.group);
+    	groups.build(buf.data(), N);
+    	CPPUNIT_ASSERT_EQUAL((uint64_t)3, groups.find(3));
+    	CPPUNIT_ASSERT_EQUAL(IdIndex::NOT_FOUND, groups.find(7));
+    }
+
+    void duplicate_keys_should_be_found_in_order() {
+    	RecordIndex<R, R::BigEndian<int32_t>>  groups(proto.group);
+    	groups.build(buf.data(), N, ParallelOptions(3, 1000));
+
+    	vector<uint64_t>  fives = groups.findAll(5);
+    	CPPUNIT_ASSERT_EQUAL((N - 5 + 6) / 7, fives.size());
+    	for (size_t k = 0; k < fives.size(); ++k) CPPUNIT_ASSERT_EQUAL((uint64_t)(5 + 7 * k), fives[k]);
+    	CPPUNIT_ASSERT_EQUAL((uint64_t)5, groups.find(5));
+    	CPPUNIT_ASSERT(groups.findAll(9).empty());
+    }
+
+    void duplicate_keys_should_share_one_slot() {
+    	for (unsigned threads : {1U, 3U}) {
+    		RecordIndex<R, R::BigEndian<int32_t>>  groups(proto.group);
+    		groups.build(buf.data(), N, ParallelOptions(threads, 1000));
+    		CPPUNIT_ASSERT_EQUAL((uint64_t)7, groups.numKeys());
+    		size_t  total = 0;
+    		for (int g = 0; g < 7; ++g) total += groups.findAll(g).size();
+    		CPPUNIT_ASSERT_EQUAL(N, total);
+    	}
+
+    	vector<char>  blank(N * Record::layout<R>().size, '\0');
+    	IdIndex  index(proto.id);
+    	index.build(blank.data(), N, ParallelOptions(3, 1000));
+    	CPPUNIT_ASSERT_EQUAL((uint64_t)1, index.numKeys());
+    	vector<uint64_t>  all = index.findAll("");
+    	CPPUNIT_ASSERT_EQUAL(N, all.size());
+    	for (size_t k = 0; k < N; ++k) CPPUNIT_ASSERT_EQUAL((uint64_t)k, all[k]);
+    }
+
+    void parallel_build_should_find_every_record() {
+    	IdIndex  sequential(proto.id);
+    	sequential.build(buf.data(), N, ParallelOptions(1));
+    	for (unsigned threads : {2U, 3U, 8U}) {
+    		IdIndex  index(proto.id);
+    		index.build(buf.data(), N, ParallelOptions(threads, 4096));
+    		CPPUNIT_ASSERT_EQUAL(sequential.numSlots(), index.numSlots());
+    		for (size_t k = 1; k < N; ++k) CPPUNIT_ASSERT_EQUAL((IdIndex::Ordinal)k, index.find(idOf(k)));
+    		CPPUNIT_ASSERT_EQUAL((IdIndex::Ordinal)0, index.find(""));
+    	}
+
+    	IdIndex  empty(proto.id);
+    	empty.build(buf.data(), 0, ParallelOptions(4));
+    	CPPUNIT_ASSERT_EQUAL(IdIndex::NOT_FOUND, empty.find("C7"));
+    }
+
+    void lookup_should_probe_other_records() {
+    	IdIndex  index(proto.id);
+    	index.build(buf.data(), N);
+
+    	const size_t  M = 100;
+    	vector<char>  orders(M * Record::layout<Order>().size, '\0');
+    	RecordView<Order>  view(orders.data(), orders.size());
+    	for (size_t k = 0; k < M; ++k) view[k].customer = idOf(k * 97 % (2 * N));
+
+    	Order  order;
+    	vector<uint64_t>  customers = index.lookup(view, order.customer);
+    	CPPUNIT_ASSERT_EQUAL(M, customers.size());
+    	for (size_t k = 0; k < M; ++k) {
+    		const size_t  key = k * 97 % (2 * N);
+    		const uint64_t  expected = (key > 0 && key < N) ? key : IdIndex::NOT_FOUND;
+    		CPPUNIT_ASSERT_EQUAL(expected, customers[k]);
+    	}
+    }
+
+    void saved_index_should_be_mapped() {
+    	char  name[] = "/tmp/RecordIndex_Test-XXXXXX";
+    	int   fd = mkstemp(name);
+    	close(fd);
+
+    	IdIndex  built(proto.id);
+    	CPPUNIT_ASSERT_THROW(built.save(name), UnInitialized);
+    	built.build(buf.data(), N);
+    	built.save(name);
+
+    	IdIndex  mapped(proto.id);
+    	mapped.load(name, RecordView<const R>(buf.data(), buf.size()));
+    	CPPUNIT_ASSERT(mapped.isMapped());
+    	CPPUNIT_ASSERT_EQUAL(built.numSlots(), mapped.numSlots());
+    	for (size_t k = 1; k < N; ++k) CPPUNIT_ASSERT_EQUAL((IdIndex::Ordinal)k, mapped.find(idOf(k)));
+    	CPPUNIT_ASSERT_EQUAL(built.numKeys(), mapped.numKeys());
+
+    	IdIndex  fewer(proto.id);
+    	CPPUNIT_ASSERT_THROW(fewer.load(name, buf.data(), N - 1), std::runtime_error);
+    	RecordIndex<R, R::TextInteger<12>>  other(proto.account);
+    	CPPUNIT_ASSERT_THROW(other.load(name, buf.data(), N), std::runtime_error);
+    	unlink(name);
+    	CPPUNIT_ASSERT_THROW(mapped.load(name, buf.data(), N), std::system_error);
+    	CPPUNIT_ASSERT_EQUAL((IdIndex::Ordinal)1, mapped.find(idOf(1)));
+
+    	RecordIndex<R, R::BigEndian<int32_t>>  groups(proto.group);
+    	groups.build(buf.data(), N).save(name);
+    	RecordIndex<R, R::BigEndian<int32_t>>  mappedGroups(proto.group);
+    	mappedGroups.load(name, buf.data(), N);
+    	CPPUNIT_ASSERT_EQUAL((uint64_t)7, mappedGroups.numKeys());
+    	CPPUNIT_ASSERT(groups.findAll(5) == mappedGroups.findAll(5));
+    	unlink(name);
+    }
+
+    void embedded_keys_should_be_found() {
+    	struct Name : public Record {
+    		Text<2>		title = {this};
+    		Text<6>		last  = {this};
+    	};
+    	struct P : public Record {
+    		Integer		no   = {this};
+    		Embed<Name>	name = {this};
+    	};
+
+    	vector<char>  people(3 * Record::layout<P>().size, '\0');
+    	RecordView<P>  view(people.data(), people.size());
+    	const char*  names[] = {"smith", "jones", "brown"};
+    	for (size_t k = 0; k < 3; ++k) {
+    		view[k].no = k;
+    		view[k].name->title = "mr";
+    		view[k].name->last  = names[k];
+    	}
+
+    	P  p;
+    	CPPUNIT_ASSERT_EQUAL(6U, p.name->last.outerOffset());
+    	RecordIndex<P, Record::Text<6>>  index(p.name->last);
+    	index.build(RecordView<const P>(view));
+    	CPPUNIT_ASSERT_EQUAL((uint64_t)1, index.find("jones"));
+    	CPPUNIT_ASSERT_EQUAL((uint64_t)2, index.find("brown"));
+    	CPPUNIT_ASSERT_EQUAL(IdIndex::NOT_FOUND, index.find("mr"));
+    }
+
+};
+const size_t  RecordIndex_Test::N;
+CPPUNIT_TEST_SUITE_REGISTRATION( RecordIndex_Test );
@@ -0,0 +1,115 @@
+/*
+ * RecordJoin_Test.cpp
+ *
+ *  Joining record ranges on a key field.
+ */
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <algorithm>
+#include <vector>
+#include "RecordJoin.hpp"
+using namespace overlay_record;
+using namespace std;
+
+struct RecordJoin_Test : public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE( RecordJoin_Test );
+		CPPUNIT_TEST( join_should_match_equal_keys );
+		CPPUNIT_TEST( duplicate_keys_should_give_all_pairs );
+		CPPUNIT_TEST( parallel_join_should_give_the_same_pairs );
+		CPPUNIT_TEST( empty_inputs_should_give_no_pairs );
+    CPPUNIT_TEST_SUITE_END();
+
+	struct Customer : public Record {
+		Text<8>				id    = {this};
+		BigEndian<int32_t>	group = {this};
+	};
+
+	struct Order : public Record {
+		TextInteger<4>		qty      = {this};
+		Text<8>				customer = {this};
+		BigEndian<int32_t>	group    = {this};
+	};
+
+	static const size_t  NC = 3000;
+	static const size_t  NO = 7000;
+	vector<char>  customers;
+	vector<char>  orders;
+	Customer  customer;
+	Order     order;
+
+	static string  idOf(size_t k) { return "C" + to_string(k); }
+
+	void setUp() {
+		customers.assign(NC * Record::layout<Customer>().size, '\0');
+		RecordView<Customer>  cs(customers.data(), customers.size());
+		for (size_t k = 0; k < NC; ++k) {
+			if (k > 0) cs[k].id = idOf(k);      //else left NUL
+			cs[k].group = k % 10;
+		}
+
+		orders.assign(NO * Record::layout<Order>().size, '\0');
+		RecordView<Order>  os(orders.data(), orders.size());
+		for (size_t k = 0; k < NO; ++k) {
+			os[k].customer = (k % 50 == 0) ? string() : idOf(k * 7 % (NC + 500));
+			os[k].group    = k % 13;
+		}
+	}
+
+	template<typename Equal>
+	vector<JoinMatch>  expected(Equal equal) {
+		vector<JoinMatch>  result;
+		for (size_t o = 0; o < NO; ++o)
+			for (size_t c = 0; c < NC; ++c)
+				if (equal(o, c)) result.push_back(JoinMatch{o, c});
+		return result;
+	}
+
+	static vector<JoinMatch>  sorted(vector<JoinMatch> matches) {
+		sort(matches.begin(), matches.end());
+		return matches;
+	}
+
+    void join_should_match_equal_keys() {
+    	RecordJoin<Order, Customer, Order::Text<8>>  join(order.customer, customer.id);
+    	vector<JoinMatch>  matches = join.join(orders.data(), NO, customers.data(), NC, ParallelOptions(1));
+
+    	vector<JoinMatch>  wanted;
+    	for (size_t o = 0; o < NO; ++o) {
+    		if (o % 50 == 0) wanted.push_back(JoinMatch{o, 0});     //blanks match NUL
+    		else if (o * 7 % (NC + 500) > 0 && o * 7 % (NC + 500) < NC) wanted.push_back(JoinMatch{o, o * 7 % (NC + 500)});
+    	}
+    	CPPUNIT_ASSERT(sorted(matches) == wanted);
+    }
+
+    void duplicate_keys_should_give_all_pairs() {
+    	RecordJoin<Order, Customer, Order::BigEndian<int32_t>>  join(order.group, customer.group);
+    	vector<JoinMatch>  matches = join.join(RecordView<const Order>(orders.data(), orders.size()),
+    	                                       RecordView<const Customer>(customers.data(), customers.size()));
+    	CPPUNIT_ASSERT(sorted(matches) == expected([](size_t o, size_t c){ return o % 13 == c % 10; }));
+    }
+
+    void parallel_join_should_give_the_same_pairs() {
+    	RecordJoin<Order, Customer, Order::Text<8>>  join(order.customer, customer.id);
+    	vector<JoinMatch>  sequential = sorted(join.join(orders.data(), NO, customers.data(), NC, ParallelOptions(1)));
+    	for (unsigned threads : {2U, 3U, 8U}) {
+    		vector<JoinMatch>  parallel = join.join(orders.data(), NO, customers.data(), NC, ParallelOptions(threads, 4096));
+    		CPPUNIT_ASSERT(sorted(parallel) == sequential);
+    	}
+
+    	RecordJoin<Customer, Order, Order::Text<8>>  reversed(customer.id, order.customer);
+    	vector<JoinMatch>  swapped = reversed.join(customers.data(), NC, orders.data(), NO, ParallelOptions(4, 4096));
+    	for (JoinMatch& m : swapped) swap(m.left, m.right);
+    	CPPUNIT_ASSERT(sorted(swapped) == sequential);
+    }
+
+    void empty_inputs_should_give_no_pairs() {
+    	RecordJoin<Order, Customer, Order::Text<8>>  join(order.customer, customer.id);
+    	CPPUNIT_ASSERT(join.join(orders.data(), 0, customers.data(), NC).empty());
+    	CPPUNIT_ASSERT(join.join(orders.data(), NO, customers.data(), 0).empty());
+    }
+
+};
+const size_t  RecordJoin_Test::NC;
+const size_t  RecordJoin_Test::NO;
+CPPUNIT_TEST_SUITE_REGISTRATION( RecordJoin_Test );
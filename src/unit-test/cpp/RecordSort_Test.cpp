@@ -0,0 +1,173 @@
+/*
+ * RecordSort_Test.cpp
+ *
+ *  Sorting records by field keys, in memory and external.
+ */
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <algorithm>
+#include <sstream>
+#include <vector>
+#include "RecordSort.hpp"
+using namespace overlay_record;
+using namespace std;
+
+struct RecordSort_Test : public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE( RecordSort_Test );
+		CPPUNIT_TEST( numeric_keys_should_order_by_value );
+		CPPUNIT_TEST( text_keys_should_order_by_bytes );
+		CPPUNIT_TEST( composite_keys_should_be_stable );
+		CPPUNIT_TEST( long_keys_should_sort_as_short_keys );
+		CPPUNIT_TEST( sorting_should_permute_the_records );
+		CPPUNIT_TEST( external_sort_should_merge_runs );
+		CPPUNIT_TEST( external_sort_should_report_io_failures );
+    CPPUNIT_TEST_SUITE_END();
+
+	struct R : public Record {
+		Text<3>					name   = {this};
+		TextInteger<6>			amount = {this};
+		BigEndian<int32_t>		key    = {this};
+		LittleEndian<double>	rate   = {this};
+		Packed<4>				packed = {this};
+		Integer					seq    = {this};
+		Text<20>				note   = {this};
+
+		R() = default;
+		R(char* buf, unsigned bufsiz) { assignStaticBuffer(buf, bufsiz); }
+	};
+
+	static const size_t  N = 3000;
+	vector<char>  buf;
+	R  proto;
+
+	static int  pseudoRandom(size_t k) { return (int)((k * 7919 + 13) % 2003) - 1000; }
+
+	void setUp() {
+		buf.assign(N * Record::layout<R>().size, '\0');
+		R  r(buf.data(), buf.size());
+		for (size_t k = 0; k < N; ++k, ++r) {
+			const int  v = pseudoRandom(k);
+			if (k % 5 != 0) r.name = string(1, 'a' + k % 3) + string(k % 2, 'x');    //else NUL
+			r.amount = v;
+			r.key    = v;
+			r.rate   = v / 8.0;
+			r.packed = v;
+			r.seq    = k;
+			r.note   = "note";
+		}
+	}
+
+	template<typename Less>
+	vector<size_t>  expected(Less less) {
+		vector<size_t>  result(N);
+		for (size_t k = 0; k < N; ++k) result[k] = k;
+		stable_sort(result.begin(), result.end(), less);
+		return result;
+	}
+
+    void numeric_keys_should_order_by_value() {
+    	vector<size_t>  ascending = expected([](size_t a, size_t b){ return pseudoRandom(a) < pseudoRandom(b); });
+    	vector<size_t>  descending = expected([](size_t a, size_t b){ return pseudoRandom(a) > pseudoRandom(b); });
+
+    	RecordSort<R>  byAmount;  byAmount.by(proto.amount);
+    	RecordSort<R>  byKey;     byKey.by(proto.key);
+    	RecordSort<R>  byRate;    byRate.by(proto.rate);
+    	RecordSort<R>  byPacked;  byPacked.by(proto.packed);
+    	RecordSort<R>  byKeyDesc; byKeyDesc.by(proto.key, SortOrder::DESCENDING);
+
+    	CPPUNIT_ASSERT(ascending == byAmount.order(buf.data(), N));
+    	CPPUNIT_ASSERT(ascending == byKey.order(buf.data(), N));
+    	CPPUNIT_ASSERT(ascending == byRate.order(buf.data(), N));
+    	CPPUNIT_ASSERT(ascending == byPacked.order(buf.data(), N));
+    	CPPUNIT_ASSERT(descending == byKeyDesc.order(buf.data(), N));
+    	CPPUNIT_ASSERT_EQUAL(4U, byKey.keySize());
+    }
+
+    void text_keys_should_order_by_bytes() {
+    	RecordSort<R>  sorter;
+    	sorter.by(proto.name);
+    	RecordView<const R>  view(buf.data(), buf.size());
+    	vector<size_t>  order = sorter.order(view);
+
+    	CPPUNIT_ASSERT(expected([&](size_t a, size_t b){ return view[a].name.value() < view[b].name.value(); }) == order);
+    	CPPUNIT_ASSERT_EQUAL(string("   "), view[order.front()].name.value());
+    	CPPUNIT_ASSERT_EQUAL(string("cx "), view[order.back()].name.value());
+    }
+
+    void composite_keys_should_be_stable() {
+    	RecordSort<R>  sorter;
+    	sorter.by(proto.name, SortOrder::DESCENDING).by(proto.key);
+    	RecordView<const R>  view(buf.data(), buf.size());
+
+    	CPPUNIT_ASSERT(expected([&](size_t a, size_t b){
+    		const string  na = view[a].name.value(), nb = view[b].name.value();
+    		return na != nb ? na > nb : pseudoRandom(a) < pseudoRandom(b);
+    	}) == sorter.order(view));
+    }
+
+    void long_keys_should_sort_as_short_keys() {
+    	RecordSort<R>  shortKey;
+    	shortKey.by(proto.name).by(proto.amount);
+    	RecordSort<R>  longKey;
+    	longKey.by(proto.note).by(proto.name).by(proto.amount);
+    	CPPUNIT_ASSERT(longKey.keySize() > RecordSort<R>::RADIX_KEY_WIDTH);
+    	CPPUNIT_ASSERT(shortKey.order(buf.data(), N) == longKey.order(buf.data(), N));
+    }
+
+    void sorting_should_permute_the_records() {
+    	RecordSort<R>  sorter;
+    	sorter.by(proto.amount);
+    	vector<size_t>  order = sorter.order(buf.data(), N);
+
+    	sorter.sort(RecordView<R>(buf.data(), buf.size()));
+    	R  r(buf.data(), buf.size());
+    	for (size_t k = 0; k < N; ++k, ++r) {
+    		CPPUNIT_ASSERT_EQUAL((int)order[k], r.seq.value());
+    		CPPUNIT_ASSERT_EQUAL(pseudoRandom(order[k]), r.amount.value());
+    	}
+    }
+
+    void external_sort_should_merge_runs() {
+    	RecordSort<R>  sorter;
+    	sorter.by(proto.key);
+    	vector<size_t>  order = sorter.order(buf.data(), N);
+
+    	const unsigned  stride = Record::layout<R>().size;
+    	istringstream  in(string(buf.data(), buf.size()) + "xy");     //trailing partial record
+    	ostringstream  out;
+    	CPPUNIT_ASSERT_EQUAL(N, sorter.sortStream(in, out, ExternalSortOptions(100 * stride, 3)));
+
+    	string  sorted = out.str();
+    	CPPUNIT_ASSERT_EQUAL(buf.size(), sorted.size());
+    	R  r(&sorted[0], sorted.size());
+    	for (size_t k = 0; k < N; ++k, ++r) CPPUNIT_ASSERT_EQUAL((int)order[k], r.seq.value());
+
+    	istringstream  small(string(buf.data(), 10 * stride));
+    	ostringstream  direct;
+    	CPPUNIT_ASSERT_EQUAL((size_t)10, sorter.sortStream(small, direct));
+    	CPPUNIT_ASSERT_EQUAL((size_t)10 * stride, direct.str().size());
+    }
+
+    void external_sort_should_report_io_failures() {
+    	RecordSort<R>  sorter;
+    	sorter.by(proto.key);
+    	const unsigned  stride = Record::layout<R>().size;
+    	const string    input(buf.data(), buf.size());
+
+    	istringstream  in(input);
+    	ostringstream  failed;
+    	failed.setstate(ios::badbit);
+    	CPPUNIT_ASSERT_THROW(sorter.sortStream(in, failed, ExternalSortOptions(100 * stride, 3)), std::ios_base::failure);
+
+    	istringstream  small(input.substr(0, 10 * stride));
+    	CPPUNIT_ASSERT_THROW(sorter.sortStream(small, failed), std::ios_base::failure);
+
+    	istringstream  again(input);
+    	ostringstream  out;
+    	CPPUNIT_ASSERT_THROW(sorter.sortStream(again, out, ExternalSortOptions(100 * stride, 3, "/nonexistent")), std::system_error);
+    }
+
+};
+const size_t  RecordSort_Test::N;
+CPPUNIT_TEST_SUITE_REGISTRATION( RecordSort_Test );
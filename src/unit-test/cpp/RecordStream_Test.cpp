@@ -0,0 +1,111 @@
+/*
+ * RecordStream_Test.cpp
+ *
+ *  Block-buffered record stream I/O.
+ */
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <sstream>
+#include "RecordStream.hpp"
+using namespace overlay_record;
+using namespace std;
+
+struct RecordStream_Test : public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE( RecordStream_Test );
+		CPPUNIT_TEST( reading_records_should_work_for_any_block_size );
+		CPPUNIT_TEST( reading_blocks_should_return_complete_records );
+		CPPUNIT_TEST( writing_records_should_work_for_any_block_size );
+		CPPUNIT_TEST( appended_records_should_be_zero_filled );
+		CPPUNIT_TEST( failed_streams_should_be_reported_by_flush );
+    CPPUNIT_TEST_SUITE_END();
+
+	struct R : public Record {
+		Text<3>				txt = {this};
+		TextInteger<2>		num = {this};
+	};
+
+	struct B : public Record {
+		Text<24>			txt = {this};
+		Long				num = {this};
+
+		B() = default;
+		B(char* buf, unsigned bufsiz) { assignStaticBuffer(buf, bufsiz); }
+	};
+
+    void reading_records_should_work_for_any_block_size() {
+    	for (size_t blockSize : {1, 5, 12, 1024}) {
+    		istringstream  is("abc01def02ghi03xy");
+    		RecordReader<R>  in(is, blockSize);
+
+    		int  k = 0;
+    		while (R* r = in.next()) CPPUNIT_ASSERT_EQUAL(++k, r->num.value());
+    		CPPUNIT_ASSERT_EQUAL(3, k);
+    		CPPUNIT_ASSERT_EQUAL(2UL, (unsigned long)in.remainder());
+    	}
+    }
+
+    void reading_blocks_should_return_complete_records() {
+		istringstream  is("abc01def02ghi03");
+		RecordReader<R>  in(is, 10);
+
+		RecordView<R>  view = in.nextBlock();
+		CPPUNIT_ASSERT_EQUAL(2UL, (unsigned long)view.size());
+		CPPUNIT_ASSERT_EQUAL(string("def"), view[1].txt.value());
+
+		view = in.nextBlock();
+		CPPUNIT_ASSERT_EQUAL(1UL, (unsigned long)view.size());
+		CPPUNIT_ASSERT_EQUAL(3, view[0].num.value());
+
+		CPPUNIT_ASSERT(in.nextBlock().empty());
+    }
+
+    void writing_records_should_work_for_any_block_size() {
+    	for (size_t blockSize : {1, 10, 1024}) {
+    		ostringstream  os;
+    		{
+    			RecordWriter<R>  out(os, blockSize);
+    			for (int k = 1; k <= 3; ++k) {
+    				R&  r = out.append();
+    				r.txt = string(3, 'a' + k - 1);
+    				r.num = k;
+    			}
+
+    			char  buf[] = "xyz99";
+    			R  r;
+    			r.assignStaticBuffer(buf, 5);
+    			out.write(r);
+    		}
+    		CPPUNIT_ASSERT_EQUAL(string("aaa1 bbb2 ccc3 xyz99"), os.str());
+    	}
+    }
+
+    void appended_records_should_be_zero_filled() {
+		ostringstream  os;
+		{
+			RecordWriter<R>  out(os, 10);
+			char  buf[] = "xyz99";
+			R  r;
+			r.assignStaticBuffer(buf, 5);
+			out.write(r).write(r);
+			out.append().txt = "a";
+			out.append();
+
+			char  other[64] = {};
+			B  b(other, sizeof(other));
+			CPPUNIT_ASSERT_THROW(out.write(b), StorageOverflow);
+		}
+		CPPUNIT_ASSERT(os.str() == string("xyz99xyz99a  \0\0\0\0\0\0\0", 20));
+    }
+
+    void failed_streams_should_be_reported_by_flush() {
+		ostringstream  os;
+		os.setstate(ios::badbit);
+		RecordWriter<R>  out(os, 10);
+		out.append().txt = "abc";
+		CPPUNIT_ASSERT_THROW(out.flush(), std::ios_base::failure);
+		out.append();       //the destructor must not throw
+    }
+
+};
+CPPUNIT_TEST_SUITE_REGISTRATION( RecordStream_Test );
@@ -0,0 +1,127 @@
+/*
+ * RecordView_Test.cpp
+ *
+ *  Sliding over a buffer of records.
+ */
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <algorithm>
+#include "RecordView.hpp"
+using namespace overlay_record;
+using namespace std;
+
+struct RecordView_Test : public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE( RecordView_Test );
+		CPPUNIT_TEST( sliding_record_should_rebind_embedded_records );
+		CPPUNIT_TEST( iterating_a_view_should_visit_all_records );
+		CPPUNIT_TEST( view_should_work_with_stl_algorithms );
+		CPPUNIT_TEST( iterator_should_be_random_access );
+		CPPUNIT_TEST( indexing_a_view_should_work );
+		CPPUNIT_TEST( subview_should_be_clamped );
+    CPPUNIT_TEST_SUITE_END();
+
+	struct E : public Record {
+		TextInteger<2>		num = {this};
+	};
+
+	struct R : public Record {
+		Text<3>				txt = {this};
+		Embed<E>			e   = {this};
+	};
+
+	char  buf[16] = "abc01def02ghi03";
+
+    void sliding_record_should_rebind_embedded_records() {
+    	struct S : public Record {
+    		Text<3>		txt = {this};
+    		Embed<E>	e   = {this};
+
+    		S(char* buf, unsigned bufsiz) { assignStaticBuffer(buf, bufsiz); }
+    	};
+
+    	S  s(buf, sizeof(buf));
+		CPPUNIT_ASSERT_EQUAL(1, s.e->num.value());
+		++s;
+		CPPUNIT_ASSERT_EQUAL(string("def"), s.txt.value());
+		CPPUNIT_ASSERT_EQUAL(2, s.e->num.value());
+    }
+
+    void iterating_a_view_should_visit_all_records() {
+    	RecordView<R>  view(buf, sizeof(buf));
+		CPPUNIT_ASSERT_EQUAL(3UL, (unsigned long)view.size());
+		CPPUNIT_ASSERT_EQUAL(5U, view.recordSize());
+
+		int  k = 0;
+		for (const R& r : view) {
+			++k;
+			CPPUNIT_ASSERT_EQUAL(k, r.e->num.value());
+		}
+		CPPUNIT_ASSERT_EQUAL(3, k);
+		CPPUNIT_ASSERT_EQUAL(3L, (long)(view.end() - view.begin()));
+    }
+
+    void view_should_work_with_stl_algorithms() {
+    	RecordView<R>  view(buf, sizeof(buf));
+
+    	auto  it = find_if(view.begin(), view.end(), [](const R& r){ return r.txt.value() == "def"; });
+		CPPUNIT_ASSERT(it != view.end());
+		CPPUNIT_ASSERT_EQUAL(1L, (long)(it - view.begin()));
+		CPPUNIT_ASSERT_EQUAL(2, it->e->num.value());
+
+		long  n = count_if(view.begin(), view.end(), [](const R& r){ return r.e->num.value() >= 2; });
+		CPPUNIT_ASSERT_EQUAL(2L, n);
+
+		auto  last = view.begin() + 2;
+		CPPUNIT_ASSERT_EQUAL(string("ghi"), last->txt.value());
+		CPPUNIT_ASSERT_EQUAL(string("abc"), (last - 2)->txt.value());
+    }
+
+    void iterator_should_be_random_access() {
+    	typedef RecordView<R>::iterator  Iterator;
+    	CPPUNIT_ASSERT((is_same<iterator_traits<Iterator>::iterator_category, random_access_iterator_tag>::value));
+
+    	RecordView<R>  view(buf, sizeof(buf));
+    	Iterator  it = view.begin();
+    	R  first  = *it;
+    	R  second = it[1];
+		CPPUNIT_ASSERT_EQUAL(string("abc"), first.txt.value());
+		CPPUNIT_ASSERT_EQUAL(string("def"), second.txt.value());
+
+		it += 2;
+		CPPUNIT_ASSERT_EQUAL(string("ghi"), it->txt.value());
+		CPPUNIT_ASSERT_EQUAL(string("def"), (--it)->txt.value());
+		CPPUNIT_ASSERT_EQUAL(string("abc"), first.txt.value());
+
+		auto  found = lower_bound(view.begin(), view.end(), string("ddd"),
+		                          [](const R& r, const string& txt){ return r.txt.value() < txt; });
+		CPPUNIT_ASSERT(found == it);
+    }
+
+    void indexing_a_view_should_work() {
+    	RecordView<R>  view(buf, sizeof(buf));
+
+		CPPUNIT_ASSERT_EQUAL(string("def"), view[1].txt.value());
+		CPPUNIT_ASSERT_EQUAL(3, view.at(2).e->num.value());
+		CPPUNIT_ASSERT_THROW(view.at(3), IndexOutOfBounds);
+
+		view[0].e->num = 42;
+		CPPUNIT_ASSERT_EQUAL(string("abc42"), string(buf, buf + 5));
+
+		view[2].txt = view[1].txt;
+		CPPUNIT_ASSERT_EQUAL(string("def"), view[2].txt.value());
+		CPPUNIT_ASSERT_EQUAL(string("def"), view[1].txt.value());
+    }
+
+    void subview_should_be_clamped() {
+    	RecordView<R>  view(buf, sizeof(buf));
+    	RecordView<R>  sub = view.subview(1, 10);
+
+		CPPUNIT_ASSERT_EQUAL(2UL, (unsigned long)sub.size());
+		CPPUNIT_ASSERT_EQUAL(string("def"), sub.front().txt.value());
+		CPPUNIT_ASSERT_EQUAL(string("ghi"), sub.back().txt.value());
+		CPPUNIT_ASSERT_THROW(view.subview(4, 1), IndexOutOfBounds);
+    }
+
+};
+CPPUNIT_TEST_SUITE_REGISTRATION( RecordView_Test );
@@ -0,0 +1,113 @@
+/*
+ * StaticRecord_Test.cpp
+ *
+ *  Compile-time layout records.
+ */
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "StaticRecord.hpp"
+using namespace overlay_record;
+using namespace std;
+
+struct StaticRecord_Test : public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE( StaticRecord_Test );
+		CPPUNIT_TEST( layout_should_be_computed_at_compile_time );
+		CPPUNIT_TEST( read_write_of_fields_should_work );
+		CPPUNIT_TEST( overlaid_fields_should_share_storage );
+		CPPUNIT_TEST( arrays_and_embedded_records_should_work );
+		CPPUNIT_TEST( sliding_over_a_buffer_should_work );
+    CPPUNIT_TEST_SUITE_END();
+
+    typedef StaticRecord<Record::Text<4>, Record::TextInteger<4>>	X;
+
+    typedef StaticRecord<
+    			Record::Text<4>,					// 0
+    			Record::TextInteger<5>,				// 1
+    			Record::Integer,					// 2
+    			Record::Array<Record::Text<3>, 4>,	// 3
+    			Record::Embed<X>,					// 4
+    			At<0, Record::Blob<4>>				// 5
+    		>	R;
+
+    void layout_should_be_computed_at_compile_time() {
+    	static_assert(sizeof(R) == sizeof(char*), "A static record should be just one pointer");
+    	static_assert(R::size() == 4 + 5 + sizeof(int) + 12 + 8, "Unexpected size");
+    	static_assert(R::offset<3>() == 9 + sizeof(int), "Unexpected offset");
+    	static_assert(R::offset<5>() == 0, "Overlay should align with entry 0");
+
+		CPPUNIT_ASSERT_EQUAL(6U, R::count());
+		CPPUNIT_ASSERT_EQUAL(8U, X::size());
+    }
+
+    void read_write_of_fields_should_work() {
+    	char  buf[R::size()];
+    	memset(buf, ' ', sizeof(buf));
+    	R  r(buf, sizeof(buf));
+
+    	r.get<0>() = "abcd";
+    	r.get<1>() = 42;
+    	r.get<2>() = 1234567890;
+
+		CPPUNIT_ASSERT_EQUAL(string("abcd"), r.get<0>().value());
+		CPPUNIT_ASSERT_EQUAL(42, r.get<1>().value());
+		CPPUNIT_ASSERT_EQUAL(1234567890, r.get<2>().value());
+		CPPUNIT_ASSERT_EQUAL(string("abcd42   "), string(buf, buf + 9));
+
+		CPPUNIT_ASSERT_THROW(R(buf, 10), StorageOverflow);
+    }
+
+    void overlaid_fields_should_share_storage() {
+    	typedef StaticRecord<
+    				Record::Text<12>,
+    				At<0, Record::Text<6>>,
+    				Record::Text<6>,
+    				After<1, Record::Text<2>>
+    			>	V;
+    	static_assert(V::size() == 12, "Overlays should not grow the record");
+
+    	char  buf[V::size()];
+    	V  v(buf);
+    	v.get<0>() = "aabbccddeeff";
+
+		CPPUNIT_ASSERT_EQUAL(string("aabbcc"), v.get<1>().value());
+		CPPUNIT_ASSERT_EQUAL(string("ddeeff"), v.get<2>().value());
+		CPPUNIT_ASSERT_EQUAL(string("dd"), v.get<3>().value());
+    }
+
+    void arrays_and_embedded_records_should_work() {
+    	char  buf[R::size()];
+    	memset(buf, ' ', sizeof(buf));
+    	R  r(buf);
+
+    	r.get<3>() = {"abc", "def", "ghi", "jkl"};
+		CPPUNIT_ASSERT_EQUAL(string("def"), r.get<3>()[1].value());
+		CPPUNIT_ASSERT_THROW(r.get<3>()[4], IndexOutOfBounds);
+
+		{	int k = 0;
+			for (auto item : r.get<3>()) {
+				CPPUNIT_ASSERT_EQUAL(string(1, 'a' + 3*k), item.value().substr(0, 1));
+				++k;
+			}
+			CPPUNIT_ASSERT_EQUAL(4, k);
+		}
+
+		r.get<4>()->get<0>() = "wxyz";
+		r.get<4>()->get<1>() = 17;
+		CPPUNIT_ASSERT_EQUAL(string("wxyz17  "), string(buf + R::offset<4>(), X::size()));
+		CPPUNIT_ASSERT_EQUAL(17, r.get<4>()->get<1>().value());
+    }
+
+    void sliding_over_a_buffer_should_work() {
+    	char  buf[] = "abcd0001efgh0002ijkl0003";
+    	X  x(buf);
+
+    	for (int k = 1; k <= 3; ++k, ++x)
+    		CPPUNIT_ASSERT_EQUAL(k, x.get<1>().value());
+
+    	--x;
+		CPPUNIT_ASSERT_EQUAL(string("ijkl"), x.get<0>().value());
+    }
+
+};
+CPPUNIT_TEST_SUITE_REGISTRATION( StaticRecord_Test );
@@ -0,0 +1,142 @@
+/*
+ * StructMapping_Test.cpp
+ *
+ *  Decoding whole records into plain structs, and back.
+ */
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include <vector>
+#include "StructMapping.hpp"
+using namespace overlay_record;
+using namespace std;
+
+namespace {
+
+struct R : public Record {
+	Text<4>					id     = {this};
+	TextInteger<6>			amount = {this};
+	Packed<4, double, 2>	price  = {this};
+	BigEndian<int32_t>		count  = {this};
+	Blob<2>					key    = {this};
+	Text<3>					code   = {this};
+
+	R() = default;
+	R(char* buf, unsigned bufsiz) { assignStaticBuffer(buf, bufsiz); }
+};
+
+struct Row {
+	string		id;
+	long		amount;
+	double		price;
+	int			count;
+	string		key;
+	TextView	code;
+};
+
+auto  mapping = []() {
+	return mapStruct<R, Row>(bindMember(&R::id,     &Row::id),
+	                         bindMember(&R::amount, &Row::amount),
+	                         bindMember(&R::price,  &Row::price),
+	                         bindMember(&R::count,  &Row::count),
+	                         bindMember(&R::key,    &Row::key),
+	                         bindMember(&R::code,   &Row::code));
+};
+
+}
+
+struct StructMapping_Test : public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE( StructMapping_Test );
+		CPPUNIT_TEST( decode_should_convert_every_bound_field );
+		CPPUNIT_TEST( encode_should_round_trip );
+		CPPUNIT_TEST( batches_should_map_consecutive_records );
+		CPPUNIT_TEST( unbound_records_should_be_rejected );
+		CPPUNIT_TEST( numeric_text_should_decode_as_the_field_does );
+    CPPUNIT_TEST_SUITE_END();
+
+    void decode_should_convert_every_bound_field() {
+    	R  r;
+    	r.allocateDynamicBuffer();
+    	r.id = "ab"; r.amount = -4711; r.price = 123.45; r.count = 42; r.key = "CAFE"; r.code = "xyz";
+
+    	Row  row = mapping().decode(r);
+    	CPPUNIT_ASSERT_EQUAL(string("ab  "), row.id);
+    	CPPUNIT_ASSERT_EQUAL(-4711L, row.amount);
+    	CPPUNIT_ASSERT_DOUBLES_EQUAL(123.45, row.price, 1e-9);
+    	CPPUNIT_ASSERT_EQUAL(42, row.count);
+    	CPPUNIT_ASSERT_EQUAL(string("CAFE"), row.key);
+    	CPPUNIT_ASSERT_EQUAL(string("xyz"), row.code.str());
+    	CPPUNIT_ASSERT(row.code.data() == r.code.begin());
+    }
+
+    void encode_should_round_trip() {
+    	Row  row;
+    	row.id = "wxyz"; row.amount = 12345; row.price = -9.99; row.count = -7; row.key = "0102"; row.code = TextView("q", 1);
+
+    	R  r;
+    	r.allocateDynamicBuffer();
+    	auto  m = mapping();
+    	m.encode(row, r);
+    	CPPUNIT_ASSERT_EQUAL(string("wxyz"), r.id.value());
+    	CPPUNIT_ASSERT_EQUAL(12345, r.amount.value());
+    	CPPUNIT_ASSERT_DOUBLES_EQUAL(-9.99, r.price.value(), 1e-9);
+    	CPPUNIT_ASSERT_EQUAL(-7, r.count.value());
+    	CPPUNIT_ASSERT_EQUAL(string("0102"), r.key.value());
+    	CPPUNIT_ASSERT_EQUAL(string("q  "), r.code.value());
+
+    	Row  back;
+    	m.decode(r, back);
+    	CPPUNIT_ASSERT_EQUAL(row.id, back.id);
+    	CPPUNIT_ASSERT_EQUAL(row.amount, back.amount);
+    	CPPUNIT_ASSERT_EQUAL(row.key, back.key);
+    }
+
+    void batches_should_map_consecutive_records() {
+    	const size_t  N = 3;
+    	vector<char>  buf(N * Record::layout<R>().size);
+    	R  r(buf.data(), buf.size());
+    	for (size_t k = 0; k < N; ++k, ++r) { r.id = "r"; r.amount = k * 10; r.price = k + 0.5; r.count = k; }
+
+    	auto  m = mapping();
+    	Row  rows[N];
+    	m.decode(buf.data(), N, rows);
+    	for (size_t k = 0; k < N; ++k) {
+    		CPPUNIT_ASSERT_EQUAL((long)k * 10, rows[k].amount);
+    		CPPUNIT_ASSERT_DOUBLES_EQUAL(k + 0.5, rows[k].price, 1e-9);
+    		CPPUNIT_ASSERT_EQUAL((int)k, rows[k].count);
+    	}
+
+    	rows[1].amount = 999;
+    	vector<char>  copy(buf.size());
+    	m.encode(rows, N, copy.data());
+    	R  c(copy.data(), copy.size());
+    	++c;
+    	CPPUNIT_ASSERT_EQUAL(999, c.amount.value());
+    	CPPUNIT_ASSERT_EQUAL(1, c.count.value());
+    }
+
+    void unbound_records_should_be_rejected() {
+    	R  r;
+    	Row  row;
+    	CPPUNIT_ASSERT_THROW(mapping().decode(r, row), UnInitialized);
+    	CPPUNIT_ASSERT_THROW(mapping().encode(row, r), UnInitialized);
+    }
+
+    void numeric_text_should_decode_as_the_field_does() {
+    	R  r;
+    	r.allocateDynamicBuffer();
+    	auto  m = mapping();
+    	Row   row;
+    	for (const char* text : {"42    ", "  -7  ", "000123", "+5    ", "      "}) {
+    		memcpy(r.begin() + r.amount.startOffset(), text, 6);
+    		m.decode(r, row);
+    		CPPUNIT_ASSERT_EQUAL((long)r.amount.value(), row.amount);
+    	}
+
+    	row.amount = -123;
+    	m.encode(row, r);
+    	CPPUNIT_ASSERT_EQUAL(string("-123  "), string(r.amount.begin(), r.amount.end()));
+    }
+
+};
+CPPUNIT_TEST_SUITE_REGISTRATION( StructMapping_Test );
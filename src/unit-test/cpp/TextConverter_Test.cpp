@@ -0,0 +1,103 @@
+/*
+ * TextConverter_Test.cpp
+ *
+ *  Allocation-free access of text fields.
+ */
+
+
+#include <cppunit/extensions/HelperMacros.h>
+#include "Record.hpp"
+using namespace std;
+using namespace overlay_record;
+
+struct TextConverter_Test : public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE( TextConverter_Test );
+	CPPUNIT_TEST( fromStorage_should_replace_nul_by_pad );
+	CPPUNIT_TEST( toStorage_should_pad_and_truncate );
+	CPPUNIT_TEST( view_should_refer_to_the_storage );
+	CPPUNIT_TEST( text_view_should_compare_and_trim );
+	CPPUNIT_TEST( numeric_fields_should_take_plain_literals );
+    CPPUNIT_TEST_SUITE_END();
+
+	typedef Record::TextConverter<'.'>	Converter;
+
+    void fromStorage_should_replace_nul_by_pad() {
+    	const char	payload[] = {'a', '\0', 'b', '\0'};
+		CPPUNIT_ASSERT_EQUAL(string("a.b."), Converter::fromStorage(payload, sizeof(payload)));
+    }
+
+    void toStorage_should_pad_and_truncate() {
+    	char  buf[6];
+
+    	Converter::toStorage("abc", buf, sizeof(buf));
+		CPPUNIT_ASSERT_EQUAL(string("abc..."), string(buf, sizeof(buf)));
+
+		Converter::toStorage(string("abcdefgh"), buf, sizeof(buf));
+		CPPUNIT_ASSERT_EQUAL(string("abcdef"), string(buf, sizeof(buf)));
+
+		Converter::toStorage("xyzw", 2, buf, sizeof(buf));
+		CPPUNIT_ASSERT_EQUAL(string("xy...."), string(buf, sizeof(buf)));
+    }
+
+    void view_should_refer_to_the_storage() {
+    	struct R : public Record {
+    		Text<6>		txt = {this};
+    		Text<4>		tag = {this};
+
+    		R() { allocateDynamicBuffer(); }
+    	};
+
+    	R  r;
+    	r.txt = "abc";
+    	r.tag.value(TextView("wxyz", 2));
+
+    	TextView  v = r.txt.view();
+		CPPUNIT_ASSERT(v.data() == r.txt.begin());
+		CPPUNIT_ASSERT_EQUAL(6UL, (unsigned long)v.size());
+		CPPUNIT_ASSERT(v == "abc   ");
+		CPPUNIT_ASSERT(v.trimmed() == "abc");
+		CPPUNIT_ASSERT_EQUAL(string("wx  "), r.tag.view().str());
+
+		r.txt = "def";
+		CPPUNIT_ASSERT(v.trimmed() == "def");
+    }
+
+    void text_view_should_compare_and_trim() {
+    	const char	payload[] = {'a', 'b', ' ', '\0'};
+    	TextView	v(payload, sizeof(payload));
+
+		CPPUNIT_ASSERT_EQUAL(2UL, (unsigned long)v.trimmed().size());
+		CPPUNIT_ASSERT(v.startsWith("ab"));
+		CPPUNIT_ASSERT(!v.startsWith("abc"));
+		CPPUNIT_ASSERT(TextView("ab") < TextView("abc"));
+		CPPUNIT_ASSERT(TextView("abd") != TextView("abc"));
+		CPPUNIT_ASSERT_EQUAL(0, TextView("abc").compare(string("abc")));
+		CPPUNIT_ASSERT(TextView().trimmed().empty());
+    }
+
+    void numeric_fields_should_take_plain_literals() {
+    	struct R : public Record {
+    		Double			dbl = {this};
+    		Long			lng = {this};
+    		TextInteger<4>	num = {this};
+    		Blob<2>			blob = {this};
+
+    		R() { allocateDynamicBuffer(); }
+    	};
+
+    	R  r;
+    	r.dbl = 0;
+    	r.lng = 0;
+    	r.num = 0;
+    	r.blob = "0A1B";
+		CPPUNIT_ASSERT_EQUAL(0.0, r.dbl.value());
+		CPPUNIT_ASSERT_EQUAL(0L, r.lng.value());
+		CPPUNIT_ASSERT_EQUAL(string("0A1B"), r.blob.value());
+
+		CPPUNIT_ASSERT(!(is_assignable<R::Double&, const char*>::value));
+		CPPUNIT_ASSERT(!(is_assignable<R::TextInteger<4>&, const char*>::value));
+		CPPUNIT_ASSERT((is_assignable<R::Text<4>&, const char*>::value));
+    }
+
+};
+CPPUNIT_TEST_SUITE_REGISTRATION( TextConverter_Test );